@@ -0,0 +1,420 @@
+#include "CaptureFormat.h"
+#include <QDateTime>
+#include <QtEndian>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include "JsonlWriter.h"
+#include "LineSplitter.h"
+#include "TerminalEntry.h"
+
+namespace CaptureFormat {
+
+quint32 crc32(const char *data, qsizetype size, quint32 crc)
+{
+    // IEEE 802.3(與 zlib / gzip 相同),查表於第一次使用時建立
+    static const auto table = [] {
+        std::array<quint32, 256> t {};
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    crc = ~crc;
+    for (qsizetype i = 0; i < size; ++i)
+        crc = table[(crc ^ quint8(data[i])) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void putVarint(QByteArray &out, quint64 v)
+{
+    while (v >= 0x80) {
+        out.append(char(v | 0x80));
+        v >>= 7;
+    }
+    out.append(char(v));
+}
+
+static bool getVarint(const QByteArray &in, qsizetype &pos, quint64 &v)
+{
+    v = 0;
+    for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+        const quint8 b = quint8(in.at(pos++));
+        v |= quint64(b & 0x7F) << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    return false;
+}
+
+QByteArray fileHeader()
+{
+    QByteArray h(FileHeaderSize, '\0');
+    memcpy(h.data(), FileMagic, sizeof(FileMagic));
+    qToLittleEndian<quint16>(Version, h.data() + 8);
+    return h;
+}
+
+void BlockEncoder::add(Direction dir, qint64 tsNs, const QByteArray &bytes, qint64 frameIndex)
+{
+    if (m_count == 0) {
+        m_baseTs = tsNs;
+        m_lastTs = tsNs;
+        m_payload.reserve(MaxBlockPayload + 64);
+    }
+    quint8 flags = dir & FlagDirMask;
+    if (frameIndex >= 0)
+        flags |= FlagFrameIndex;
+    m_payload.append(char(flags));
+    putVarint(m_payload, quint64(qMax<qint64>(0, tsNs - m_lastTs)));
+    putVarint(m_payload, quint64(bytes.size()));
+    if (frameIndex >= 0)
+        putVarint(m_payload, quint64(frameIndex));
+    m_payload.append(bytes);
+    m_lastTs = qMax(m_lastTs, tsNs);
+    ++m_count;
+}
+
+QByteArray BlockEncoder::seal()
+{
+    QByteArray out(BlockHeaderSize, '\0');
+    char *h = out.data();
+    qToLittleEndian<quint32>(BlockMagic, h);
+    qToLittleEndian<quint32>(quint32(m_payload.size()), h + 4);
+    qToLittleEndian<quint32>(m_count, h + 8);
+    qToLittleEndian<quint32>(crc32(m_payload.constData(), m_payload.size()), h + 12);
+    qToLittleEndian<qint64>(m_baseTs, h + 16);
+    out.append(m_payload);
+
+    m_payload.clear();
+    m_count = 0;
+    return out;
+}
+
+Reader::Reader(QFile *file)
+    : m_file(file)
+{
+    const QByteArray head = m_file->read(FileHeaderSize);
+    m_valid = head.size() == FileHeaderSize
+           && memcmp(head.constData(), FileMagic, sizeof(FileMagic)) == 0;
+}
+
+bool Reader::loadBlock()
+{
+    static const QByteArray magic("UPBK", 4);   // BlockMagic 的 little-endian bytes
+
+    for (;;) {
+        const qint64 at = m_file->pos();
+        const QByteArray header = m_file->read(BlockHeaderSize);
+        if (header.size() < BlockHeaderSize)
+            return false;
+
+        // 多個 capture 串接時中間會夾著 file header
+        if (memcmp(header.constData(), FileMagic, sizeof(FileMagic)) == 0) {
+            m_file->seek(at + FileHeaderSize);
+            continue;
+        }
+
+        if (qFromLittleEndian<quint32>(header.constData()) != BlockMagic) {
+            // 重新同步: 往後找下一個 block magic
+            ++m_skipped;
+            qint64 from = at + 1;
+            for (;;) {
+                m_file->seek(from);
+                const QByteArray window = m_file->read(MaxBlockPayload);
+                if (window.size() < magic.size())
+                    return false;
+                const qsizetype hit = window.indexOf(magic);
+                if (hit >= 0) {
+                    m_file->seek(from + hit);
+                    break;
+                }
+                from += window.size() - (magic.size() - 1);
+            }
+            continue;
+        }
+
+        const quint32 payloadBytes = qFromLittleEndian<quint32>(header.constData() + 4);
+        const quint32 count = qFromLittleEndian<quint32>(header.constData() + 8);
+        const quint32 crc = qFromLittleEndian<quint32>(header.constData() + 12);
+        m_block = m_file->read(payloadBytes);
+        if (m_block.size() < qsizetype(payloadBytes)) {
+            ++m_skipped;   // 尾端截斷(寫到一半的 block)
+            return false;
+        }
+        if (crc32(m_block.constData(), m_block.size()) != crc) {
+            ++m_skipped;
+            m_file->seek(at + 1);   // 長度欄位也可能壞了: 從下一個 byte 重新同步
+            continue;
+        }
+
+        m_pos = 0;
+        m_remaining = count;
+        m_lastTs = qFromLittleEndian<qint64>(header.constData() + 16);
+        return true;
+    }
+}
+
+bool Reader::next(Record &out)
+{
+    if (!m_valid)
+        return false;
+
+    for (;;) {
+        if (m_remaining == 0 && !loadBlock())
+            return false;
+        if (m_remaining == 0 || m_pos >= m_block.size()) {
+            m_remaining = 0;
+            continue;
+        }
+
+        const quint8 flags = quint8(m_block.at(m_pos++));
+        quint64 delta = 0, length = 0, frame = 0;
+        bool ok = getVarint(m_block, m_pos, delta) && getVarint(m_block, m_pos, length);
+        if (ok && (flags & FlagFrameIndex))
+            ok = getVarint(m_block, m_pos, frame);
+        if (!ok || length > quint64(m_block.size() - m_pos)) {
+            ++m_skipped;   // CRC 通過但內容不合: 丟掉 block 剩餘部分
+            m_remaining = 0;
+            continue;
+        }
+
+        m_lastTs += qint64(delta);
+        out.dir = Direction(flags & FlagDirMask);
+        out.tsNs = m_lastTs;
+        out.frameIndex = (flags & FlagFrameIndex) ? qint64(frame) : -1;
+        out.bytes = m_block.mid(m_pos, qsizetype(length));
+        m_pos += qsizetype(length);
+        --m_remaining;
+        return true;
+    }
+}
+
+MemoryReader::MemoryReader(const char *data, qint64 size)
+    : m_data(data)
+    , m_size(size)
+{
+    m_valid = size >= FileHeaderSize && memcmp(data, FileMagic, sizeof(FileMagic)) == 0;
+    m_pos = FileHeaderSize;
+}
+
+void MemoryReader::seek(qint64 blockOffset, quint32 record)
+{
+    m_pos = blockOffset;
+    m_remaining = 0;
+    if (!loadBlock())
+        return;
+    Record skip;
+    while (record-- > 0 && m_remaining > 0)
+        next(skip);
+}
+
+bool MemoryReader::loadBlock()
+{
+    static const QByteArray magic("UPBK", 4);
+
+    while (m_pos + BlockHeaderSize <= m_size) {
+        const char *header = m_data + m_pos;
+        if (memcmp(header, FileMagic, sizeof(FileMagic)) == 0) {
+            m_pos += FileHeaderSize;
+            continue;
+        }
+        if (qFromLittleEndian<quint32>(header) != BlockMagic) {
+            ++m_skipped;
+            const qsizetype hit = QByteArrayView(m_data + m_pos + 1, m_size - m_pos - 1).indexOf(magic);
+            if (hit < 0)
+                break;
+            m_pos += 1 + hit;
+            continue;
+        }
+
+        const quint32 payloadBytes = qFromLittleEndian<quint32>(header + 4);
+        if (m_pos + BlockHeaderSize + qint64(payloadBytes) > m_size) {
+            ++m_skipped;   // 尾端截斷
+            break;
+        }
+        const char *payload = header + BlockHeaderSize;
+        if (crc32(payload, payloadBytes) != qFromLittleEndian<quint32>(header + 12)) {
+            ++m_skipped;
+            m_pos += 1;
+            continue;
+        }
+
+        m_blockOffset = m_pos;
+        m_pos += BlockHeaderSize + payloadBytes;
+        m_block = QByteArray::fromRawData(payload, payloadBytes);
+        m_recPos = 0;
+        m_remaining = qFromLittleEndian<quint32>(header + 8);
+        m_recordIndex = 0;
+        m_lastTs = qFromLittleEndian<qint64>(header + 16);
+        return true;
+    }
+    m_pos = m_size;
+    return false;
+}
+
+bool MemoryReader::next(Record &out)
+{
+    if (!m_valid)
+        return false;
+
+    for (;;) {
+        if (m_remaining == 0 && !loadBlock())
+            return false;
+        if (m_recPos >= m_block.size()) {
+            m_remaining = 0;
+            continue;
+        }
+
+        const quint8 flags = quint8(m_block.at(m_recPos++));
+        quint64 delta = 0, length = 0, frame = 0;
+        bool ok = getVarint(m_block, m_recPos, delta) && getVarint(m_block, m_recPos, length);
+        if (ok && (flags & FlagFrameIndex))
+            ok = getVarint(m_block, m_recPos, frame);
+        if (!ok || length > quint64(m_block.size() - m_recPos)) {
+            ++m_skipped;
+            m_remaining = 0;
+            continue;
+        }
+
+        m_lastTs += qint64(delta);
+        out.dir = Direction(flags & FlagDirMask);
+        out.tsNs = m_lastTs;
+        out.frameIndex = (flags & FlagFrameIndex) ? qint64(frame) : -1;
+        out.bytes = QByteArray::fromRawData(m_block.constData() + m_recPos, qsizetype(length));
+        m_recPos += qsizetype(length);
+        --m_remaining;
+        ++m_recordIndex;
+        return true;
+    }
+}
+
+int convert(const QString &inPath, const QString &outPath, const QString &format)
+{
+    QFile in(inPath);
+    if (!in.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "cannot open capture: %s\n", qUtf8Printable(inPath));
+        return 3;
+    }
+    Reader reader(&in);
+    if (!reader.isValid()) {
+        fprintf(stderr, "not a capture file: %s\n", qUtf8Printable(inPath));
+        return 7;
+    }
+
+    QFile out;
+    const bool ok = outPath.isEmpty() ? out.open(stdout, QIODevice::WriteOnly)
+                                      : (out.setFileName(outPath), out.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    if (!ok) {
+        fprintf(stderr, "cannot open output: %s\n", qUtf8Printable(outPath));
+        return 3;
+    }
+
+    const bool jsonl = format == QLatin1String("jsonl");
+    QByteArray buffer;
+    JsonlWriter json;
+    IsoTimestamp iso;
+    qint64 seq = 0;
+
+    auto flushOut = [&](bool force) {
+        if (force || buffer.size() >= (1 << 20)) {
+            out.write(buffer);
+            buffer.clear();
+        }
+    };
+
+    auto emitLine = [&](const QString &type, qint64 tsNs, const QByteArray &line) {
+        const QString ascii = LineSplitter::asciiText(line);
+        if (jsonl) {
+            json.clear();
+            json.begin();
+            json.timestampField("ts", tsNs / 1000000);
+            json.field("seq", seq++);
+            json.field("type", type);
+            json.field("ascii", ascii);
+            json.field("hex", LineSplitter::hexText(line));
+            json.end();
+            buffer += json.data();
+        } else {
+            char ts[IsoTimestamp::Length];
+            iso.format(tsNs / 1000000, ts);
+            buffer += '[';
+            buffer.append(ts, IsoTimestamp::Length);
+            buffer += "] ";
+            buffer += terminalPrefix(type).latin1();
+            buffer += ascii.toUtf8();
+            buffer += '\n';
+        }
+        flushOut(false);
+    };
+
+    auto emitSession = [&](qint64 tsNs, const QByteArray &event) {
+        const QDateTime when = QDateTime::fromMSecsSinceEpoch(tsNs / 1000000);
+        if (jsonl) {
+            json.clear();
+            json.begin();
+            json.timestampField("ts", tsNs / 1000000);
+            json.field("type", QLatin1String("session"));
+            json.field("event", QString::fromUtf8(event));   // marker 內容來自檔案,照一般字串 escape
+            json.end();
+            buffer += json.data();
+        } else if (event == "start") {
+            buffer += "=== UART PRO Log Session — ";
+            buffer += when.toString(QStringLiteral("yyyy-MM-dd HH:mm:ss")).toUtf8();
+            buffer += " ===\n";
+        } else {
+            buffer += "=== Session ended — ";
+            buffer += when.toString(QStringLiteral("yyyy-MM-dd HH:mm:ss")).toUtf8();
+            buffer += " ===\n\n";
+        }
+    };
+
+    const QString rx = QStringLiteral("rx");
+    LineSplitter splitter;
+    qint64 lastRxTs = -1;
+    qint64 lineTs = 0;
+    auto onRxLine = [&](const QByteArray &line) { emitLine(rx, lineTs, line); };
+
+    Record r;
+    while (reader.next(r)) {
+        // 與前一個 RX chunk 相隔超過 idle 時間: 當時殘留資料已被 flush 成一行
+        if (splitter.hasPending() && (r.dir != Rx || r.tsNs - lastRxTs >= IdleFlushNs)) {
+            lineTs = r.dir == Rx ? lastRxTs + IdleFlushNs : r.tsNs;
+            splitter.flush(onRxLine);
+        }
+
+        switch (r.dir) {
+        case Rx:
+            lineTs = r.tsNs;
+            lastRxTs = r.tsNs;
+            splitter.feed(r.bytes, onRxLine);
+            break;
+        case Tx: {
+            // 送出的一筆 = 一行(去掉行尾的換行)
+            QByteArray line = r.bytes;
+            while (line.endsWith('\n') || line.endsWith('\r'))
+                line.chop(1);
+            emitLine(QStringLiteral("tx"), r.tsNs, line);
+            break;
+        }
+        case Marker:
+            emitSession(r.tsNs, r.bytes);
+            break;
+        }
+    }
+    if (splitter.hasPending()) {
+        lineTs = lastRxTs;
+        splitter.flush(onRxLine);
+    }
+    flushOut(true);
+
+    if (reader.skippedBlocks() > 0)
+        fprintf(stderr, "skipped %lld damaged block(s)\n", reader.skippedBlocks());
+    return 0;
+}
+
+} // namespace CaptureFormat
@@ -0,0 +1,122 @@
+#ifndef CAPTUREFORMAT_H
+#define CAPTUREFORMAT_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+// --format cap: 原始 chunk 的二進位 capture(little-endian)
+//
+//   file header (16 B): magic "UPCAP\r\n\x1a" | u16 version | u16 flags | u32 reserved
+//   block header (24 B): u32 'UPBK' | u32 payloadBytes | u32 recordCount | u32 crc32(payload)
+//                        | i64 baseTsNs(epoch ns)
+//   record: u8 flags(bit0-1 方向, bit2 有 framing index) | varint tsDelta(ns,相對前一筆)
+//           | varint length | [varint frameIndex] | bytes
+//
+// block 自帶長度與絕對時間: 可逐 block 跳躍 / 依時間二分搜尋,壞掉的 block 以 magic 重新同步。
+// append 到既有 capture 時不重寫 file header,直接接新的 block
+namespace CaptureFormat {
+
+enum Direction : quint8 { Rx = 0, Tx = 1, Marker = 2 };   // Marker: session start / stop
+
+constexpr char FileMagic[8] = { 'U', 'P', 'C', 'A', 'P', '\r', '\n', '\x1a' };
+constexpr int FileHeaderSize = 16;
+constexpr quint16 Version = 1;
+constexpr quint32 BlockMagic = 0x4B425055;   // "UPBK"
+constexpr int BlockHeaderSize = 24;
+constexpr int MaxBlockPayload = 64 * 1024;   // 超過即封 block(單一大 chunk 例外)
+constexpr quint8 FlagDirMask = 0x03;
+constexpr quint8 FlagFrameIndex = 0x04;
+// 與 SerialPortManager 的 idle flush(50ms)一致: 離線切行時以時間差重現當時的切行
+constexpr qint64 IdleFlushNs = 50 * 1000000LL;
+
+quint32 crc32(const char *data, qsizetype size, quint32 crc = 0);
+
+QByteArray fileHeader();
+
+// writer 端: 累積 record,seal() 產生 header + payload
+class BlockEncoder
+{
+public:
+    bool isEmpty() const { return m_count == 0; }
+    qsizetype payloadSize() const { return m_payload.size(); }
+    // frameIndex < 0 表示不記錄
+    void add(Direction dir, qint64 tsNs, const QByteArray &bytes, qint64 frameIndex = -1);
+    QByteArray seal();
+
+private:
+    QByteArray m_payload;
+    quint32 m_count = 0;
+    qint64 m_baseTs = 0;
+    qint64 m_lastTs = 0;
+};
+
+struct Record {
+    Direction dir = Rx;
+    qint64 tsNs = 0;
+    qint64 frameIndex = -1;
+    QByteArray bytes;
+};
+
+// reader 端: 循序讀 block / record;CRC 不符或截斷的 block 略過並計數
+class Reader
+{
+public:
+    explicit Reader(QFile *file);
+
+    bool isValid() const { return m_valid; }
+    bool next(Record &out);
+    qint64 skippedBlocks() const { return m_skipped; }
+
+private:
+    bool loadBlock();
+
+    QFile *m_file;
+    bool m_valid = false;
+    QByteArray m_block;
+    qsizetype m_pos = 0;
+    quint32 m_remaining = 0;
+    qint64 m_lastTs = 0;
+    qint64 m_skipped = 0;
+};
+
+// 記憶體(mmap)上的同一套走訪,可從任一 block 的第 N 筆 record 開始;
+// record.bytes 直接指向 data(fromRawData),data 必須比 record 活得久
+class MemoryReader
+{
+public:
+    MemoryReader(const char *data, qint64 size);
+
+    bool isValid() const { return m_valid; }
+    // 移到 blockOffset 處 block 的第 record 筆(blockOffset 必須是 next() 回報過的位置)
+    void seek(qint64 blockOffset, quint32 record);
+    bool next(Record &out);
+    // 下一筆 record 的位置: 所在 block 與 block 內序號(block 讀完時指向下一個 block 開頭)
+    qint64 blockOffset() const { return m_remaining > 0 ? m_blockOffset : m_pos; }
+    quint32 recordIndex() const { return m_remaining > 0 ? m_recordIndex : 0; }
+    qint64 position() const { return m_pos; }
+    qint64 skippedBlocks() const { return m_skipped; }
+
+private:
+    bool loadBlock();
+
+    const char *m_data;
+    qint64 m_size;
+    bool m_valid = false;
+    qint64 m_pos = 0;           // 下一個 block 的位置
+    qint64 m_blockOffset = 0;   // 目前 block 的位置
+    QByteArray m_block;
+    qsizetype m_recPos = 0;
+    quint32 m_remaining = 0;
+    quint32 m_recordIndex = 0;
+    qint64 m_lastTs = 0;
+    qint64 m_skipped = 0;
+};
+
+// --convert: capture → text / jsonl(以 LineSplitter 重新切行,與即時畫面一致)
+// 回傳 exit code: 0 成功, 3 檔案開啟失敗, 7 不是 capture 檔
+int convert(const QString &inPath, const QString &outPath, const QString &format);
+
+} // namespace CaptureFormat
+
+#endif // CAPTUREFORMAT_H
@@ -110,6 +110,26 @@ void ConfigManager::loadInternal(const QString &path)
         setColorNumbers(root.value(QStringLiteral("colorNumbers")).toBool(true));
     if (root.contains(QStringLiteral("maxBufferLines")))
         setMaxBufferLines(root.value(QStringLiteral("maxBufferLines")).toInt(50000));
+    if (root.contains(QStringLiteral("floodThreshold")))
+        setFloodThreshold(root.value(QStringLiteral("floodThreshold")).toInt(5000));
+    if (root.contains(QStringLiteral("plotPattern")))
+        setPlotPattern(root.value(QStringLiteral("plotPattern")).toString());
+    if (root.contains(QStringLiteral("logRotateMB")))
+        setLogRotateMB(root.value(QStringLiteral("logRotateMB")).toInt(0));
+    if (root.contains(QStringLiteral("logRotateMinutes")))
+        setLogRotateMinutes(root.value(QStringLiteral("logRotateMinutes")).toInt(0));
+    if (root.contains(QStringLiteral("logCompress")))
+        setLogCompress(root.value(QStringLiteral("logCompress")).toBool(false));
+    if (root.contains(QStringLiteral("logDiskBudgetMB")))
+        setLogDiskBudgetMB(root.value(QStringLiteral("logDiskBudgetMB")).toInt(0));
+    if (root.contains(QStringLiteral("logDurability")))
+        setLogDurability(root.value(QStringLiteral("logDurability")).toString(QStringLiteral("buffered")));
+    if (root.contains(QStringLiteral("logGroupCommitMs")))
+        setLogGroupCommitMs(root.value(QStringLiteral("logGroupCommitMs")).toInt(1000));
+    if (root.contains(QStringLiteral("logGroupCommitKB")))
+        setLogGroupCommitKB(root.value(QStringLiteral("logGroupCommitKB")).toInt(1024));
+    if (root.contains(QStringLiteral("hexDumpSpoolMB")))
+        setHexDumpSpoolMB(root.value(QStringLiteral("hexDumpSpoolMB")).toInt(256));
 
     auto readArray = [](const QJsonArray &arr, const QString &arrayType) -> QVariantList {
         QVariantList result;
@@ -205,6 +225,16 @@ void ConfigManager::saveToFile()
     root[QStringLiteral("showLineNumbers")] = m_showLineNumbers;
     root[QStringLiteral("colorNumbers")] = m_colorNumbers;
     root[QStringLiteral("maxBufferLines")] = m_maxBufferLines;
+    root[QStringLiteral("floodThreshold")] = m_floodThreshold;
+    root[QStringLiteral("plotPattern")] = m_plotPattern;
+    root[QStringLiteral("logRotateMB")] = m_logRotateMB;
+    root[QStringLiteral("logRotateMinutes")] = m_logRotateMinutes;
+    root[QStringLiteral("logCompress")] = m_logCompress;
+    root[QStringLiteral("logDiskBudgetMB")] = m_logDiskBudgetMB;
+    root[QStringLiteral("logDurability")] = m_logDurability;
+    root[QStringLiteral("logGroupCommitMs")] = m_logGroupCommitMs;
+    root[QStringLiteral("logGroupCommitKB")] = m_logGroupCommitKB;
+    root[QStringLiteral("hexDumpSpoolMB")] = m_hexDumpSpoolMB;
 
     auto writeArray = [](const QVariantList &list, const QString &arrayType) -> QJsonArray {
         QJsonArray arr;
@@ -255,6 +285,16 @@ bool ConfigManager::showTimestamp() const { return m_showTimestamp; }
 bool ConfigManager::showLineNumbers() const { return m_showLineNumbers; }
 bool ConfigManager::colorNumbers() const { return m_colorNumbers; }
 int ConfigManager::maxBufferLines() const { return m_maxBufferLines; }
+int ConfigManager::floodThreshold() const { return m_floodThreshold; }
+QString ConfigManager::plotPattern() const { return m_plotPattern; }
+int ConfigManager::logRotateMB() const { return m_logRotateMB; }
+int ConfigManager::logRotateMinutes() const { return m_logRotateMinutes; }
+bool ConfigManager::logCompress() const { return m_logCompress; }
+int ConfigManager::logDiskBudgetMB() const { return m_logDiskBudgetMB; }
+QString ConfigManager::logDurability() const { return m_logDurability; }
+int ConfigManager::logGroupCommitMs() const { return m_logGroupCommitMs; }
+int ConfigManager::logGroupCommitKB() const { return m_logGroupCommitKB; }
+int ConfigManager::hexDumpSpoolMB() const { return m_hexDumpSpoolMB; }
 QString ConfigManager::configFilePath() const { return m_configFilePath; }
 
 // ── Setters ─────────────────────────────────────────
@@ -334,6 +374,86 @@ void ConfigManager::setMaxBufferLines(int value)
     scheduleSave();
 }
 
+void ConfigManager::setFloodThreshold(int value)
+{
+    if (m_floodThreshold == value) return;
+    m_floodThreshold = value;
+    emit floodThresholdChanged();
+    scheduleSave();
+}
+
+void ConfigManager::setPlotPattern(const QString &value)
+{
+    if (m_plotPattern == value) return;
+    m_plotPattern = value;
+    emit plotPatternChanged();
+    scheduleSave();
+}
+
+void ConfigManager::setLogRotateMB(int value)
+{
+    if (m_logRotateMB == value) return;
+    m_logRotateMB = value;
+    emit logRotateMBChanged();
+    scheduleSave();
+}
+
+void ConfigManager::setLogRotateMinutes(int value)
+{
+    if (m_logRotateMinutes == value) return;
+    m_logRotateMinutes = value;
+    emit logRotateMinutesChanged();
+    scheduleSave();
+}
+
+void ConfigManager::setLogCompress(bool value)
+{
+    if (m_logCompress == value) return;
+    m_logCompress = value;
+    emit logCompressChanged();
+    scheduleSave();
+}
+
+void ConfigManager::setLogDiskBudgetMB(int value)
+{
+    if (m_logDiskBudgetMB == value) return;
+    m_logDiskBudgetMB = value;
+    emit logDiskBudgetMBChanged();
+    scheduleSave();
+}
+
+void ConfigManager::setLogDurability(const QString &value)
+{
+    if (m_logDurability == value) return;
+    m_logDurability = value;
+    emit logDurabilityChanged();
+    scheduleSave();
+}
+
+void ConfigManager::setLogGroupCommitMs(int value)
+{
+    if (m_logGroupCommitMs == value) return;
+    m_logGroupCommitMs = value;
+    emit logGroupCommitMsChanged();
+    scheduleSave();
+}
+
+void ConfigManager::setLogGroupCommitKB(int value)
+{
+    if (m_logGroupCommitKB == value) return;
+    m_logGroupCommitKB = value;
+    emit logGroupCommitKBChanged();
+    scheduleSave();
+}
+
+void ConfigManager::setHexDumpSpoolMB(int value)
+{
+    if (m_hexDumpSpoolMB == value) return;
+    m_hexDumpSpoolMB = value;
+    emit hexDumpSpoolMBChanged();
+    scheduleSave();
+}
+
 // ── Array operations ────────────────────────────────
 
 QVariantList ConfigManager::keywords() const { return m_keywords; }
@@ -19,6 +19,16 @@ class ConfigManager : public QObject
     Q_PROPERTY(bool showLineNumbers READ showLineNumbers WRITE setShowLineNumbers NOTIFY showLineNumbersChanged)
     Q_PROPERTY(bool colorNumbers READ colorNumbers WRITE setColorNumbers NOTIFY colorNumbersChanged)
     Q_PROPERTY(int maxBufferLines READ maxBufferLines WRITE setMaxBufferLines NOTIFY maxBufferLinesChanged)
+    Q_PROPERTY(int floodThreshold READ floodThreshold WRITE setFloodThreshold NOTIFY floodThresholdChanged)
+    Q_PROPERTY(QString plotPattern READ plotPattern WRITE setPlotPattern NOTIFY plotPatternChanged)
+    Q_PROPERTY(int logRotateMB READ logRotateMB WRITE setLogRotateMB NOTIFY logRotateMBChanged)
+    Q_PROPERTY(int logRotateMinutes READ logRotateMinutes WRITE setLogRotateMinutes NOTIFY logRotateMinutesChanged)
+    Q_PROPERTY(bool logCompress READ logCompress WRITE setLogCompress NOTIFY logCompressChanged)
+    Q_PROPERTY(int logDiskBudgetMB READ logDiskBudgetMB WRITE setLogDiskBudgetMB NOTIFY logDiskBudgetMBChanged)
+    Q_PROPERTY(QString logDurability READ logDurability WRITE setLogDurability NOTIFY logDurabilityChanged)
+    Q_PROPERTY(int logGroupCommitMs READ logGroupCommitMs WRITE setLogGroupCommitMs NOTIFY logGroupCommitMsChanged)
+    Q_PROPERTY(int logGroupCommitKB READ logGroupCommitKB WRITE setLogGroupCommitKB NOTIFY logGroupCommitKBChanged)
+    Q_PROPERTY(int hexDumpSpoolMB READ hexDumpSpoolMB WRITE setHexDumpSpoolMB NOTIFY hexDumpSpoolMBChanged)
     Q_PROPERTY(QString configFilePath READ configFilePath NOTIFY configFilePathChanged)
 
 public:
@@ -34,6 +44,16 @@ public:
     bool showLineNumbers() const;
     bool colorNumbers() const;
     int maxBufferLines() const;
+    int floodThreshold() const;
+    QString plotPattern() const;
+    int logRotateMB() const;
+    int logRotateMinutes() const;
+    bool logCompress() const;
+    int logDiskBudgetMB() const;
+    QString logDurability() const;
+    int logGroupCommitMs() const;
+    int logGroupCommitKB() const;
+    int hexDumpSpoolMB() const;
     QString configFilePath() const;
 
     void setUiScale(qreal value);
@@ -45,6 +65,16 @@ public:
     void setShowLineNumbers(bool value);
     void setColorNumbers(bool value);
     void setMaxBufferLines(int value);
+    void setFloodThreshold(int value);
+    void setPlotPattern(const QString &value);
+    void setLogRotateMB(int value);
+    void setLogRotateMinutes(int value);
+    void setLogCompress(bool value);
+    void setLogDiskBudgetMB(int value);
+    void setLogDurability(const QString &value);
+    void setLogGroupCommitMs(int value);
+    void setLogGroupCommitKB(int value);
+    void setHexDumpSpoolMB(int value);
 
     Q_INVOKABLE QVariantList keywords() const;
     Q_INVOKABLE void setKeywords(const QVariantList &list);
@@ -66,6 +96,16 @@ signals:
     void showLineNumbersChanged();
     void colorNumbersChanged();
     void maxBufferLinesChanged();
+    void floodThresholdChanged();
+    void plotPatternChanged();
+    void logRotateMBChanged();
+    void logRotateMinutesChanged();
+    void logCompressChanged();
+    void logDiskBudgetMBChanged();
+    void logDurabilityChanged();
+    void logGroupCommitMsChanged();
+    void logGroupCommitKBChanged();
+    void hexDumpSpoolMBChanged();
     void configFilePathChanged();
     void configLoaded();
 
@@ -86,6 +126,16 @@ private:
     bool m_showLineNumbers = false;
     bool m_colorNumbers = true;
     int m_maxBufferLines = 50000;
+    int m_floodThreshold = 5000;      // lines/s,0 = 關閉 flood mode
+    QString m_plotPattern;            // 空 = key=value
+    int m_logRotateMB = 0;            // 0 = 不依大小輪替
+    int m_logRotateMinutes = 0;       // 0 = 不依時間輪替
+    bool m_logCompress = false;       // segment 以 gzip 串流壓縮
+    int m_logDiskBudgetMB = 0;        // segment 總量上限,0 = 不限
+    QString m_logDurability = QStringLiteral("buffered");   // buffered | group | line
+    int m_logGroupCommitMs = 1000;    // group: 最長多久同步一次
+    int m_logGroupCommitKB = 1024;    // group: 累積多少就同步
+    int m_hexDumpSpoolMB = 256;       // hex dump 暫存檔上限,超過丟最舊的頁
     QString m_configFilePath;
 
     QVariantList m_keywords;
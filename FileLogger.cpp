@@ -1,18 +1,27 @@
 #include "FileLogger.h"
 #include <QDir>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include "version.h"
+#include <QFileInfo>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include "FilterQuery.h"
+#include "LogWriter.h"
 
 FileLogger::FileLogger(QObject *parent)
     : QObject(parent)
-    , m_file(nullptr)
-    , m_stream(nullptr)
-    , m_flushTimer(new QTimer(this))
+    , m_statsTimer(new QTimer(this))
+    , m_drainTimer(new QTimer(this))
     , m_logFileSize(0)
 {
-    m_flushTimer->setInterval(2000);
-    connect(m_flushTimer, &QTimer::timeout, this, &FileLogger::flushAndUpdateSize);
+    m_statsTimer->setInterval(500);
+    connect(m_statsTimer, &QTimer::timeout, this, &FileLogger::updateStats);
+    // 佇列滿時暫存的紀錄: 沒有新紀錄進來也要陸續補進佇列
+    m_drainTimer->setSingleShot(true);
+    m_drainTimer->setInterval(10);
+    connect(m_drainTimer, &QTimer::timeout, this, [this]() {
+        if (isLogging() && m_writer->drainSpill() > 0)
+            m_drainTimer->start();
+    });
 }
 
 FileLogger::~FileLogger()
@@ -20,9 +29,24 @@ FileLogger::~FileLogger()
     stopLogging();
 }
 
+// GUI 用系統時鐘: QElapsedTimer 在 Linux 不計休眠,睡眠喚醒後會落後實際時間
+qint64 FileLogger::sessionNs() const
+{
+    if (m_sessionClock)
+        return m_sessionEpochNs + m_sessionClock->nsecsElapsed();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void FileLogger::armDrain()
+{
+    if (m_writer->spillDepth() > 0 && !m_drainTimer->isActive())
+        m_drainTimer->start();
+}
+
 bool FileLogger::isLogging() const
 {
-    return m_file != nullptr && m_file->isOpen();
+    return m_writer != nullptr;
 }
 
 qint64 FileLogger::logFileSize() const
@@ -40,64 +64,176 @@ QString FileLogger::format() const
     return m_format;
 }
 
-// 在 jsonl 模式下 session 標頭/結尾也是 JSONL 事件列,維持整檔可逐行解析
-void FileLogger::writeSessionEvent(const QString &event)
-{
-    if (m_format == QLatin1String("jsonl")) {
-        QJsonObject obj;
-        obj[QStringLiteral("ts")] = QDateTime::currentDateTime().toString(Qt::ISODateWithMs);
-        obj[QStringLiteral("type")] = QStringLiteral("session");
-        obj[QStringLiteral("event")] = event;
-        obj[QStringLiteral("app")] = QStringLiteral(APP_NAME);
-        obj[QStringLiteral("version")] = QStringLiteral(APP_VERSION_STR);
-        *m_stream << QString::fromUtf8(QJsonDocument(obj).toJson(QJsonDocument::Compact))
-                  << QStringLiteral("\n");
-    } else if (event == QLatin1String("start")) {
-        *m_stream << QStringLiteral("=== UART PRO Log Session — ")
-                  << QDateTime::currentDateTime().toString(QStringLiteral("yyyy-MM-dd HH:mm:ss"))
-                  << QStringLiteral(" ===\n");
-    } else {
-        *m_stream << QStringLiteral("=== Session ended — ")
-                  << QDateTime::currentDateTime().toString(QStringLiteral("yyyy-MM-dd HH:mm:ss"))
-                  << QStringLiteral(" ===\n\n");
-    }
+void FileLogger::setTextTimestamp(bool enabled)
+{
+    if (m_textTimestamp == enabled)
+        return;
+    m_textTimestamp = enabled;
+    emit textLayoutChanged();
+}
+
+void FileLogger::setTextPrefix(bool enabled)
+{
+    if (m_textPrefix == enabled)
+        return;
+    m_textPrefix = enabled;
+    emit textLayoutChanged();
+}
+
+void FileLogger::setTextHex(bool enabled)
+{
+    if (m_textHex == enabled)
+        return;
+    m_textHex = enabled;
+    emit textLayoutChanged();
+}
+
+quint8 FileLogger::textLayout() const
+{
+    return (m_textTimestamp ? LogRecord::TextTimestamp : 0)
+         | (m_textPrefix ? LogRecord::TextPrefix : 0)
+         | (m_textHex ? LogRecord::TextHex : 0)
+         | (m_textIsoTimestamp ? LogRecord::TextIsoTimestamp : 0);
 }
 
 bool FileLogger::startLogging(const QString &filePath, const QString &format)
+{
+    LogTarget target;
+    target.path = filePath;
+    target.format = format;
+    return startLogging(QList<LogTarget> { target });
+}
+
+// 未知的格式名稱視為 text
+static LogWriter::Format writerFormat(const QString &format)
+{
+    if (format == QLatin1String("jsonl"))
+        return LogWriter::Jsonl;
+    if (format == QLatin1String("cap"))
+        return LogWriter::Capture;
+    if (format == QLatin1String("pcapng"))
+        return LogWriter::Pcapng;
+    return LogWriter::Text;
+}
+
+bool FileLogger::startLogging(const QList<LogTarget> &targets)
 {
     if (isLogging())
         stopLogging();
-
-    QString localPath = filePath;
-    // Strip file:/// prefix (from QML FileDialog)
-    if (localPath.startsWith(QStringLiteral("file:///")))
-        localPath = localPath.mid(8);
-    else if (localPath.startsWith(QStringLiteral("file://")))
-        localPath = localPath.mid(7);
-
-    m_file = new QFile(localPath, this);
-    if (!m_file->open(QIODevice::Append | QIODevice::Text)) {
-        delete m_file;
-        m_file = nullptr;
+    m_lastError.clear();
+    if (targets.isEmpty())
         return false;
+
+    // 開檔留在 GUI thread,失敗可以同步回報;binary + unbuffered: 由 writer 自己的 buffer 控制寫入大小
+    LogRotation rotation;
+    rotation.maxBytes = m_rotateBytes;
+    rotation.intervalMs = qint64(m_rotateIntervalSec) * 1000;
+    rotation.compress = m_compress;
+    rotation.diskBudget = m_diskBudgetBytes;
+    LogDurability durability;
+    durability.mode = LogDurability::modeFromName(m_durability);
+    durability.groupMs = qMax(1, m_groupCommitMs);
+    durability.groupBytes = qMax<qint64>(1, m_groupCommitBytes);
+
+    // 先編譯全部 filter、解析並檢查全部路徑,都通過才開檔:
+    // 後面的輸出檔不合法時,前面的檔不會已被修復或新建
+    struct Planned {
+        std::unique_ptr<LogSink> sink;
+        LogWriter::Format format;
+        FilterQuery filter;
+    };
+    std::vector<Planned> planned;
+    QStringList seenPaths;
+    for (const LogTarget &target : targets) {
+        FilterQuery filter = FilterQuery::compile(target.filter);
+        if (!filter.isValid()) {
+            m_lastError = QStringLiteral("invalid filter: ") + filter.errorString();
+            return false;
+        }
+
+        QString localPath = target.path;
+        // Strip file:/// prefix (from QML FileDialog)
+        if (localPath.startsWith(QStringLiteral("file:///")))
+            localPath = localPath.mid(8);
+        else if (localPath.startsWith(QStringLiteral("file://")))
+            localPath = localPath.mid(7);
+
+        // 兩個輸出寫同一個檔(或同一組 segment)會互相覆寫
+        const QFileInfo info(localPath);
+        const QString resolved = info.exists() ? info.canonicalFilePath() : info.absoluteFilePath();
+        if (seenPaths.contains(resolved)) {
+            m_lastError = QStringLiteral("duplicate log target: ") + localPath;
+            return false;
+        }
+        seenPaths.append(resolved);
+
+        const LogWriter::Format format = writerFormat(target.format);
+        // 修復 / 接續既有檔時依要寫的格式判斷
+        const LogSink::Content content = format == LogWriter::Capture ? LogSink::Capture
+                                       : format == LogWriter::Pcapng ? LogSink::Pcapng
+                                                                     : LogSink::Lines;
+        auto sink = std::make_unique<LogSink>(localPath, rotation, content);
+        if (!sink->validate()) {
+            m_lastError = sink->errorString();
+            return false;
+        }
+        planned.push_back({ std::move(sink), format, std::move(filter) });
     }
 
-    m_stream = new QTextStream(m_file);
-    m_stream->setEncoding(QStringConverter::Utf8);
+    auto writer = std::make_unique<LogWriter>(durability);
+    writer->setBlockWhenFull(m_blockWhenFull);
+    qint64 recovered = 0;
+    bool wantsLines = false;
+    bool wantsChunks = false;
+    for (Planned &p : planned) {
+        if (!p.sink->open()) {
+            m_lastError = p.sink->errorString();
+            return false;   // 已開的 sink 隨 writer 關閉
+        }
+        recovered += p.sink->recoveredBytes();
+        // 兩種 binary 格式都只收原始 chunk
+        if (p.format == LogWriter::Capture || p.format == LogWriter::Pcapng)
+            wantsChunks = true;
+        else
+            wantsLines = true;
+        writer->addOutput(p.sink.release(), p.format, p.filter);
+    }
 
-    m_logFilePath = localPath;
-    m_logFileSize = m_file->size();
-    m_format = (format == QLatin1String("jsonl")) ? QStringLiteral("jsonl")
-                                                  : QStringLiteral("text");
-    m_seq = 0;
+    static const char *const names[] = { "text", "jsonl", "cap", "pcapng" };
+    m_format = QLatin1String(names[writerFormat(targets.first().format)]);
+    m_wantsLines = wantsLines;
+    m_wantsChunks = wantsChunks;
+    m_writer = writer.release();
+    m_logFilePath = m_writer->sink()->currentPath();
+    m_logFileSize = m_writer->diskBytes();
+    m_recoveredBytes = recovered;
+    m_lastWritten = 0;
+    m_queueDepth = 0;
+    m_writeRate = 0;
+    m_lastSyncCount = 0;
+    m_lastSyncNs = 0;
+    m_syncLatencyUs = 0;
+    m_syncMaxUs = 0;
+    m_syncCount = 0;
+    m_producerStalls = 0;
+    m_producerStallMs = 0;
+    m_droppedRecords = 0;
     emit formatChanged();
 
-    writeSessionEvent(QStringLiteral("start"));
+    LogRecord start;
+    start.kind = LogRecord::SessionStart;
+    start.wallMs = sessionNs() / 1000000;
+    start.text = m_portNames.isEmpty() ? m_interfaceName : m_portNames.join(QLatin1Char('\n'));
+    m_writer->enqueue(std::move(start));
+    m_writer->start();
 
-    m_flushTimer->start();
+    m_statsClock.start();
+    m_statsTimer->start();
     emit loggingChanged();
     emit logFilePathChanged();
     emit logFileSizeChanged();
+    emit statsChanged();
+    emit sessionStarted();
     return true;
 }
 
@@ -106,22 +242,26 @@ void FileLogger::stopLogging()
     if (!isLogging())
         return;
 
-    m_flushTimer->stop();
-
-    writeSessionEvent(QStringLiteral("stop"));
-
-    m_stream->flush();
-    delete m_stream;
-    m_stream = nullptr;
-
-    m_logFileSize = m_file->size();
-
-    m_file->close();
-    delete m_file;
-    m_file = nullptr;
+    m_statsTimer->stop();
+    m_drainTimer->stop();
+
+    // 等 writer 寫完佇列與 session 結尾並關檔
+    m_writer->finish(sessionNs() / 1000000);
+    m_logFileSize = m_writer->diskBytes();
+    m_syncCount = qint64(m_writer->syncCount());
+    m_syncLatencyUs = m_syncCount > 0 ? m_writer->syncNsTotal() / m_syncCount / 1000 : 0;
+    m_syncMaxUs = m_writer->syncNsMax() / 1000;
+    m_producerStalls = qint64(m_writer->producerStalls());
+    m_producerStallMs = m_writer->producerStallNs() / 1000000;
+    m_droppedRecords = qint64(m_writer->droppedRecords());
+    delete m_writer;
+    m_writer = nullptr;
+    m_queueDepth = 0;
+    m_writeRate = 0;
 
     emit loggingChanged();
     emit logFileSizeChanged();
+    emit statsChanged();
 }
 
 void FileLogger::logEntry(const QString &timestamp, const QString &type,
@@ -134,38 +274,113 @@ void FileLogger::logEntry(const QString &timestamp, const QString &type,
     logLine(line);
 }
 
+void FileLogger::enqueueLine(const QString &line)
+{
+    LogRecord r;
+    r.kind = LogRecord::Line;
+    r.text = line;
+    m_writer->enqueue(std::move(r));
+    armDrain();
+}
+
 void FileLogger::logLine(const QString &line)
 {
-    if (!isLogging() || !m_stream)
+    if (!isLogging() || !m_wantsLines)
         return;
 
-    *m_stream << line << QStringLiteral("\n");
+    enqueueLine(line);
 }
 
 void FileLogger::logLines(const QStringList &lines)
 {
-    if (!isLogging() || !m_stream)
+    if (!isLogging() || !m_wantsLines)
         return;
 
     for (const QString &line : lines)
-        *m_stream << line << QStringLiteral("\n");
+        enqueueLine(line);
 }
 
 void FileLogger::logStructured(const QString &type, const QString &ascii,
-                               const QString &hex)
+                               const QString &hex, const QString &timestamp, int port)
+{
+    if (!isLogging() || !m_wantsLines)
+        return;
+
+    LogRecord r;
+    r.kind = LogRecord::Entry;
+    r.layout = textLayout();
+    r.wallMs = sessionNs() / 1000000;
+    r.timestamp = timestamp;
+    r.type = type;
+    r.text = ascii;
+    r.hex = hex;
+    r.port = quint16(port);
+    m_writer->enqueue(std::move(r));
+    armDrain();
+}
+
+void FileLogger::logEntries(const TerminalBatch &batch)
+{
+    if (!isLogging() || !m_wantsLines || batch.isEmpty())
+        return;
+
+    // 只搬字串參照(隱式共用),text / jsonl 的組行都在 writer thread
+    const quint8 layout = textLayout();
+    const qint64 now = sessionNs() / 1000000;
+    for (const TerminalEntry &e : batch) {
+        LogRecord r;
+        r.kind = LogRecord::Entry;
+        r.layout = layout;
+        r.wallMs = now;
+        r.timestamp = e.timestamp;
+        r.type = e.type;
+        r.text = e.msgText;
+        r.hex = e.hexData;
+        m_writer->enqueue(std::move(r));
+    }
+    armDrain();
+}
+
+void FileLogger::logChunk(const QByteArray &data, int direction, qint64 frameIndex, int port)
 {
-    if (!isLogging() || !m_stream)
+    if (!isLogging() || !m_wantsChunks || data.isEmpty())
         return;
 
-    QJsonObject obj;
-    obj[QStringLiteral("ts")] = QDateTime::currentDateTime().toString(Qt::ISODateWithMs);
-    obj[QStringLiteral("seq")] = m_seq++;
-    obj[QStringLiteral("type")] = type;
-    obj[QStringLiteral("ascii")] = ascii;
-    if (!hex.isEmpty())
-        obj[QStringLiteral("hex")] = hex;
-    *m_stream << QString::fromUtf8(QJsonDocument(obj).toJson(QJsonDocument::Compact))
-              << QStringLiteral("\n");
+    LogRecord r;
+    r.kind = LogRecord::Chunk;
+    r.bytes = data;
+    r.tsNs = sessionNs();
+    r.direction = quint8(direction);
+    r.frameIndex = frameIndex;
+    r.port = quint16(port);
+    m_writer->enqueue(std::move(r));
+    armDrain();
+}
+
+void FileLogger::setRotation(const LogRotation &rotation)
+{
+    m_rotateBytes = rotation.maxBytes;
+    m_rotateIntervalSec = int(rotation.intervalMs / 1000);
+    m_compress = rotation.compress;
+    m_diskBudgetBytes = rotation.diskBudget;
+    emit rotationChanged();
+}
+
+void FileLogger::setDurability(const LogDurability &durability)
+{
+    static const char *const names[] = { "buffered", "group", "line" };
+    m_durability = QLatin1String(names[durability.mode]);
+    m_groupCommitMs = int(durability.groupMs);
+    m_groupCommitBytes = durability.groupBytes;
+    emit durabilityChanged();
+}
+
+void FileLogger::setInterfaceName(const QString &name)
+{
+    if (m_interfaceName == name)
+        return;
+    m_interfaceName = name;
+    emit interfaceNameChanged();
 }
 
 QString FileLogger::generateDefaultPath() const
@@ -176,16 +391,50 @@ QString FileLogger::generateDefaultPath() const
     return QDir(docsPath).filePath(fileName);
 }
 
-void FileLogger::flushAndUpdateSize()
+void FileLogger::updateStats()
 {
     if (!isLogging())
         return;
 
-    m_stream->flush();
-    qint64 newSize = m_file->size();
+    const qint64 written = m_writer->bytesWritten();
+    const qint64 elapsedMs = m_statsClock.restart();
+    const qint64 rate = elapsedMs > 0 ? (written - m_lastWritten) * 1000 / elapsedMs : 0;
+    const int depth = int(m_writer->queueDepth() + m_writer->spillDepth());
+    m_lastWritten = written;
+
+    const quint64 syncs = m_writer->syncCount();
+    const qint64 syncNs = m_writer->syncNsTotal();
+    const qint64 latency = syncs > m_lastSyncCount
+        ? (syncNs - m_lastSyncNs) / qint64(syncs - m_lastSyncCount) / 1000
+        : m_syncLatencyUs;
+    const qint64 maxUs = m_writer->syncNsMax() / 1000;
+    m_lastSyncCount = syncs;
+    m_lastSyncNs = syncNs;
+    const qint64 stalls = qint64(m_writer->producerStalls());
+    const qint64 stallMs = m_writer->producerStallNs() / 1000000;
+    const qint64 dropped = qint64(m_writer->droppedRecords());
+
+    if (depth != m_queueDepth || rate != m_writeRate || latency != m_syncLatencyUs
+        || maxUs != m_syncMaxUs || qint64(syncs) != m_syncCount
+        || stalls != m_producerStalls || stallMs != m_producerStallMs || dropped != m_droppedRecords) {
+        m_droppedRecords = dropped;
+        m_producerStalls = stalls;
+        m_producerStallMs = stallMs;
+        m_queueDepth = depth;
+        m_writeRate = rate;
+        m_syncLatencyUs = latency;
+        m_syncMaxUs = maxUs;
+        m_syncCount = qint64(syncs);
+        emit statsChanged();
+    }
+    const qint64 newSize = m_writer->diskBytes();
     if (newSize != m_logFileSize) {
         m_logFileSize = newSize;
         emit logFileSizeChanged();
     }
+    const QString path = m_writer->sink()->currentPath();
+    if (path != m_logFilePath) {
+        m_logFilePath = path;
+        emit logFilePathChanged();
+    }
 }
-
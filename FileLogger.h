@@ -2,19 +2,66 @@
 #define FILELOGGER_H
 
 #include <QObject>
-#include <QFile>
-#include <QTextStream>
+#include <QElapsedTimer>
 #include <QTimer>
 #include <QStandardPaths>
 #include <QDateTime>
+#include "LogSink.h"
+#include "TerminalEntry.h"
+
+class LogWriter;
+struct LogRecord;
+
+// 一個輸出檔(headless 的 --record / --sink):
+// format 為 "text" | "jsonl" | "cap" | "pcapng",filter 為 FilterQuery 語法(空 = 全收,只作用於行)
+struct LogTarget {
+    QString path;
+    QString format = QStringLiteral("text");
+    QString filter;
+};
+
+// 記錄到檔案: GUI thread 只把原始紀錄排入 lock-free 佇列,
+// 格式化 / UTF-8 編碼 / 寫檔都在 LogWriter thread(見 LogWriter.h)。
+// 可同時寫多個輸出檔(各自格式與 filter),紀錄仍只入列一次;
+// logFilePath / format 為第一個輸出,logFileSize 與寫入統計為全部合計
 
 class FileLogger : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(bool logging READ isLogging NOTIFY loggingChanged)
+    // 輪替時為所有 segment 的磁碟總量 / 目前寫入中的 segment
     Q_PROPERTY(qint64 logFileSize READ logFileSize NOTIFY logFileSizeChanged)
     Q_PROPERTY(QString logFilePath READ logFilePath NOTIFY logFilePathChanged)
     Q_PROPERTY(QString format READ format NOTIFY formatChanged)
+    // text 格式的行版面(跟隨 UI 顯示偏好);jsonl 不受影響
+    Q_PROPERTY(bool textTimestamp READ textTimestamp WRITE setTextTimestamp NOTIFY textLayoutChanged)
+    Q_PROPERTY(bool textPrefix READ textPrefix WRITE setTextPrefix NOTIFY textLayoutChanged)
+    Q_PROPERTY(bool textHex READ textHex WRITE setTextHex NOTIFY textLayoutChanged)
+    // writer thread 狀態(500ms 取樣): 佇列中待寫紀錄數 / 寫入速率(bytes/s)
+    Q_PROPERTY(int queueDepth READ queueDepth NOTIFY statsChanged)
+    Q_PROPERTY(qint64 writeRate READ writeRate NOTIFY statsChanged)
+    // 輪替 / 壓縮 / 磁碟預算: 下一次 startLogging 生效(見 LogSink.h)
+    Q_PROPERTY(qint64 rotateBytes MEMBER m_rotateBytes NOTIFY rotationChanged)
+    Q_PROPERTY(int rotateIntervalSec MEMBER m_rotateIntervalSec NOTIFY rotationChanged)
+    Q_PROPERTY(bool compress MEMBER m_compress NOTIFY rotationChanged)
+    Q_PROPERTY(qint64 diskBudgetBytes MEMBER m_diskBudgetBytes NOTIFY rotationChanged)
+    // 耐久等級 "buffered" | "group" | "line" 與 group commit 上限: 下一次 startLogging 生效
+    Q_PROPERTY(QString durability MEMBER m_durability NOTIFY durabilityChanged)
+    Q_PROPERTY(int groupCommitMs MEMBER m_groupCommitMs NOTIFY durabilityChanged)
+    Q_PROPERTY(qint64 groupCommitBytes MEMBER m_groupCommitBytes NOTIFY durabilityChanged)
+    // pcapng 的 interface 名稱(port): 下一次 startLogging 生效
+    Q_PROPERTY(QString interfaceName MEMBER m_interfaceName NOTIFY interfaceNameChanged)
+    // 同步延遲(buffered 時為 write 延遲): 取樣區間平均 / 最大值(µs)與次數;停止後保留整段統計
+    Q_PROPERTY(qint64 syncLatencyUs READ syncLatencyUs NOTIFY statsChanged)
+    Q_PROPERTY(qint64 syncMaxUs READ syncMaxUs NOTIFY statsChanged)
+    Q_PROPERTY(qint64 syncCount READ syncCount NOTIFY statsChanged)
+    // 佇列滿的次數 / 阻塞時間(ms,只有 blockWhenFull)/ 暫存也滿而丟掉的紀錄數;停止後保留整段統計
+    Q_PROPERTY(qint64 producerStalls READ producerStalls NOTIFY statsChanged)
+    Q_PROPERTY(qint64 producerStallMs READ producerStallMs NOTIFY statsChanged)
+    Q_PROPERTY(qint64 droppedRecords READ droppedRecords NOTIFY statsChanged)
+    // 上次 startLogging 開檔時截掉的半筆紀錄 bytes / 失敗原因
+    Q_PROPERTY(qint64 recoveredBytes READ recoveredBytes NOTIFY loggingChanged)
+    Q_PROPERTY(QString lastError READ lastError NOTIFY loggingChanged)
 
 public:
     explicit FileLogger(QObject *parent = nullptr);
@@ -23,10 +70,29 @@ public:
     bool isLogging() const;
     qint64 logFileSize() const;
     QString logFilePath() const;
-    QString format() const;   // "text" | "jsonl"
+    QString format() const;   // "text" | "jsonl" | "cap" | "pcapng"
+    bool textTimestamp() const { return m_textTimestamp; }
+    void setTextTimestamp(bool enabled);
+    bool textPrefix() const { return m_textPrefix; }
+    void setTextPrefix(bool enabled);
+    bool textHex() const { return m_textHex; }
+    void setTextHex(bool enabled);
+    int queueDepth() const { return m_queueDepth; }
+    qint64 writeRate() const { return m_writeRate; }
+    qint64 syncLatencyUs() const { return m_syncLatencyUs; }
+    qint64 syncMaxUs() const { return m_syncMaxUs; }
+    qint64 syncCount() const { return m_syncCount; }
+    qint64 producerStalls() const { return m_producerStalls; }
+    qint64 producerStallMs() const { return m_producerStallMs; }
+    qint64 droppedRecords() const { return m_droppedRecords; }
+    // 開檔時截掉的半筆紀錄 bytes(上次當機留下)
+    qint64 recoveredBytes() const { return m_recoveredBytes; }
+    // startLogging 失敗時: 開不了的檔案或不合法的 filter
+    QString lastError() const { return m_lastError; }
 
     Q_INVOKABLE bool startLogging(const QString &filePath,
                                   const QString &format = QStringLiteral("text"));
+    bool startLogging(const QList<LogTarget> &targets);
     Q_INVOKABLE void stopLogging();
     Q_INVOKABLE void logLine(const QString &line);
     Q_INVOKABLE void logLines(const QStringList &lines);   // 批次寫入,單次 QML->C++ 跨界
@@ -34,27 +100,94 @@ public:
                               const QString &message, const QString &hexData);
     // JSONL 一筆: {"ts":ISO8601含毫秒,"seq":N,"type":...,"ascii":...,"hex":...}
     // schema 固定且與 UI 顯示偏好解耦,供 agent/LLM 穩定解析
+    // timestamp("HH:mm:ss.zzz")供 filter 的 time: 與 text 行使用
+    // port: setPortNames 的 index(多 port 時 text / jsonl 標上 port 名稱)
     Q_INVOKABLE void logStructured(const QString &type, const QString &ascii,
-                                   const QString &hex);
+                                   const QString &hex, const QString &timestamp = QString(),
+                                   int port = 0);
     Q_INVOKABLE QString generateDefaultPath() const;
+    void setRotation(const LogRotation &rotation);
+    void setDurability(const LogDurability &durability);
+    void setInterfaceName(const QString &name);
+    // headless 多 port: 依 index 的 port 名稱(取代 interfaceName),下一次 startLogging 生效
+    void setPortNames(const QStringList &names) { m_portNames = names; }
+    // 佇列滿時阻塞而不丟紀錄(headless);GUI 不設定: 先暫存、滿了才丟。下一次 startLogging 生效
+    void setBlockWhenFull(bool block) { m_blockWhenFull = block; }
+    // text 行的時間改為含日期的 ISO(headless 長時間錄製)
+    void setTextIsoTimestamp(bool enabled) { m_textIsoTimestamp = enabled; }
+    // headless: 紀錄時戳改用呼叫端的時鐘(epochNs + clock 經過時間),與 stdout 的 ts 同源。
+    // clock 須比 FileLogger 活得久;未設定時用系統時鐘
+    void setSessionClock(const QElapsedTimer *clock, qint64 epochNs)
+    {
+        m_sessionClock = clock;
+        m_sessionEpochNs = epochNs;
+    }
+
+public slots:
+    // TerminalModel 每批 flush 直連(C++ → C++,不經 QVariant / QML)
+    void logEntries(const TerminalBatch &batch);
+    // cap / pcapng 輸出: 切行前的原始 chunk(direction = CaptureFormat::Direction,frameIndex < 0 = 無)
+    void logChunk(const QByteArray &data, int direction, qint64 frameIndex = -1, int port = 0);
 
 signals:
     void loggingChanged();
     void logFileSizeChanged();
     void logFilePathChanged();
     void formatChanged();
+    void textLayoutChanged();
+    void statsChanged();
+    void rotationChanged();
+    void durabilityChanged();
+    void interfaceNameChanged();
+    // 開檔並寫完 session 標頭後發出(main.cpp 據此補寫 model 既有內容)
+    void sessionStarted();
 
 private:
-    void flushAndUpdateSize();
-    void writeSessionEvent(const QString &event);
+    void updateStats();
+    void enqueueLine(const QString &line);
+    qint64 sessionNs() const;
+    quint8 textLayout() const;
+    void armDrain();
 
-    QFile *m_file;
-    QTextStream *m_stream;
-    QTimer *m_flushTimer;
+    LogWriter *m_writer = nullptr;
+    QTimer *m_statsTimer;
+    QTimer *m_drainTimer;
+    QElapsedTimer m_statsClock;
+    // 紀錄時戳來源(見 setSessionClock);nullptr = 系統時鐘
+    const QElapsedTimer *m_sessionClock = nullptr;
+    qint64 m_sessionEpochNs = 0;
+    qint64 m_lastWritten = 0;
     qint64 m_logFileSize;
+    int m_queueDepth = 0;
+    qint64 m_writeRate = 0;
+    quint64 m_lastSyncCount = 0;
+    qint64 m_lastSyncNs = 0;
+    qint64 m_syncLatencyUs = 0;
+    qint64 m_syncMaxUs = 0;
+    qint64 m_syncCount = 0;
+    qint64 m_producerStalls = 0;
+    qint64 m_producerStallMs = 0;
+    qint64 m_droppedRecords = 0;
+    bool m_blockWhenFull = false;
+    qint64 m_recoveredBytes = 0;
+    QString m_lastError;
     QString m_logFilePath;
     QString m_format = QStringLiteral("text");
-    qint64 m_seq = 0;
+    bool m_wantsLines = false;    // 有 text / jsonl 輸出
+    bool m_wantsChunks = false;   // 有 cap / pcapng 輸出
+    bool m_textIsoTimestamp = false;
+    bool m_textTimestamp = true;
+    bool m_textPrefix = true;
+    bool m_textHex = false;
+    qint64 m_rotateBytes = 0;
+    int m_rotateIntervalSec = 0;
+    bool m_compress = false;
+    qint64 m_diskBudgetBytes = 0;
+    QString m_durability = QStringLiteral("buffered");
+    int m_groupCommitMs = 1000;
+    qint64 m_groupCommitBytes = 1 << 20;
+    QString m_interfaceName;
+    QStringList m_portNames;
 };
 
 #endif // FILELOGGER_H
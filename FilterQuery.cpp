@@ -0,0 +1,274 @@
+#include "FilterQuery.h"
+#include <algorithm>
+
+namespace {
+
+struct Token {
+    QString text;
+    bool negate = false;
+    bool quoted = false;   // 整個 term 以引號開頭 → 一律當子字串,不解析前綴
+    bool regex = false;    // /.../ 形式
+};
+
+// 空白分隔;支援 "..." 與 /.../(內含空白),'\\' 跳脫
+QList<Token> tokenize(const QString &query, QString *error)
+{
+    QList<Token> tokens;
+    const int n = query.size();
+    int i = 0;
+    while (i < n) {
+        while (i < n && query.at(i).isSpace())
+            ++i;
+        if (i >= n)
+            break;
+
+        Token tok;
+        if (query.at(i) == QLatin1Char('-') && i + 1 < n && !query.at(i + 1).isSpace()) {
+            tok.negate = true;
+            ++i;
+        }
+
+        if (query.at(i) == QLatin1Char('/')) {
+            ++i;
+            bool closed = false;
+            while (i < n) {
+                const QChar c = query.at(i);
+                if (c == QLatin1Char('\\') && i + 1 < n && query.at(i + 1) == QLatin1Char('/')) {
+                    tok.text += QLatin1Char('/');
+                    i += 2;
+                    continue;
+                }
+                if (c == QLatin1Char('/')) {
+                    closed = true;
+                    ++i;
+                    break;
+                }
+                tok.text += c;
+                ++i;
+            }
+            if (!closed) {
+                *error = QStringLiteral("unterminated /regex/");
+                return {};
+            }
+            tok.regex = true;
+            tokens.append(tok);
+            continue;
+        }
+
+        tok.quoted = query.at(i) == QLatin1Char('"');
+        while (i < n && !query.at(i).isSpace()) {
+            if (query.at(i) == QLatin1Char('"')) {
+                ++i;
+                bool closed = false;
+                while (i < n) {
+                    if (query.at(i) == QLatin1Char('"')) {
+                        closed = true;
+                        ++i;
+                        break;
+                    }
+                    tok.text += query.at(i++);
+                }
+                if (!closed) {
+                    *error = QStringLiteral("unterminated quote");
+                    return {};
+                }
+                continue;
+            }
+            tok.text += query.at(i++);
+        }
+        tokens.append(tok);
+    }
+    return tokens;
+}
+
+bool isTimeSpec(const QString &s)
+{
+    static const QRegularExpression re(QStringLiteral("^\\d{2}:\\d{2}(:\\d{2}(\\.\\d{1,3})?)?$"));
+    return re.match(s).hasMatch();
+}
+
+// "DE AD", "dead", "de:ad" → "DE AD"(與 SerialPortManager 的 hex 字串同格式)
+QString normalizeHex(const QString &s)
+{
+    QString digits;
+    for (const QChar c : s) {
+        if (c.isSpace() || c == QLatin1Char(':'))
+            continue;
+        const char16_t u = c.unicode();
+        if (!((u >= '0' && u <= '9') || (u >= 'a' && u <= 'f') || (u >= 'A' && u <= 'F')))
+            return QString();
+        digits += c.toUpper();
+    }
+    if (digits.isEmpty() || digits.size() % 2 != 0)
+        return QString();
+
+    QString out;
+    out.reserve(digits.size() / 2 * 3);
+    for (int i = 0; i < digits.size(); i += 2) {
+        if (i > 0)
+            out += QLatin1Char(' ');
+        out += digits.mid(i, 2);
+    }
+    return out;
+}
+
+} // namespace
+
+FilterQuery FilterQuery::compile(const QString &query)
+{
+    FilterQuery q;
+    q.m_source = query;
+
+    QString error;
+    const QList<Token> tokens = tokenize(query, &error);
+    if (!error.isEmpty()) {
+        q.m_error = error;
+        return q;
+    }
+
+    for (const Token &tok : tokens) {
+        if (tok.text.isEmpty())
+            continue;
+        if (tok.regex) {
+            if (!q.addTerm(QStringLiteral("re:") + tok.text, tok.negate))
+                return q;
+        } else if (tok.quoted) {
+            Predicate p;
+            p.kind = SubstringPred;
+            p.negate = tok.negate;
+            p.text = tok.text;
+            q.m_preds.append(p);
+        } else if (!q.addTerm(tok.text, tok.negate)) {
+            return q;
+        }
+    }
+
+    std::stable_sort(q.m_preds.begin(), q.m_preds.end(),
+                     [](const Predicate &a, const Predicate &b) { return a.kind < b.kind; });
+    return q;
+}
+
+bool FilterQuery::addTerm(const QString &term, bool negate)
+{
+    Predicate p;
+    p.negate = negate;
+
+    if (term.startsWith(QLatin1String("re:"))) {
+        p.kind = RegexPred;
+        p.re = QRegularExpression(term.mid(3), QRegularExpression::CaseInsensitiveOption);
+        if (!p.re.isValid()) {
+            m_error = QStringLiteral("invalid regex: ") + p.re.errorString();
+            return false;
+        }
+        // 立即編譯 + JIT,不等 QRegularExpression 的延遲最佳化門檻
+        p.re.optimize();
+    } else if (term.startsWith(QLatin1String("type:"))) {
+        p.kind = TypePred;
+        p.types = term.mid(5).toLower().split(QLatin1Char(','), Qt::SkipEmptyParts);
+        if (p.types.isEmpty()) {
+            m_error = QStringLiteral("type: needs at least one type");
+            return false;
+        }
+    } else if (term.startsWith(QLatin1String("len"))
+               && term.size() > 3 && QStringLiteral("<>=").contains(term.at(3))) {
+        p.kind = LengthPred;
+        QString rest = term.mid(3);
+        if (rest.startsWith(QLatin1String(">="))) { p.op = OpGe; rest = rest.mid(2); }
+        else if (rest.startsWith(QLatin1String("<="))) { p.op = OpLe; rest = rest.mid(2); }
+        else if (rest.startsWith(QLatin1Char('>'))) { p.op = OpGt; rest = rest.mid(1); }
+        else if (rest.startsWith(QLatin1Char('<'))) { p.op = OpLt; rest = rest.mid(1); }
+        else { p.op = OpEq; rest = rest.mid(1); }
+        bool ok = false;
+        p.length = rest.toInt(&ok);
+        if (!ok || p.length < 0) {
+            m_error = QStringLiteral("invalid length: ") + term;
+            return false;
+        }
+    } else if (term.startsWith(QLatin1String("time:"))) {
+        p.kind = TimePred;
+        const QStringList range = term.mid(5).split(QLatin1Char('-'));
+        if (range.size() != 2 || (!range.at(0).isEmpty() && !isTimeSpec(range.at(0)))
+            || (!range.at(1).isEmpty() && !isTimeSpec(range.at(1)))) {
+            m_error = QStringLiteral("invalid time range (HH:mm[:ss]-HH:mm[:ss]): ") + term;
+            return false;
+        }
+        p.timeLo = range.at(0);
+        p.timeHi = range.at(1);
+    } else if (term.startsWith(QLatin1String("hex:"))) {
+        p.kind = HexPred;
+        p.text = normalizeHex(term.mid(4));
+        if (p.text.isEmpty()) {
+            m_error = QStringLiteral("invalid hex pattern: ") + term;
+            return false;
+        }
+    } else {
+        p.kind = SubstringPred;
+        p.text = term;
+    }
+
+    m_preds.append(p);
+    return true;
+}
+
+bool FilterQuery::matches(const QString &type, const QString &timestamp,
+                          const QString &ascii, const QString &hex) const
+{
+    for (const Predicate &p : m_preds) {
+        if (evaluate(p, type, timestamp, ascii, hex) == p.negate)
+            return false;
+    }
+    return true;
+}
+
+// UTF-8 編碼後的 byte 數(不配置記憶體);RX 行的 ascii 與原始 byte 一對一,
+// TX / 開啟的 log 可能含非 ASCII 字元
+static int utf8Length(QStringView s)
+{
+    int n = 0;
+    for (const QChar c : s) {
+        const char16_t u = c.unicode();
+        if (u < 0x80)
+            n += 1;
+        else if (u < 0x800)
+            n += 2;
+        else if (QChar::isSurrogate(u))
+            n += 2;   // surrogate pair 兩個 code unit 共 4 bytes
+        else
+            n += 3;
+    }
+    return n;
+}
+
+bool FilterQuery::evaluate(const Predicate &p, const QString &type, const QString &timestamp,
+                           const QString &ascii, const QString &hex) const
+{
+    switch (p.kind) {
+    case TypePred:
+        return p.types.contains(type);
+    case LengthPred: {
+        const int len = utf8Length(ascii);
+        switch (p.op) {
+        case OpLt: return len < p.length;
+        case OpLe: return len <= p.length;
+        case OpEq: return len == p.length;
+        case OpGe: return len >= p.length;
+        case OpGt: return len > p.length;
+        }
+        return false;
+    }
+    case TimePred:
+        // 固定寬度 "HH:mm:ss.zzz" 可直接字典序比較;上界取同長度前綴以包含整個區間
+        if (!p.timeLo.isEmpty() && timestamp < p.timeLo)
+            return false;
+        if (!p.timeHi.isEmpty() && QStringView(timestamp).left(p.timeHi.size()).compare(p.timeHi) > 0)
+            return false;
+        return true;
+    case SubstringPred:
+        return ascii.contains(p.text, Qt::CaseInsensitive);
+    case HexPred:
+        return hex.contains(p.text);
+    case RegexPred:
+        return p.re.match(ascii).hasMatch();
+    }
+    return false;
+}
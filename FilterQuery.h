@@ -0,0 +1,67 @@
+#ifndef FILTERQUERY_H
+#define FILTERQUERY_H
+
+#include <QList>
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+
+// 過濾查詢語言: 一次編譯成 predicate pipeline,依成本由低到高求值(短路)。
+// 以空白分隔的 term 全部成立才算命中,term 前加 '-' 表示反向:
+//   word / "two words"              ascii 子字串(不分大小寫)
+//   /regex/ 或 re:regex              regex(不分大小寫,編譯時 optimize → PCRE2 JIT)
+//   type:rx,tx                       型別(rx / tx / system / error)
+//   len>N len>=N len<N len<=N len=N  ascii 的 UTF-8 byte 數(RX 行 = 原始 byte 數)
+//   time:HH:mm[:ss]-HH:mm[:ss]       顯示用 timestamp 區間(含首尾)
+//   hex:DEADBEEF / hex:"DE AD BE EF" byte 序列
+// 例: type:rx -/^dbg/ len>16 hex:"AA 55"
+class FilterQuery
+{
+public:
+    FilterQuery() = default;
+
+    static FilterQuery compile(const QString &query);
+
+    bool isValid() const { return m_error.isEmpty(); }
+    bool isEmpty() const { return m_preds.isEmpty(); }
+    QString errorString() const { return m_error; }
+    QString source() const { return m_source; }
+
+    // timestamp 為 "HH:mm:ss.zzz"; hex 為大寫空白分隔(SerialPortManager 的格式)
+    bool matches(const QString &type, const QString &timestamp,
+                 const QString &ascii, const QString &hex) const;
+
+private:
+    // 數值即成本排序依據: 便宜的先跑,命中失敗就不碰後面的 regex
+    enum Kind {
+        TypePred = 0,
+        LengthPred,
+        TimePred,
+        SubstringPred,
+        HexPred,
+        RegexPred
+    };
+    enum CompareOp { OpLt, OpLe, OpEq, OpGe, OpGt };
+
+    struct Predicate {
+        Kind kind = SubstringPred;
+        bool negate = false;
+        QStringList types;
+        CompareOp op = OpEq;
+        int length = 0;
+        QString timeLo;
+        QString timeHi;
+        QString text;             // substring / 正規化後的 hex
+        QRegularExpression re;
+    };
+
+    bool addTerm(const QString &term, bool negate);
+    bool evaluate(const Predicate &p, const QString &type, const QString &timestamp,
+                  const QString &ascii, const QString &hex) const;
+
+    QList<Predicate> m_preds;
+    QString m_error;
+    QString m_source;
+};
+
+#endif // FILTERQUERY_H
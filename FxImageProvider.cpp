@@ -0,0 +1,39 @@
+#include "FxImageProvider.h"
+#include <QColor>
+#include <QStringList>
+
+static const int MAX_TILE = 512;
+
+FxImageProvider::FxImageProvider()
+    : QQuickImageProvider(QQuickImageProvider::Image)
+{
+}
+
+QImage FxImageProvider::requestImage(const QString &id, QSize *size, const QSize &)
+{
+    const QStringList parts = id.split(QLatin1Char('/'));
+    QImage tile;
+
+    if (parts.value(0) == QLatin1String("grid") && parts.size() >= 3) {
+        const int spacing = qBound(2, parts.at(1).toInt(), MAX_TILE);
+        // URL 中的 '#' 會被當成 fragment,QML 端傳不含 '#' 的 AARRGGBB
+        const QColor color = QColor::fromString(QLatin1Char('#') + parts.at(2));
+        tile = QImage(spacing, spacing, QImage::Format_ARGB32_Premultiplied);
+        tile.fill(Qt::transparent);
+        const QRgb px = qPremultiply(color.isValid() ? color.rgba() : 0u);
+        QRgb *top = reinterpret_cast<QRgb *>(tile.scanLine(0));
+        for (int x = 0; x < spacing; ++x)
+            top[x] = px;
+        for (int y = 1; y < spacing; ++y)
+            reinterpret_cast<QRgb *>(tile.scanLine(y))[0] = px;
+    } else if (parts.value(0) == QLatin1String("scanline") && parts.size() >= 2) {
+        const int period = qBound(2, parts.at(1).toInt(), MAX_TILE);
+        tile = QImage(1, period, QImage::Format_ARGB32_Premultiplied);
+        tile.fill(Qt::transparent);
+        tile.setPixel(0, 0, qRgba(0, 0, 0, 255));
+    }
+
+    if (size)
+        *size = tile.size();
+    return tile;
+}
@@ -0,0 +1,19 @@
+#ifndef FXIMAGEPROVIDER_H
+#define FXIMAGEPROVIDER_H
+
+#include <QQuickImageProvider>
+
+// 背景特效的小 tile(取代全視窗 JS Canvas 逐條 fillRect)。
+// QML 以 Image { fillMode: Image.Tile } 平鋪:GPU 端 repeat 取樣,
+// 視窗 resize 不跑 JS、不重畫也不重傳 texture;換主題只換一張幾 KB 的 tile。
+//   image://fx/grid/<spacing>/<#AARRGGBB>   spacing×spacing,上緣與左緣各一條線
+//   image://fx/scanline/<period>            1×period,第一列黑色其餘透明
+class FxImageProvider : public QQuickImageProvider
+{
+public:
+    FxImageProvider();
+
+    QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize) override;
+};
+
+#endif // FXIMAGEPROVIDER_H
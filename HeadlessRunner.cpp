@@ -4,6 +4,7 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <cstdio>
+#include "CaptureFormat.h"
 
 // stderr 一律輸出 UTF-8 JSON,避免 Windows locale 字串經 qPrintable 變亂碼
 static void printStderrJson(const QJsonObject &obj)
@@ -16,44 +17,189 @@ HeadlessRunner::HeadlessRunner(const HeadlessOptions &opts, QObject *parent)
     : QObject(parent)
     , m_opts(opts)
 {
-    if (!m_opts.expectPattern.isEmpty())
-        m_expect = QRegularExpression(m_opts.expectPattern);
-    if (!m_opts.expectFailPattern.isEmpty())
-        m_expectFail = QRegularExpression(m_opts.expectFailPattern);
+    m_multiPort = m_opts.ports.size() > 1;
+    m_ports.reserve(size_t(m_opts.ports.size()));
+    for (int i = 0; i < m_opts.ports.size(); ++i) {
+        Port port;
+        port.name = m_opts.ports.at(i).name;
+        port.baud = m_opts.ports.at(i).baud;
+        port.serial = std::make_unique<SerialPortManager>();
+        SerialPortManager *serial = port.serial.get();
+
+        connect(serial, &SerialPortManager::dataReceived, this,
+                [this, i](const QString &timestamp, const QString &ascii, const QString &hex) {
+                    onLine(i, timestamp, ascii, hex);
+                });
+        // cap / pcapng 輸出記錄原始 chunk(不受 filter 影響: capture 是 byte-exact 的完整紀錄);
+        // 沒有這類輸出時 FileLogger 直接略過
+        connect(serial, &SerialPortManager::rawDataReceived, this, [this, i, serial](const QByteArray &data) {
+            m_logger.logChunk(data, CaptureFormat::Rx, serial->rxLineCount(), i);
+        });
+        connect(serial, &SerialPortManager::connectionLost, this, [this, i]() {
+            emitEvent(i, QStringLiteral("connection-lost"));
+        });
+        connect(serial, &SerialPortManager::reconnected, this, [this, i]() {
+            emitEvent(i, QStringLiteral("reconnected"));
+        });
+        connect(serial, &SerialPortManager::errorOccurred, this, [this, i](const QString &error) {
+            printStderrJson({ { QStringLiteral("event"), QStringLiteral("serial-error") },
+                              { QStringLiteral("port"), m_ports[size_t(i)].name },
+                              { QStringLiteral("detail"), error } });
+        });
+        m_ports.push_back(std::move(port));
+    }
+
+    m_expects = compileRules(m_opts.expect);
+    m_expectFails = compileRules(m_opts.expectFail);
+    m_unmetExpects = int(m_expects.size());
+    for (const Rule &rule : std::as_const(m_expects)) {
+        if (rule.port >= 0)
+            ++m_ports[size_t(rule.port)].unmetExpects;
+    }
+    if (!m_opts.filterQuery.isEmpty())
+        m_filter = FilterQuery::compile(m_opts.filterQuery);
 
     m_timeoutTimer.setSingleShot(true);
-    connect(&m_timeoutTimer, &QTimer::timeout, this, &HeadlessRunner::onTimeout);
+    connect(&m_timeoutTimer, &QTimer::timeout, this, [this]() { onTimeout(-1); });
+    for (const QString &spec : std::as_const(m_opts.timeouts)) {
+        QString rest;
+        const int port = splitPortRule(spec, rest);
+        const int sec = rest.toInt();
+        if (sec <= 0)
+            continue;
+        if (port < 0) {
+            m_timeoutTimer.setInterval(sec * 1000);
+            continue;
+        }
+        // 期限只約束該 port 的 expect: 沒有規則就沒有可等的,不計時
+        if (m_ports[size_t(port)].unmetExpects == 0) {
+            printStderrJson({ { QStringLiteral("event"), QStringLiteral("warning") },
+                              { QStringLiteral("reason"), QStringLiteral("timeout ignored") },
+                              { QStringLiteral("port"), m_ports[size_t(port)].name },
+                              { QStringLiteral("detail"), QStringLiteral("no PORT= --expect rule for this port") } });
+            continue;
+        }
+        auto deadline = std::make_unique<QTimer>();
+        deadline->setSingleShot(true);
+        deadline->setInterval(sec * 1000);
+        connect(deadline.get(), &QTimer::timeout, this, [this, port]() { onTimeout(port); });
+        m_ports[size_t(port)].deadline = std::move(deadline);
+    }
+}
 
-    connect(&m_serial, &SerialPortManager::dataReceived, this, &HeadlessRunner::onLine);
-    connect(&m_serial, &SerialPortManager::connectionLost, this, &HeadlessRunner::onConnectionLost);
-    connect(&m_serial, &SerialPortManager::reconnected, this, &HeadlessRunner::onReconnected);
-    connect(&m_serial, &SerialPortManager::errorOccurred, this, &HeadlessRunner::onError);
+// "PORT=rest" 且 PORT 是某個 --port 的名稱 → 該 port 的 index;否則 -1,整串都是 rest
+// (regex 本身含 '=' 時不受影響)
+int HeadlessRunner::splitPortRule(const QString &spec, QString &rest) const
+{
+    const qsizetype eq = spec.indexOf(QLatin1Char('='));
+    if (eq > 0) {
+        const QStringView name = QStringView(spec).left(eq);
+        for (size_t i = 0; i < m_ports.size(); ++i) {
+            if (name.compare(m_ports[i].name, Qt::CaseInsensitive) == 0) {
+                rest = spec.mid(eq + 1);
+                return int(i);
+            }
+        }
+    }
+    rest = spec;
+    return -1;
+}
+
+// 空白或不合法的 regex 略過(與單一 --expect 時相同)
+QList<HeadlessRunner::Rule> HeadlessRunner::compileRules(const QStringList &specs) const
+{
+    QList<Rule> rules;
+    for (const QString &spec : specs) {
+        Rule rule;
+        QString pattern;
+        rule.port = splitPortRule(spec, pattern);
+        rule.re = QRegularExpression(pattern);
+        if (!pattern.isEmpty() && rule.re.isValid())
+            rules.append(rule);
+    }
+    return rules;
 }
 
 int HeadlessRunner::start()
 {
-    if (!m_opts.recordPath.isEmpty()) {
-        if (!m_logger.startLogging(m_opts.recordPath, m_opts.format)) {
+    if (!m_filter.isValid()) {
+        printStderrJson({ { QStringLiteral("event"), QStringLiteral("error") },
+                          { QStringLiteral("reason"), QStringLiteral("invalid filter") },
+                          { QStringLiteral("detail"), m_filter.errorString() } });
+        return ExitBadFilter;
+    }
+
+    // --record(套用 --filter)與各 --sink 共用一個 writer: 每行只入列一次,filter 在 writer thread 求值
+    QList<LogTarget> targets;
+    if (!m_opts.recordPath.isEmpty())
+        targets.append({ m_opts.recordPath, m_opts.format, m_opts.filterQuery });
+    for (const LogTarget &sink : std::as_const(m_opts.sinks)) {
+        const FilterQuery query = FilterQuery::compile(sink.filter);
+        if (!query.isValid()) {
+            printStderrJson({ { QStringLiteral("event"), QStringLiteral("error") },
+                              { QStringLiteral("reason"), QStringLiteral("invalid filter") },
+                              { QStringLiteral("path"), sink.path },
+                              { QStringLiteral("detail"), query.errorString() } });
+            return ExitBadFilter;
+        }
+        targets.append(sink);
+    }
+    // cap 的 record 沒有 port 欄位,多 port 只能用 pcapng(每個 port 一個 interface)
+    for (const LogTarget &target : std::as_const(targets)) {
+        if (m_multiPort && target.format == QLatin1String("cap")) {
             printStderrJson({ { QStringLiteral("event"), QStringLiteral("error") },
                               { QStringLiteral("reason"), QStringLiteral("record open failed") },
-                              { QStringLiteral("path"), m_opts.recordPath } });
+                              { QStringLiteral("path"), target.path },
+                              { QStringLiteral("detail"), QStringLiteral("cap format records a single port, use pcapng") } });
             return ExitRecordFail;
         }
     }
-
-    if (!m_serial.connectToPort(m_opts.port, m_opts.baud, 8, 1, 0)) {
-        printStderrJson({ { QStringLiteral("event"), QStringLiteral("error") },
-                          { QStringLiteral("reason"), QStringLiteral("port open failed") },
-                          { QStringLiteral("port"), m_opts.port } });
-        m_logger.stopLogging();
-        return ExitPortFail;
+    // 時鐘在開檔前啟動: log 的 session 開頭 / 結尾與每筆紀錄都和 stdout 同一時鐘
+    m_epochMs = QDateTime::currentMSecsSinceEpoch();
+    m_clock.start();
+    if (!targets.isEmpty()) {
+        QStringList names;
+        for (const Port &port : m_ports)
+            names.append(port.name);
+        m_logger.setRotation(m_opts.rotation);
+        m_logger.setDurability(m_opts.durability);
+        m_logger.setPortNames(names);
+        m_logger.setTextIsoTimestamp(true);
+        m_logger.setBlockWhenFull(true);   // CI 記錄要完整,沒有 UI 要顧
+        m_logger.setSessionClock(&m_clock, m_epochMs * 1000000);
+        if (!m_logger.startLogging(targets)) {
+            printStderrJson({ { QStringLiteral("event"), QStringLiteral("error") },
+                              { QStringLiteral("reason"), QStringLiteral("record open failed") },
+                              { QStringLiteral("detail"), m_logger.lastError() } });
+            return ExitRecordFail;
+        }
     }
 
-    if (m_opts.timeoutSec > 0)
-        m_timeoutTimer.start(m_opts.timeoutSec * 1000);
+    for (Port &port : m_ports) {
+        if (!port.serial->connectToPort(port.name, port.baud, 8, 1, 0)) {
+            printStderrJson({ { QStringLiteral("event"), QStringLiteral("error") },
+                              { QStringLiteral("reason"), QStringLiteral("port open failed") },
+                              { QStringLiteral("port"), port.name } });
+            for (Port &opened : m_ports)
+                opened.serial->disconnectPort();
+            m_logger.stopLogging();
+            return ExitPortFail;
+        }
+    }
 
-    emitEvent(QStringLiteral("start"),
-              m_opts.port + QStringLiteral(" @ ") + QString::number(m_opts.baud));
+    if (m_timeoutTimer.interval() > 0)
+        m_timeoutTimer.start();
+    for (size_t i = 0; i < m_ports.size(); ++i) {
+        const Port &port = m_ports[i];
+        if (port.deadline)
+            port.deadline->start();
+        emitEvent(int(i), QStringLiteral("start"),
+                  port.name + QStringLiteral(" @ ") + QString::number(port.baud));
+    }
+    if (m_logger.recoveredBytes() > 0) {
+        emitEvent(-1, QStringLiteral("log-recovered"),
+                  QString::number(m_logger.recoveredBytes()) + QStringLiteral(" bytes truncated"));
+    }
     return 0;
 }
 
@@ -62,100 +208,125 @@ void HeadlessRunner::shutdown()
     finish(ExitOk, QStringLiteral("interrupted"));
 }
 
-void HeadlessRunner::onLine(const QString &timestamp, const QString &asciiData,
+void HeadlessRunner::onLine(int port, const QString &timestamp, const QString &asciiData,
                             const QString &hexData)
 {
-    Q_UNUSED(timestamp)
-
-    if (m_logger.isLogging()) {
-        if (m_opts.format == QLatin1String("jsonl")) {
-            m_logger.logStructured(QStringLiteral("rx"), asciiData, hexData);
-        } else {
-            const QString iso = QDateTime::currentDateTime().toString(Qt::ISODateWithMs);
-            m_logger.logLine(QStringLiteral("[") + iso + QStringLiteral("] RX> ") + asciiData);
-        }
-    }
+    // 記錄檔的 filter(--filter / --sink 的 query)由 writer 逐輸出套用
+    if (m_logger.isLogging())
+        m_logger.logStructured(QStringLiteral("rx"), asciiData, hexData, timestamp, port);
 
-    if (m_opts.streamStdout)
-        emitStdoutLine(QStringLiteral("rx"), asciiData, hexData);
+    if (m_opts.streamStdout
+        && (m_filter.isEmpty() || m_filter.matches(QStringLiteral("rx"), timestamp, asciiData, hexData)))
+        emitStdoutLine(port, QStringLiteral("rx"), asciiData, hexData);
 
     // 失敗 pattern 優先: 同一行同時命中時以失敗為準
-    if (m_expectFail.isValid() && !m_opts.expectFailPattern.isEmpty()
-        && m_expectFail.match(asciiData).hasMatch()) {
-        finish(ExitExpectFail, QStringLiteral("expect-fail matched"), asciiData);
-        return;
-    }
-    if (m_expect.isValid() && !m_opts.expectPattern.isEmpty()
-        && m_expect.match(asciiData).hasMatch()) {
-        finish(ExitOk, QStringLiteral("expect matched"), asciiData);
+    for (const Rule &rule : std::as_const(m_expectFails)) {
+        if ((rule.port < 0 || rule.port == port) && rule.re.match(asciiData).hasMatch()) {
+            finish(ExitExpectFail, QStringLiteral("expect-fail matched"), asciiData, port);
+            return;
+        }
     }
-}
 
-void HeadlessRunner::onTimeout()
-{
-    finish(ExitTimeout, QStringLiteral("timeout"));
+    // 每條 expect 命中一次即算數;全部命中才結束(單一 --expect 時即第一次命中)
+    bool matched = false;
+    for (Rule &rule : m_expects) {
+        if (rule.met || (rule.port >= 0 && rule.port != port) || !rule.re.match(asciiData).hasMatch())
+            continue;
+        rule.met = true;
+        matched = true;
+        --m_unmetExpects;
+        if (rule.port >= 0) {
+            Port &owner = m_ports[size_t(rule.port)];
+            if (--owner.unmetExpects == 0 && owner.deadline)
+                owner.deadline->stop();
+        }
+    }
+    if (!matched)
+        return;
+    if (m_unmetExpects == 0)
+        finish(ExitOk, QStringLiteral("expect matched"), asciiData, port);
+    else
+        emitEvent(port, QStringLiteral("expect-matched"), asciiData);
 }
 
-void HeadlessRunner::onConnectionLost()
+// port < 0: 整體 --timeout;否則該 port 的 expect 期限(命中後計時器已停)
+void HeadlessRunner::onTimeout(int port)
 {
-    emitEvent(QStringLiteral("connection-lost"));
+    finish(ExitTimeout, QStringLiteral("timeout"), QString(), port);
 }
 
-void HeadlessRunner::onReconnected()
+// stdout JSONL 走 JsonlWriter: 每行不建 QJsonObject,buffer 重用
+void HeadlessRunner::printStdoutJson()
 {
-    emitEvent(QStringLiteral("reconnected"));
+    const QByteArray &line = m_stdoutJson.data();
+    fwrite(line.constData(), 1, size_t(line.size()), stdout);
+    fflush(stdout);
 }
 
-void HeadlessRunner::onError(const QString &error)
+// 每筆共同的開頭: ts(共同單調時鐘);多 port 時另帶 monoUs(啟動後 µs,合併排序用)與 port
+void HeadlessRunner::beginStdoutJson(int port)
 {
-    printStderrJson({ { QStringLiteral("event"), QStringLiteral("serial-error") },
-                      { QStringLiteral("detail"), error } });
+    m_stdoutJson.clear();
+    m_stdoutJson.begin();
+    m_stdoutJson.timestampField("ts", nowMs());
+    if (m_multiPort) {
+        m_stdoutJson.field("monoUs", m_clock.nsecsElapsed() / 1000);
+        if (port >= 0)
+            m_stdoutJson.field("port", m_ports[size_t(port)].name);
+    }
 }
 
-void HeadlessRunner::emitStdoutLine(const QString &type, const QString &ascii,
+void HeadlessRunner::emitStdoutLine(int port, const QString &type, const QString &ascii,
                                     const QString &hex)
 {
-    QJsonObject obj;
-    obj[QStringLiteral("ts")] = QDateTime::currentDateTime().toString(Qt::ISODateWithMs);
-    obj[QStringLiteral("type")] = type;
-    obj[QStringLiteral("ascii")] = ascii;
+    beginStdoutJson(port);
+    m_stdoutJson.field("type", type);
+    m_stdoutJson.field("ascii", ascii);
     if (!hex.isEmpty())
-        obj[QStringLiteral("hex")] = hex;
-    printf("%s\n", QJsonDocument(obj).toJson(QJsonDocument::Compact).constData());
-    fflush(stdout);
+        m_stdoutJson.field("hex", hex);
+    m_stdoutJson.end();
+    printStdoutJson();
 }
 
-void HeadlessRunner::emitEvent(const QString &event, const QString &detail)
+void HeadlessRunner::emitEvent(int port, const QString &event, const QString &detail)
 {
-    QJsonObject obj;
-    obj[QStringLiteral("ts")] = QDateTime::currentDateTime().toString(Qt::ISODateWithMs);
-    obj[QStringLiteral("type")] = QStringLiteral("event");
-    obj[QStringLiteral("event")] = event;
+    beginStdoutJson(port);
+    m_stdoutJson.field("type", QLatin1String("event"));
+    m_stdoutJson.field("event", event);
     if (!detail.isEmpty())
-        obj[QStringLiteral("detail")] = detail;
-    printf("%s\n", QJsonDocument(obj).toJson(QJsonDocument::Compact).constData());
-    fflush(stdout);
+        m_stdoutJson.field("detail", detail);
+    m_stdoutJson.end();
+    printStdoutJson();
 }
 
-void HeadlessRunner::finish(int code, const QString &reason, const QString &line)
+void HeadlessRunner::finish(int code, const QString &reason, const QString &line, int port)
 {
     if (m_finished)
         return;
     m_finished = true;
 
     m_timeoutTimer.stop();
-    m_serial.disconnectPort();
+    for (Port &p : m_ports) {
+        if (p.deadline)
+            p.deadline->stop();
+        p.serial->disconnectPort();
+    }
     m_logger.stopLogging();
 
-    QJsonObject obj;
-    obj[QStringLiteral("ts")] = QDateTime::currentDateTime().toString(Qt::ISODateWithMs);
-    obj[QStringLiteral("type")] = QStringLiteral("exit");
-    obj[QStringLiteral("code")] = code;
-    obj[QStringLiteral("reason")] = reason;
+    beginStdoutJson(port);
+    m_stdoutJson.field("type", QLatin1String("exit"));
+    m_stdoutJson.field("code", code);
+    m_stdoutJson.field("reason", reason);
     if (!line.isEmpty())
-        obj[QStringLiteral("line")] = line;
-    printf("%s\n", QJsonDocument(obj).toJson(QJsonDocument::Compact).constData());
-    fflush(stdout);
+        m_stdoutJson.field("line", line);
+    if (m_logger.syncCount() > 0) {
+        // 整段的寫入(buffered)/ 同步延遲
+        m_stdoutJson.field("syncs", m_logger.syncCount());
+        m_stdoutJson.field("syncAvgUs", m_logger.syncLatencyUs());
+        m_stdoutJson.field("syncMaxUs", m_logger.syncMaxUs());
+    }
+    m_stdoutJson.end();
+    printStdoutJson();
 
     QCoreApplication::exit(code);
 }
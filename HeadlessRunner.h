@@ -1,24 +1,43 @@
 #ifndef HEADLESSRUNNER_H
 #define HEADLESSRUNNER_H
 
+#include <QElapsedTimer>
 #include <QObject>
 #include <QRegularExpression>
+#include <QStringList>
 #include <QTimer>
+#include <memory>
+#include <vector>
 #include "SerialPortManager.h"
 #include "FileLogger.h"
+#include "FilterQuery.h"
+#include "JsonlWriter.h"
 
 // --headless 模式: 不載 QML,純錄製/串流/pattern 等待。
-// exit codes: 0=正常或 expect 命中, 2=port 開啟失敗, 3=record 開檔失敗,
-//             4=timeout, 5=expect-fail 命中
-struct HeadlessOptions {
-    QString port;
+// exit codes: 0=正常或 expect 全部命中, 2=port 開啟失敗, 3=record 開檔失敗,
+//             4=timeout, 5=expect-fail 命中, 6=--filter 語法錯誤
+//
+// 多 port(--port 可重複,NAME@baud): 同一個行程、同一個事件迴圈收所有 port,
+// 每行依處理順序合併成單一串流(stdout / 同一組記錄檔),時間取自同一個單調時鐘。
+// 每個 port 只多一個 SerialPortManager(一個 QSerialPort + 閒置的 timer),32+ port 仍是單一 thread。
+// expect / expect-fail / timeout 規則可寫成 "PORT=..." 只套用在該 port(PORT 須是 --port 的名稱)
+struct HeadlessPort {
+    QString name;
     int baud = 115200;
+};
+
+struct HeadlessOptions {
+    QList<HeadlessPort> ports;
     QString recordPath;
-    QString format = QStringLiteral("text");   // "text" | "jsonl"
+    QString format = QStringLiteral("text");   // "text" | "jsonl" | "cap" | "pcapng"
+    QList<LogTarget> sinks;                    // --sink: 額外的輸出檔(各自格式 / filter)
     bool streamStdout = false;                 // 每行 JSONL 即時印到 stdout
-    QString expectPattern;
-    QString expectFailPattern;
-    int timeoutSec = 0;
+    QStringList expect;                        // "[PORT=]regex": 全部命中才 exit 0(無 PORT = 任一 port)
+    QStringList expectFail;                    // "[PORT=]regex": 任一命中即 exit 5
+    QStringList timeouts;                      // "SEC" 整體 / "PORT=SEC" 該 port 的 expect 期限
+    QString filterQuery;                       // 只影響 record/stdout,expect 仍看每一行(--sink 用自己的)
+    LogRotation rotation;                      // --rotate-size / ...(每個輸出各自套用)
+    LogDurability durability;                  // --durability / --group-commit-ms / --group-commit-kb
 };
 
 class HeadlessRunner : public QObject
@@ -30,7 +49,8 @@ public:
         ExitPortFail = 2,
         ExitRecordFail = 3,
         ExitTimeout = 4,
-        ExitExpectFail = 5
+        ExitExpectFail = 5,
+        ExitBadFilter = 6
     };
 
     explicit HeadlessRunner(const HeadlessOptions &opts, QObject *parent = nullptr);
@@ -41,24 +61,45 @@ public:
 public slots:
     void shutdown();   // Ctrl+C / SIGTERM
 
-private slots:
-    void onLine(const QString &timestamp, const QString &asciiData, const QString &hexData);
-    void onTimeout();
-    void onConnectionLost();
-    void onReconnected();
-    void onError(const QString &error);
-
 private:
-    void emitStdoutLine(const QString &type, const QString &ascii, const QString &hex);
-    void emitEvent(const QString &event, const QString &detail = QString());
-    void finish(int code, const QString &reason, const QString &line = QString());
+    struct Port {
+        QString name;
+        int baud = 115200;
+        std::unique_ptr<SerialPortManager> serial;
+        int unmetExpects = 0;             // 尚未命中的 PORT= expect 規則
+        std::unique_ptr<QTimer> deadline; // PORT=SEC timeout
+    };
+    struct Rule {
+        int port = -1;                    // -1 = 任一 port
+        QRegularExpression re;
+        bool met = false;
+    };
+
+    void onLine(int port, const QString &timestamp, const QString &asciiData, const QString &hexData);
+    void onTimeout(int port);
+    int splitPortRule(const QString &spec, QString &rest) const;
+    QList<Rule> compileRules(const QStringList &specs) const;
+    qint64 nowMs() const { return m_epochMs + m_clock.elapsed(); }
+    void beginStdoutJson(int port);
+    void emitStdoutLine(int port, const QString &type, const QString &ascii, const QString &hex);
+    void emitEvent(int port, const QString &event, const QString &detail = QString());
+    void finish(int code, const QString &reason, const QString &line = QString(), int port = -1);
+    void printStdoutJson();
 
     HeadlessOptions m_opts;
-    SerialPortManager m_serial;
+    std::vector<Port> m_ports;
+    bool m_multiPort = false;             // 2 個以上: 每筆輸出帶 port 與 monoUs
+    // 共同的單調時鐘: stdout 的 ts = 啟動時的 epoch + 經過時間(各 port 的行不會因校時而錯序);
+    // 也交給 m_logger 作紀錄時戳,須宣告在 m_logger 之前
+    QElapsedTimer m_clock;
+    qint64 m_epochMs = 0;
     FileLogger m_logger;
-    QRegularExpression m_expect;
-    QRegularExpression m_expectFail;
+    QList<Rule> m_expects;
+    QList<Rule> m_expectFails;
+    int m_unmetExpects = 0;
+    FilterQuery m_filter;
     QTimer m_timeoutTimer;
+    JsonlWriter m_stdoutJson;
     bool m_finished = false;
 };
 
@@ -0,0 +1,216 @@
+#include "HexDumpModel.h"
+#include <QDir>
+
+static const int COMMIT_INTERVAL_MS = 50;
+
+HexDumpModel::HexDumpModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_spool(QDir::tempPath() + QStringLiteral("/UARTPRO_hexdump_XXXXXX.bin"))
+{
+    m_writeBuffer.reserve(PageSize);
+    m_commitTimer.setSingleShot(true);
+    m_commitTimer.setInterval(COMMIT_INTERVAL_MS);
+    connect(&m_commitTimer, &QTimer::timeout, this, &HexDumpModel::commit);
+}
+
+int HexDumpModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return count();
+}
+
+QVariant HexDumpModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= count())
+        return QVariant();
+
+    const qint64 offset = m_startBytes + qint64(index.row()) * BytesPerRow;
+    if (role == OffsetRole)
+        return QString::number(offset, 16).toUpper().rightJustified(8, QLatin1Char('0'));
+
+    const QByteArray bytes = rowBytes(index.row());
+    if (role == HexRole) {
+        static const char digits[] = "0123456789ABCDEF";
+        // 固定寬度: 不滿一列的尾端補空白,ASCII 欄位對齊
+        QString hex(BytesPerRow * 3, QLatin1Char(' '));
+        QChar *out = hex.data();
+        for (int i = 0; i < bytes.size(); ++i) {
+            const uchar b = uchar(bytes.at(i));
+            const int pos = i * 3 + (i >= BytesPerRow / 2 ? 1 : 0);
+            out[pos] = QLatin1Char(digits[b >> 4]);
+            out[pos + 1] = QLatin1Char(digits[b & 0x0f]);
+        }
+        return hex;
+    }
+    if (role == AsciiRole) {
+        QString ascii(bytes.size(), QLatin1Char('.'));
+        QChar *out = ascii.data();
+        for (int i = 0; i < bytes.size(); ++i) {
+            const char c = bytes.at(i);
+            if (c >= 32 && c <= 126)
+                out[i] = QLatin1Char(c);
+        }
+        return ascii;
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> HexDumpModel::roleNames() const
+{
+    return {
+        { OffsetRole, QByteArrayLiteral("offset") },
+        { HexRole,    QByteArrayLiteral("hex") },
+        { AsciiRole,  QByteArrayLiteral("ascii") },
+    };
+}
+
+QByteArray HexDumpModel::rowBytes(int row) const
+{
+    const qint64 offset = m_startBytes + qint64(row) * BytesPerRow;
+    const int length = int(qMin<qint64>(BytesPerRow, m_committedBytes - offset));
+    if (offset >= m_spoolBytes)
+        return m_writeBuffer.mid(int(offset - m_spoolBytes), length);
+
+    const qint64 page = offset / PageSize;
+    return readPage(page).mid(int(offset - page * PageSize), length);
+}
+
+QByteArray HexDumpModel::readPage(qint64 page) const
+{
+    auto it = m_pages.constFind(page);
+    if (it != m_pages.constEnd()) {
+        m_pageOrder.removeOne(page);
+        m_pageOrder.append(page);
+        return it.value();
+    }
+
+    QByteArray bytes;
+    if (m_spool.seek((page % m_ringPages) * PageSize))
+        bytes = m_spool.read(PageSize);
+
+    if (m_pages.size() >= PageCacheLimit)
+        m_pages.remove(m_pageOrder.takeFirst());
+    m_pages.insert(page, bytes);
+    m_pageOrder.append(page);
+    return bytes;
+}
+
+void HexDumpModel::appendBytes(const QByteArray &data)
+{
+    if (!m_enabled || m_spoolFailed || data.isEmpty())
+        return;
+
+    qsizetype pos = 0;
+    while (pos < data.size()) {
+        const qsizetype take = qMin<qsizetype>(PageSize - m_writeBuffer.size(), data.size() - pos);
+        m_writeBuffer.append(data.constData() + pos, take);
+        m_receivedBytes += take;
+        pos += take;
+        if (m_writeBuffer.size() == PageSize) {
+            writeBufferToSpool();
+            if (m_spoolFailed)
+                break;
+        }
+    }
+
+    if (!m_commitTimer.isActive())
+        m_commitTimer.start();
+}
+
+void HexDumpModel::writeBufferToSpool()
+{
+    // 暫存檔延遲到第一頁滿才建立;之後一律整頁寫入,環滿了覆寫最舊的頁
+    const qint64 page = m_spoolBytes / PageSize;
+    if (page - m_startBytes / PageSize >= m_ringPages)
+        dropOldestPage();
+    const bool ok = (m_spool.isOpen() || m_spool.open())
+                    && m_spool.seek((page % m_ringPages) * PageSize)
+                    && m_spool.write(m_writeBuffer) == m_writeBuffer.size()
+                    && m_spool.flush();
+    if (!ok) {
+        // 磁碟寫不進去: 停在這一頁(仍留在緩衝可讀),之後的 bytes 不再收
+        m_spoolFailed = true;
+        emit spoolFailedChanged();
+        return;
+    }
+    m_spoolBytes += m_writeBuffer.size();
+    m_writeBuffer.clear();
+}
+
+// 最舊的頁即將被覆寫: 先移除它的 row(未提交的部分直接略過)
+void HexDumpModel::dropOldestPage()
+{
+    const qint64 page = m_startBytes / PageSize;
+    const int rows = int(qMin<qint64>(count(), PageSize / BytesPerRow));
+    if (rows > 0)
+        beginRemoveRows(QModelIndex(), 0, rows - 1);
+    m_startBytes += PageSize;
+    m_committedBytes = qMax(m_committedBytes, m_startBytes);
+    if (rows > 0)
+        endRemoveRows();
+    if (m_pages.remove(page))
+        m_pageOrder.removeOne(page);
+}
+
+void HexDumpModel::commit()
+{
+    if (m_receivedBytes == m_committedBytes)
+        return;
+
+    const int oldRows = count();
+    const bool partialTail = m_committedBytes % BytesPerRow != 0;
+    const int newRows = int(rowsFor(m_receivedBytes) - m_startBytes / BytesPerRow);
+
+    if (newRows > oldRows) {
+        beginInsertRows(QModelIndex(), oldRows, newRows - 1);
+        m_committedBytes = m_receivedBytes;
+        endInsertRows();
+    } else {
+        m_committedBytes = m_receivedBytes;
+    }
+    if (partialTail)
+        emit dataChanged(index(oldRows - 1), index(oldRows - 1), { HexRole, AsciiRole });
+    emit countChanged();
+}
+
+void HexDumpModel::clear()
+{
+    m_commitTimer.stop();
+    beginResetModel();
+    m_pages.clear();
+    m_pageOrder.clear();
+    m_writeBuffer.clear();
+    m_startBytes = 0;
+    m_spoolBytes = 0;
+    m_receivedBytes = 0;
+    m_committedBytes = 0;
+    if (m_spool.isOpen())
+        m_spool.resize(0);
+    endResetModel();
+    if (m_spoolFailed) {
+        m_spoolFailed = false;
+        emit spoolFailedChanged();
+    }
+    emit countChanged();
+}
+
+void HexDumpModel::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled)
+        return;
+    m_enabled = enabled;
+    emit enabledChanged();
+}
+
+void HexDumpModel::setSpoolLimitBytes(qint64 bytes)
+{
+    const int pages = int(qBound<qint64>(1, (bytes + PageSize - 1) / PageSize, MaxRingPages));
+    if (pages == m_ringPages)
+        return;
+    // 頁在檔案中的位置依環的大小而定,既有內容無法沿用
+    if (m_receivedBytes > 0)
+        clear();
+    m_ringPages = pages;
+    emit spoolLimitBytesChanged();
+}
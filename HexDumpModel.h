@@ -0,0 +1,97 @@
+#ifndef HEXDUMPMODEL_H
+#define HEXDUMPMODEL_H
+
+#include <QAbstractListModel>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QTemporaryFile>
+#include <QTimer>
+#include <QtQml/qqmlregistration.h>
+
+// 原始 RX byte stream 的傳統 hex dump(offset | 16 bytes | ASCII)。
+// - bytes 先進 64KB 寫入緩衝,滿一頁整頁寫進暫存檔(spool);記憶體只有緩衝 + 頁快取,
+//   幾百 MB 的擷取也是固定用量
+// - spool 是 spoolLimitBytes 大小的環狀檔: 滿了覆寫最舊的頁,前面的 row 隨之移除(offset 仍是串流位置)
+// - 面板第一次開啟(enabled)後才收 bytes,從未看 hex dump 就不寫暫存檔
+// - 檔案頁寫入後不再變動:讀取依頁快取(LRU),row 的字串只在 data() 被要求時才組
+// - 頁大小是 16 的倍數,一列不會跨頁,也不會跨檔案 / 緩衝的邊界
+// - 新 bytes 以 50ms 節流提交成 row(一次 beginInsertRows,尾端不滿一列的以 dataChanged 更新)
+class HexDumpModel : public QAbstractListModel
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("HexDumpModel is provided by the application as hexDumpModel")
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(qint64 byteCount READ byteCount NOTIFY countChanged)
+    Q_PROPERTY(bool spoolFailed READ spoolFailed NOTIFY spoolFailedChanged)
+    Q_PROPERTY(bool enabled READ isEnabled WRITE setEnabled NOTIFY enabledChanged)
+    // 環狀 spool 的上限(bytes,取整到頁);變更時清空現有內容
+    Q_PROPERTY(qint64 spoolLimitBytes READ spoolLimitBytes WRITE setSpoolLimitBytes NOTIFY spoolLimitBytesChanged)
+
+public:
+    enum Roles {
+        OffsetRole = Qt::UserRole + 1,   // "0001A2B0"
+        HexRole,                         // "41 42 ..  ..",8 bytes 之間多一格
+        AsciiRole                        // 不可列印字元以 '.' 表示
+    };
+
+    static constexpr int BytesPerRow = 16;
+
+    explicit HexDumpModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const { return int(rowsFor(m_committedBytes) - m_startBytes / BytesPerRow); }
+    qint64 byteCount() const { return m_committedBytes; }   // 串流累計(含已被覆寫的)
+    bool spoolFailed() const { return m_spoolFailed; }
+    bool isEnabled() const { return m_enabled; }
+    void setEnabled(bool enabled);
+    qint64 spoolLimitBytes() const { return qint64(m_ringPages) * PageSize; }
+    void setSpoolLimitBytes(qint64 bytes);
+
+    Q_INVOKABLE void clear();
+
+public slots:
+    void appendBytes(const QByteArray &data);
+
+signals:
+    void countChanged();
+    void spoolFailedChanged();
+    void enabledChanged();
+    void spoolLimitBytesChanged();
+
+private slots:
+    void commit();
+
+private:
+    static qint64 rowsFor(qint64 bytes) { return (bytes + BytesPerRow - 1) / BytesPerRow; }
+    QByteArray rowBytes(int row) const;
+    QByteArray readPage(qint64 page) const;
+    void writeBufferToSpool();
+    void dropOldestPage();
+
+    static constexpr int PageSize = 64 * 1024;
+    static constexpr int PageCacheLimit = 16;   // 1MB
+    // row 數須在 int 內: 上限 16 GiB = 1G 列
+    static constexpr qint64 MaxRingPages = (qint64(16) << 30) / PageSize;
+
+    // 以下位置都是串流累計的 byte offset;spool 的第 p 頁存在檔案的 (p % m_ringPages) 頁
+    mutable QTemporaryFile m_spool;
+    QByteArray m_writeBuffer;      // [m_spoolBytes, m_receivedBytes),未滿一頁
+    qint64 m_startBytes = 0;       // 還保留的第一個 byte(頁的起點),row 0
+    qint64 m_spoolBytes = 0;       // 已寫入暫存檔(整頁)
+    qint64 m_receivedBytes = 0;
+    qint64 m_committedBytes = 0;   // 已提交成 row 的 bytes
+    int m_ringPages = 4096;        // 256 MiB
+    bool m_enabled = false;
+    bool m_spoolFailed = false;
+    QTimer m_commitTimer;
+
+    mutable QHash<qint64, QByteArray> m_pages;
+    mutable QList<qint64> m_pageOrder;   // 最近使用在尾端
+};
+
+#endif // HEXDUMPMODEL_H
@@ -0,0 +1,160 @@
+#include "JsonlWriter.h"
+#include <QDateTime>
+#include <cstring>
+
+static inline void put2(char *out, int v)
+{
+    out[0] = char('0' + v / 10);
+    out[1] = char('0' + v % 10);
+}
+
+void IsoTimestamp::format(qint64 msecsSinceEpoch, char *out)
+{
+    const qint64 offset = msecsSinceEpoch - m_minuteStart;
+    if (m_minuteStart < 0 || offset < 0 || offset >= 60000) {
+        const QDateTime dt = QDateTime::fromMSecsSinceEpoch(msecsSinceEpoch);
+        const QDate d = dt.date();
+        const QTime t = dt.time();
+        const int y = d.year();
+        m_prefix[0] = char('0' + (y / 1000) % 10);
+        m_prefix[1] = char('0' + (y / 100) % 10);
+        put2(m_prefix + 2, y % 100);
+        m_prefix[4] = '-';
+        put2(m_prefix + 5, d.month());
+        m_prefix[7] = '-';
+        put2(m_prefix + 8, d.day());
+        m_prefix[10] = 'T';
+        put2(m_prefix + 11, t.hour());
+        m_prefix[13] = ':';
+        put2(m_prefix + 14, t.minute());
+        m_prefix[16] = ':';
+        m_minuteStart = msecsSinceEpoch - (t.second() * 1000 + t.msec());
+    }
+
+    const int inMinute = int(msecsSinceEpoch - m_minuteStart);
+    memcpy(out, m_prefix, sizeof(m_prefix));
+    put2(out + 17, inMinute / 1000);
+    out[19] = '.';
+    const int ms = inMinute % 1000;
+    out[20] = char('0' + ms / 100);
+    put2(out + 21, ms % 100);
+}
+
+void JsonlWriter::begin()
+{
+    m_buf.append('{');
+    m_first = true;
+}
+
+void JsonlWriter::end(QLatin1String newline)
+{
+    m_buf.append('}');
+    m_buf.append(newline.data(), newline.size());
+}
+
+void JsonlWriter::key(const char *key)
+{
+    if (!m_first)
+        m_buf.append(',');
+    m_first = false;
+    m_buf.append('"');
+    m_buf.append(key);
+    m_buf.append("\":", 2);
+}
+
+void JsonlWriter::field(const char *name, QStringView value)
+{
+    key(name);
+    m_buf.append('"');
+    appendEscaped(value);
+    m_buf.append('"');
+}
+
+void JsonlWriter::field(const char *name, QLatin1String value)
+{
+    key(name);
+    m_buf.append('"');
+    m_buf.append(value.data(), value.size());   // 呼叫端保證不需 escape 的 ASCII 常數
+    m_buf.append('"');
+}
+
+void JsonlWriter::field(const char *name, qint64 value)
+{
+    key(name);
+    char digits[24];
+    char *p = digits + sizeof(digits);
+    quint64 v = value < 0 ? quint64(-(value + 1)) + 1 : quint64(value);
+    do {
+        *--p = char('0' + v % 10);
+        v /= 10;
+    } while (v);
+    if (value < 0)
+        *--p = '-';
+    m_buf.append(p, digits + sizeof(digits) - p);
+}
+
+void JsonlWriter::timestampField(const char *name, qint64 msecsSinceEpoch)
+{
+    key(name);
+    const qsizetype at = m_buf.size();
+    m_buf.resize(at + IsoTimestamp::Length + 2);
+    char *out = m_buf.data() + at;
+    out[0] = '"';
+    m_ts.format(msecsSinceEpoch, out + 1);
+    out[IsoTimestamp::Length + 1] = '"';
+}
+
+void JsonlWriter::appendEscaped(QStringView value)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+
+    // 最壞情況每個 UTF-16 code unit 6 bytes(\u00XX);先撐開再截回實際長度,容量保留重用
+    const qsizetype at = m_buf.size();
+    m_buf.resize(at + value.size() * 6);
+    char *out = m_buf.data() + at;
+
+    const char16_t *p = value.utf16();
+    const char16_t *end = p + value.size();
+    while (p < end) {
+        const char16_t c = *p++;
+        if (c < 0x80) {
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                *out++ = char(c);
+                continue;
+            }
+            *out++ = '\\';
+            switch (c) {
+            case '"':  *out++ = '"'; break;
+            case '\\': *out++ = '\\'; break;
+            case '\n': *out++ = 'n'; break;
+            case '\r': *out++ = 'r'; break;
+            case '\t': *out++ = 't'; break;
+            case '\b': *out++ = 'b'; break;
+            case '\f': *out++ = 'f'; break;
+            default:
+                *out++ = 'u';
+                *out++ = '0';
+                *out++ = '0';
+                *out++ = hexDigits[c >> 4];
+                *out++ = hexDigits[c & 0xF];
+                break;
+            }
+        } else if (c < 0x800) {
+            *out++ = char(0xC0 | (c >> 6));
+            *out++ = char(0x80 | (c & 0x3F));
+        } else if (QChar::isHighSurrogate(c) && p < end && QChar::isLowSurrogate(*p)) {
+            const char32_t u = QChar::surrogateToUcs4(c, *p++);
+            *out++ = char(0xF0 | (u >> 18));
+            *out++ = char(0x80 | ((u >> 12) & 0x3F));
+            *out++ = char(0x80 | ((u >> 6) & 0x3F));
+            *out++ = char(0x80 | (u & 0x3F));
+        } else {
+            // 孤立 surrogate 以 U+FFFD 取代(與 QString::toUtf8 相同)
+            const char16_t u = QChar::isSurrogate(c) ? char16_t(0xFFFD) : c;
+            *out++ = char(0xE0 | (u >> 12));
+            *out++ = char(0x80 | ((u >> 6) & 0x3F));
+            *out++ = char(0x80 | (u & 0x3F));
+        }
+    }
+    m_buf.resize(out - m_buf.constData());
+}
@@ -0,0 +1,52 @@
+#ifndef JSONLWRITER_H
+#define JSONLWRITER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringView>
+
+// "yyyy-MM-ddTHH:mm:ss.zzz"(本地時間,與 Qt::ISODateWithMs 相同)。
+// 快取目前這一分鐘的 "yyyy-MM-ddTHH:mm:" 前綴,分鐘內只重畫秒與毫秒;
+// 跨分鐘才經 QDateTime 重算(時區 / 日光節約的切換都落在分鐘邊界)。非 thread-safe: 每個 thread 各自一份
+class IsoTimestamp
+{
+public:
+    static constexpr int Length = 23;
+
+    void format(qint64 msecsSinceEpoch, char *out);
+
+private:
+    qint64 m_minuteStart = -1;   // 快取前綴對應的分鐘起點(epoch ms)
+    char m_prefix[17] = {};      // "yyyy-MM-ddTHH:mm:"
+};
+
+// JSONL 直接組進可重用的 byte buffer(不經 QJsonObject / QJsonDocument / QString 往返)。
+// 欄位依呼叫順序輸出;字串做 JSON escape 並就地轉 UTF-8。用法:
+//   w.clear(); w.begin(); w.field("type", type); ...; w.end();  → w.data() = 一行(含換行)
+class JsonlWriter
+{
+public:
+    JsonlWriter() { m_buf.reserve(4096); }
+
+    void clear() { m_buf.resize(0); }   // 保留容量
+    const QByteArray &data() const { return m_buf; }
+
+    void begin();
+    void end(QLatin1String newline = QLatin1String("\n"));
+
+    void field(const char *key, QStringView value);
+    void field(const char *key, QLatin1String value);
+    void field(const char *key, qint64 value);
+    void field(const char *key, int value) { field(key, qint64(value)); }
+    void timestampField(const char *key, qint64 msecsSinceEpoch);
+
+private:
+    void key(const char *key);
+    void appendEscaped(QStringView value);
+
+    QByteArray m_buf;
+    bool m_first = true;
+    IsoTimestamp m_ts;
+};
+
+#endif // JSONLWRITER_H
@@ -0,0 +1,101 @@
+#ifndef LINESPLITTER_H
+#define LINESPLITTER_H
+
+#include <QByteArray>
+#include <QString>
+
+// RX byte stream → 行(\r\n / \n / \r 皆視為換行)。
+// SerialPortManager 即時切行與 capture 離線轉檔共用同一份規則,轉出的行與當時畫面一致
+class LineSplitter
+{
+public:
+    // 無換行資料的強制切行上限,避免 binary 資料讓 buffer 無限增長
+    static constexpr int MaxLineBytes = 4096;
+
+    bool hasPending() const { return !m_buffer.isEmpty(); }
+    // 尚未成行的殘留(不含完整行): 存起來之後 feed 回新的 splitter 即可接續
+    const QByteArray &pendingBytes() const { return m_buffer; }
+    void clear() { m_buffer.clear(); }
+
+    // 每切出一行(不含換行字元、略過空行)呼叫 fn(const QByteArray &)
+    template <typename Fn>
+    void feed(const QByteArray &data, Fn &&fn)
+    {
+        m_buffer.append(data);
+        process(false, fn);
+    }
+
+    // idle / 斷線: 殘留資料(含結尾孤立的 \r)也當成一行
+    template <typename Fn>
+    void flush(Fn &&fn)
+    {
+        process(true, fn);
+    }
+
+    // 顯示用文字: 不可列印字元以 '.' 取代 / 大寫空白分隔 hex
+    static QString asciiText(const QByteArray &line)
+    {
+        QString ascii;
+        ascii.reserve(line.size());
+        for (char c : line)
+            ascii += (c >= 32 && c <= 126) ? QLatin1Char(c) : QLatin1Char('.');
+        return ascii;
+    }
+    static QString hexText(const QByteArray &line)
+    {
+        return QString::fromLatin1(line.toHex(' ')).toUpper();
+    }
+
+private:
+    // 單趟掃描,結尾一次 remove
+    template <typename Fn>
+    void process(bool flushAll, Fn &fn)
+    {
+        int pos = 0;
+        const int size = m_buffer.size();
+        while (pos < size) {
+            int splitPos = -1;
+            int skipLen = 0;
+            for (int i = pos; i < size; ++i) {
+                char c = m_buffer.at(i);
+                if (c == '\n') {
+                    splitPos = i;
+                    skipLen = 1;
+                    break;
+                }
+                if (c == '\r') {
+                    if (i + 1 < size) {
+                        splitPos = i;
+                        skipLen = (m_buffer.at(i + 1) == '\n') ? 2 : 1;
+                    } else if (flushAll) {
+                        splitPos = i;
+                        skipLen = 1;
+                    }
+                    // 結尾孤立 \r 且非 flushAll: 可能是 \r\n 被拆包,等下一個 chunk
+                    break;
+                }
+            }
+            if (splitPos < 0) {
+                if (size - pos >= MaxLineBytes) {
+                    fn(m_buffer.mid(pos, MaxLineBytes));
+                    pos += MaxLineBytes;
+                    continue;
+                }
+                break;
+            }
+            if (splitPos > pos)
+                fn(m_buffer.mid(pos, splitPos - pos));
+            pos = splitPos + skipLen;
+        }
+        if (pos > 0)
+            m_buffer.remove(0, pos);
+        if (flushAll && !m_buffer.isEmpty()) {
+            fn(m_buffer);
+            m_buffer.clear();
+        }
+    }
+
+    QByteArray m_buffer;
+};
+
+#endif // LINESPLITTER_H
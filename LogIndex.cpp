@@ -0,0 +1,253 @@
+#include "LogIndex.h"
+#include <QByteArrayView>
+#include <QtEndian>
+#include <cstdio>
+#include <cstring>
+
+namespace LogIndex {
+
+QString sidecarPath(const QString &logPath)
+{
+    return logPath + QStringLiteral(".idx");
+}
+
+// JsonlWriter 固定把 seq 放在 ascii 之前,第一個 "seq": 就是欄位本身
+// (字串值裡的引號都已 escape,不會誤判)
+static bool parseSeq(QByteArrayView line, qint64 &seq)
+{
+    static constexpr QByteArrayView key("\"seq\":");
+    const qsizetype at = line.indexOf(key);
+    if (at < 0)
+        return false;
+    qint64 value = 0;
+    qsizetype i = at + key.size();
+    const qsizetype digits = i;
+    while (i < line.size() && line[i] >= '0' && line[i] <= '9')
+        value = value * 10 + (line[i++] - '0');
+    if (i == digits)
+        return false;
+    seq = value;
+    return true;
+}
+
+// [from, to) 內的每個完整行(含換行)交給 fn(line, 行首 offset);fn 回傳 false 即停止。
+// 結尾沒有換行的半行不算
+template <typename Fn>
+static void scanLines(QFile &file, qint64 from, qint64 to, Fn &&fn)
+{
+    constexpr qint64 ReadBlock = 1 << 20;
+    if (!file.seek(from))
+        return;
+    QByteArray chunk;
+    QByteArray carry;
+    qint64 readPos = from;
+    qint64 lineStart = from;
+    while (readPos < to) {
+        chunk = file.read(qMin(ReadBlock, to - readPos));
+        if (chunk.isEmpty())
+            return;
+        readPos += chunk.size();
+        if (!carry.isEmpty())
+            chunk.prepend(carry);
+
+        qsizetype begin = 0;
+        for (;;) {
+            const qsizetype nl = chunk.indexOf('\n', begin);
+            if (nl < 0)
+                break;
+            if (!fn(QByteArrayView(chunk.constData() + begin, nl + 1 - begin), lineStart))
+                return;
+            lineStart += nl + 1 - begin;
+            begin = nl + 1;
+        }
+        carry = chunk.mid(begin);
+    }
+}
+
+static bool readEntry(QFile &idx, qint64 i, Entry &out)
+{
+    char raw[EntrySize];
+    if (!idx.seek(HeaderSize + i * EntrySize) || idx.read(raw, EntrySize) != EntrySize)
+        return false;
+    out.seq = qFromLittleEndian<qint64>(raw);
+    out.tsMs = qFromLittleEndian<qint64>(raw + 8);
+    out.offset = qFromLittleEndian<qint64>(raw + 16);
+    return true;
+}
+
+static bool hasMagic(QFile &idx)
+{
+    char magic[HeaderSize];
+    return idx.seek(0) && idx.read(magic, HeaderSize) == HeaderSize
+        && memcmp(magic, FileMagic, HeaderSize) == 0;
+}
+
+// 第一個 pred 不成立的 entry(entry 依 seq / offset 遞增)
+template <typename Pred>
+static qint64 countWhile(QFile &idx, qint64 count, Pred &&pred)
+{
+    qint64 lo = 0;
+    qint64 hi = count;
+    Entry e;
+    while (lo < hi) {
+        const qint64 mid = lo + (hi - lo) / 2;
+        if (readEntry(idx, mid, e) && pred(e))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// 截掉 offset 超出 log 的 entry 與寫到一半的 entry;回傳剩下的 entry 數
+static qint64 dropPast(QFile &idx, qint64 logSize)
+{
+    qint64 count = (idx.size() - HeaderSize) / EntrySize;
+    count = countWhile(idx, count, [logSize](const Entry &e) { return e.offset < logSize; });
+    idx.resize(HeaderSize + count * EntrySize);
+    return count;
+}
+
+void truncate(const QString &logPath, qint64 logSize)
+{
+    QFile idx(sidecarPath(logPath));
+    if (!idx.exists() || !idx.open(QIODevice::ReadWrite))
+        return;
+    if (hasMagic(idx))
+        dropPast(idx, logSize);
+    else
+        idx.resize(0);   // 損壞: 下次開檔重建
+}
+
+qint64 Writer::open(const QString &logPath, qint64 logSize)
+{
+    close();
+    m_file.setFileName(sidecarPath(logPath));
+    if (!m_file.open(QIODevice::ReadWrite))
+        return -1;
+
+    // 截掉超出 log 的 entry(當機修復截掉的部分)與寫到一半的 entry
+    qint64 count = 0;
+    if (hasMagic(m_file)) {
+        count = dropPast(m_file, logSize);
+    } else {
+        m_file.resize(0);
+        m_file.seek(0);
+        m_file.write(FileMagic, HeaderSize);
+    }
+
+    // 從最後一個 checkpoint 掃到檔尾找最大的 seq(沒有索引的舊檔從頭掃一次)
+    Entry last;
+    qint64 scanFrom = 0;
+    qint64 maxSeq = -1;
+    if (count > 0 && readEntry(m_file, count - 1, last)) {
+        scanFrom = last.offset;
+        maxSeq = last.seq;
+        m_lastSeq = last.seq;
+    }
+    if (scanFrom < logSize) {
+        QFile log(logPath);
+        if (log.open(QIODevice::ReadOnly)) {
+            scanLines(log, scanFrom, logSize, [&maxSeq](QByteArrayView line, qint64) {
+                qint64 seq;
+                if (parseSeq(line, seq))
+                    maxSeq = qMax(maxSeq, seq);
+                return true;
+            });
+        }
+    }
+    m_file.seek(m_file.size());
+    return maxSeq + 1;
+}
+
+void Writer::close()
+{
+    if (m_file.isOpen())
+        m_file.close();
+    m_pending.clear();
+    m_lastSeq = -1;
+}
+
+void Writer::add(qint64 seq, qint64 tsMs, qint64 offset)
+{
+    m_pending.append({ seq, tsMs, offset });
+    m_lastSeq = seq;
+}
+
+void Writer::flush(qint64 logEnd)
+{
+    qsizetype n = 0;
+    while (n < m_pending.size() && m_pending.at(n).offset < logEnd)
+        ++n;
+    if (n == 0)
+        return;
+    QByteArray raw(n * EntrySize, Qt::Uninitialized);
+    char *p = raw.data();
+    for (qsizetype i = 0; i < n; ++i, p += EntrySize) {
+        const Entry &e = m_pending.at(i);
+        qToLittleEndian(e.seq, p);
+        qToLittleEndian(e.tsMs, p + 8);
+        qToLittleEndian(e.offset, p + 16);
+    }
+    // QFile 自己的 buffer 不會自動寫出: 不 flush 的話 --tail-from-seq 看不到新的 checkpoint
+    m_file.write(raw);
+    m_file.flush();
+    m_pending.remove(0, n);
+}
+
+// 起點: seq ≤ afterSeq + 1 的最後一個 checkpoint;該行對不上(索引過期)就從頭掃
+static qint64 seekStart(const QString &logPath, QFile &log, qint64 logSize, qint64 afterSeq)
+{
+    QFile idx(sidecarPath(logPath));
+    if (!idx.open(QIODevice::ReadOnly) || !hasMagic(idx))
+        return 0;
+    const qint64 count = (idx.size() - HeaderSize) / EntrySize;
+    const qint64 i = countWhile(idx, count, [afterSeq](const Entry &e) { return e.seq <= afterSeq + 1; });
+    Entry e;
+    if (i == 0 || !readEntry(idx, i - 1, e) || e.offset >= logSize)
+        return 0;
+
+    bool ok = false;
+    scanLines(log, e.offset, logSize, [&](QByteArrayView line, qint64) {
+        qint64 seq;
+        ok = parseSeq(line, seq) && seq == e.seq;
+        return false;
+    });
+    return ok ? e.offset : 0;
+}
+
+int tail(const QString &logPath, qint64 afterSeq)
+{
+    QFile log(logPath);
+    if (!log.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "cannot open log: %s\n", qUtf8Printable(logPath));
+        return 3;
+    }
+    QFile out;
+    if (!out.open(stdout, QIODevice::WriteOnly))
+        return 3;
+
+    // 以開始時的大小為準: writer 之後追加的行留給下一次查詢
+    const qint64 logSize = log.size();
+    const qint64 start = seekStart(logPath, log, logSize, afterSeq);
+
+    QByteArray buffer;
+    bool found = false;
+    scanLines(log, start, logSize, [&](QByteArrayView line, qint64) {
+        qint64 seq;
+        if (!found)
+            found = parseSeq(line, seq) && seq > afterSeq;
+        if (found) {
+            buffer.append(line);
+            if (buffer.size() >= (1 << 20)) {
+                out.write(buffer);
+                buffer.resize(0);
+            }
+        }
+        return true;
+    });
+    out.write(buffer);
+    return 0;
+}
+
+} // namespace LogIndex
@@ -0,0 +1,63 @@
+#ifndef LOGINDEX_H
+#define LOGINDEX_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+// JSONL log 的 seq 稀疏索引(sidecar "<log>.idx",little-endian):
+//
+//   header (8 B): magic "UPIDX\r\n\x1a"
+//   entry (24 B): i64 seq | i64 tsMs(epoch ms) | i64 offset(該行在 log 中的起點)
+//
+// 每個檔案(含輪替出的 segment)第一筆與之後每 Stride 筆記一個 checkpoint;seq 在同一檔內遞增
+// (append 到既有檔時接續最大的 seq)。查詢時二分搜尋 checkpoint 直接 seek,
+// 只需掃過一個 stride 加上新的行: 輪詢長時間 log 的成本與新增量成正比,不隨檔案成長。
+// 索引只是加速: offset 超出 log 的 entry 視為無效(當機修復後),索引遺失 / 損壞時退回從頭掃描。
+// gzip segment 無法 seek,不建索引
+namespace LogIndex {
+
+constexpr char FileMagic[8] = { 'U', 'P', 'I', 'D', 'X', '\r', '\n', '\x1a' };
+constexpr int HeaderSize = 8;
+constexpr int EntrySize = 24;
+constexpr qint64 Stride = 256;
+
+struct Entry {
+    qint64 seq = 0;
+    qint64 tsMs = 0;
+    qint64 offset = 0;
+};
+
+QString sidecarPath(const QString &logPath);
+// log 被截短(當機修復)後: 丟掉 offset ≥ logSize 的 entry
+void truncate(const QString &logPath, qint64 logSize);
+
+// writer thread 端: checkpoint 先留在記憶體,對應的行寫出到 log 後才寫進 sidecar
+class Writer
+{
+public:
+    // logSize = log 目前大小(修復後);截掉超出的 entry。回傳下一個 seq(空檔為 0),開檔失敗 -1
+    qint64 open(const QString &logPath, qint64 logSize);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    // 該 seq 需要 checkpoint(檔案第一筆或距上一個 checkpoint 滿 Stride)
+    bool wants(qint64 seq) const { return m_lastSeq < 0 || seq - m_lastSeq >= Stride; }
+    void add(qint64 seq, qint64 tsMs, qint64 offset);
+    // logEnd = 已寫出到 log 的位置
+    void flush(qint64 logEnd);
+
+private:
+    QFile m_file;
+    QVector<Entry> m_pending;
+    qint64 m_lastSeq = -1;
+};
+
+// --tail-from-seq: 輸出 seq > afterSeq 的第一行起到最後一個完整行為止(原樣 JSONL)。
+// 回傳 exit code: 0 成功, 3 開檔失敗
+int tail(const QString &logPath, qint64 afterSeq);
+
+} // namespace LogIndex
+
+#endif // LOGINDEX_H
@@ -0,0 +1,511 @@
+#include "LogSink.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <zlib.h>
+#include "CaptureFormat.h"
+#include "LogIndex.h"
+#include "PcapngFormat.h"
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+LogSink::LogSink(const QString &basePath, const LogRotation &rotation, Content content)
+    : m_rotation(rotation)
+    , m_content(content)
+    , m_basePath(basePath)
+{
+    const QFileInfo info(basePath);
+    m_dir = info.absolutePath();
+    m_stem = info.completeBaseName();
+    m_suffix = info.suffix().isEmpty() ? QString() : QLatin1Char('.') + info.suffix();
+}
+
+LogSink::~LogSink()
+{
+    close();
+}
+
+QString LogSink::segmentPath(int index) const
+{
+    return QDir(m_dir).filePath(m_stem + QLatin1Char('.')
+                                + QStringLiteral("%1").arg(index, 4, 10, QLatin1Char('0'))
+                                + m_suffix
+                                + (m_rotation.compress ? QStringLiteral(".gz") : QString()));
+}
+
+// 壓縮與否的 segment 都算(設定改過也能接續編號 / 納入預算)
+QRegularExpression LogSink::segmentPattern() const
+{
+    return QRegularExpression(QStringLiteral("^%1\\.(\\d{4,})%2(\\.gz)?$")
+                                  .arg(QRegularExpression::escape(m_stem),
+                                       QRegularExpression::escape(m_suffix)));
+}
+
+static QString notThisFormatError(const QString &path, LogSink::Content content)
+{
+    static const char *const names[] = { "text/JSONL", "capture", "pcapng" };
+    return QStringLiteral("existing file is not a %1 log: %2").arg(QLatin1String(names[content]), path);
+}
+
+static bool endsWithNewline(const QString &path)
+{
+    QFile file(path);
+    char last = 0;
+    return file.open(QIODevice::ReadOnly) && file.seek(file.size() - 1)
+        && file.getChar(&last) && last == '\n';
+}
+
+bool LogSink::open()
+{
+    m_error.clear();
+    if (!m_rotation.isSegmented()) {
+        const qint64 recovered = recoverTail(m_basePath, m_content);
+        if (recovered == NotThisFormat) {
+            m_error = notThisFormatError(m_basePath, m_content);
+            return false;
+        }
+        m_recovered = qMax<qint64>(0, recovered);
+        m_file = std::make_unique<QFile>(m_basePath);
+        if (!m_file->open(QIODevice::Append | QIODevice::Unbuffered)) {
+            m_error = QStringLiteral("cannot open ") + m_basePath;
+            m_file.reset();
+            return false;
+        }
+        m_newFile = m_file->size() == 0;
+        // 既有的文字檔沒有換行結尾(保留下來的外來內容 / 半行): 先補換行,新紀錄從行首開始
+        if (m_content == Lines && !m_newFile && !endsWithNewline(m_basePath))
+            m_file->write("\n", 1);
+        m_currentBytes = m_file->size();
+        QMutexLocker locker(&m_pathMutex);
+        m_currentPath = m_basePath;
+        return true;
+    }
+
+    // 編號接續既有 segment,重新開始記錄不覆蓋舊檔;既有 segment 也計入總量
+    const QRegularExpression re = segmentPattern();
+    const QFileInfoList infos = QDir(m_dir).entryInfoList(QDir::Files);
+    qint64 existing = 0;
+    QString latest;
+    for (const QFileInfo &info : infos) {
+        const auto m = re.match(info.fileName());
+        if (!m.hasMatch())
+            continue;
+        const int index = m.captured(1).toInt();
+        if (index > m_index) {
+            m_index = index;
+            latest = m.captured(2).isEmpty() ? info.filePath() : QString();   // gzip member 不修
+        }
+        existing += info.size();
+    }
+    ++m_index;
+    // 上次當機時寫入中的只會是最新的 segment(新內容寫進新 segment,格式不符就不修)
+    if (!latest.isEmpty())
+        m_recovered = qMax<qint64>(0, recoverTail(latest, m_content));
+    m_closedBytes = existing - m_recovered;
+
+    if (!openSegment()) {
+        m_error = QStringLiteral("cannot open ") + segmentPath(m_index);
+        return false;
+    }
+    prune();
+    return true;
+}
+
+bool LogSink::openSegment()
+{
+    const QString path = segmentPath(m_index);
+    auto file = std::make_unique<QFile>(path);
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered))
+        return false;
+    if (m_rotation.compress) {
+        // windowBits 15 + 16: zlib 自己寫 gzip header / trailer(CRC32 + ISIZE)
+        auto z = std::make_unique<z_stream_s>();
+        if (deflateInit2(z.get(), 6, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            return false;
+        m_zstream = std::move(z);
+        m_zbuf.resize(64 * 1024);
+        m_deflatePending = false;
+    }
+
+    m_file = std::move(file);
+    m_newFile = true;
+    m_segmentInput = 0;
+    m_currentBytes = 0;
+    m_segmentAge.start();
+    QMutexLocker locker(&m_pathMutex);
+    m_currentPath = path;
+    return true;
+}
+
+void LogSink::close()
+{
+    if (!m_file)
+        return;
+    finishStream();
+    m_file->close();
+    m_file.reset();
+}
+
+QString LogSink::currentPath() const
+{
+    QMutexLocker locker(&m_pathMutex);
+    return m_currentPath;
+}
+
+qint64 LogSink::write(const char *data, qsizetype size)
+{
+    if (!m_file || size <= 0)
+        return 0;
+
+    m_segmentInput += size;
+    m_newFile = false;
+    if (m_zstream) {
+        deflateChunk(data, size, Z_NO_FLUSH);
+        m_deflatePending = true;
+        return size;
+    }
+    writeRaw(data, size);
+    return size;
+}
+
+void LogSink::flush()
+{
+    if (m_zstream && m_deflatePending) {
+        deflateChunk(nullptr, 0, Z_SYNC_FLUSH);
+        m_deflatePending = false;
+    }
+}
+
+void LogSink::writeRaw(const char *data, qsizetype size)
+{
+    qsizetype done = 0;
+    while (done < size) {
+        const qint64 w = m_file->write(data + done, size - done);
+        if (w <= 0)
+            break;   // 磁碟滿 / 裝置移除: 丟棄這段,不卡住 writer
+        done += w;
+    }
+    m_currentBytes.fetch_add(done);
+}
+
+// 輸入一次交給 deflate(writer 每次最多 1 MiB),輸出滿一塊就寫出
+void LogSink::deflateChunk(const char *data, qsizetype size, int flush)
+{
+    z_stream_s &z = *m_zstream;
+    z.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+    z.avail_in = uInt(size);
+    do {
+        z.next_out = reinterpret_cast<Bytef *>(m_zbuf.data());
+        z.avail_out = uInt(m_zbuf.size());
+        if (deflate(&z, flush) == Z_STREAM_ERROR)
+            return;
+        writeRaw(m_zbuf.constData(), m_zbuf.size() - qsizetype(z.avail_out));
+    } while (z.avail_out == 0);
+}
+
+// 寫出 gzip trailer,segment 成為完整的 .gz
+void LogSink::finishStream()
+{
+    if (!m_zstream)
+        return;
+    deflateChunk(nullptr, 0, Z_FINISH);
+    deflateEnd(m_zstream.get());
+    m_zstream.reset();
+}
+
+bool LogSink::sync()
+{
+    if (!m_file)
+        return false;
+    const int fd = m_file->handle();
+#ifdef Q_OS_WIN
+    return FlushFileBuffers(reinterpret_cast<HANDLE>(_get_osfhandle(fd)));
+#elif defined(Q_OS_DARWIN)
+    return ::fsync(fd) == 0;   // macOS 沒有 fdatasync
+#else
+    return ::fdatasync(fd) == 0;
+#endif
+}
+
+bool LogSink::rotationDue(qint64 pending) const
+{
+    if (!m_file || (m_rotation.maxBytes <= 0 && m_rotation.intervalMs <= 0))
+        return false;
+    if (m_segmentInput + pending <= 0)
+        return false;   // 空 segment 不輪替
+    if (m_rotation.maxBytes > 0 && m_segmentInput + pending >= m_rotation.maxBytes)
+        return true;
+    return m_rotation.intervalMs > 0 && m_segmentAge.elapsed() >= m_rotation.intervalMs;
+}
+
+bool LogSink::rotate()
+{
+    if (!m_file)
+        return false;
+
+    finishStream();
+    m_closedBytes.fetch_add(m_file->size());
+    close();
+    ++m_index;
+    const bool ok = openSegment();
+    prune();
+    return ok;
+}
+
+void LogSink::prune()
+{
+    if (m_rotation.diskBudget <= 0)
+        return;
+
+    const QRegularExpression re = segmentPattern();
+    struct Segment { int index; QString path; qint64 size; };
+    QList<Segment> closed;
+    const QFileInfoList infos = QDir(m_dir).entryInfoList(QDir::Files);
+    for (const QFileInfo &info : infos) {
+        const auto m = re.match(info.fileName());
+        if (!m.hasMatch())
+            continue;
+        const int index = m.captured(1).toInt();
+        if (index != m_index)
+            closed.append({ index, info.filePath(), info.size() });
+    }
+    std::sort(closed.begin(), closed.end(),
+              [](const Segment &a, const Segment &b) { return a.index < b.index; });
+
+    qint64 total = m_currentBytes.load();
+    for (const Segment &s : std::as_const(closed))
+        total += s.size;
+
+    qsizetype drop = 0;
+    while (drop < closed.size() && total > m_rotation.diskBudget) {
+        if (QFile::remove(closed.at(drop).path)) {
+            total -= closed.at(drop).size;
+            QFile::remove(LogIndex::sidecarPath(closed.at(drop).path));
+        }
+        ++drop;
+    }
+    m_closedBytes = total - m_currentBytes.load();
+}
+
+// 寫到一半的量最多是 writer 一次寫出的 buffer(1 MiB);更長的尾巴不是半筆紀錄
+static constexpr qint64 MaxPartialTail = 1 << 20;
+
+// 文字 / JSONL: 只截確定是自己留下的殘骸:
+// - 檔尾延遲配置留下的 NUL
+// - 最後一個換行之後、以 {"ts": 開頭卻不是完整 JSON 的半筆 JSONL 紀錄
+// 其他沒有換行結尾的內容(手寫 / 其他程式的 log、text 格式的半行)整段保留,open() 先補換行再接續
+static qint64 lineTailEnd(QFile &file)
+{
+    const qint64 size = file.size();
+    const qint64 from = qMax<qint64>(0, size - MaxPartialTail);
+    file.seek(from);
+    const QByteArray buf = file.read(size - from);
+
+    qsizetype end = buf.size();
+    while (end > 0 && buf.at(end - 1) == '\0')
+        --end;
+    const qsizetype lineStart = buf.lastIndexOf('\n', end - 1) + 1;   // 沒有換行時為 0
+    const QByteArrayView tail(buf.constData() + lineStart, end - lineStart);
+    // lineStart == 0 且 from > 0: 這一行比 MaxPartialTail 長,不是半筆寫入
+    if (!tail.isEmpty() && (lineStart > 0 || from == 0) && tail.startsWith("{\"ts\":")) {
+        QJsonParseError error;
+        QJsonDocument::fromJson(tail.toByteArray(), &error);
+        if (error.error != QJsonParseError::NoError)
+            end = lineStart;
+    }
+    return from + end;
+}
+
+// capture: 只讀 block header 沿長度欄位走到尾端,最後一個完整 block 再驗 CRC。
+// 走不下去的位置離檔尾超過一個 block 時是中段損壞而非寫到一半,不截(reader 會重新同步)
+static qint64 captureTailEnd(QFile &file)
+{
+    using namespace CaptureFormat;
+    const qint64 size = file.size();
+    if (size < FileHeaderSize)
+        return 0;   // 連 file header 都沒寫完
+    qint64 pos = FileHeaderSize;
+    qint64 lastStart = -1;
+    char header[BlockHeaderSize];
+    while (pos + BlockHeaderSize <= size) {
+        file.seek(pos);
+        if (file.read(header, BlockHeaderSize) != BlockHeaderSize
+            || qFromLittleEndian<quint32>(header) != BlockMagic)
+            break;
+        const qint64 end = pos + BlockHeaderSize + qFromLittleEndian<quint32>(header + 4);
+        if (end > size)
+            break;
+        lastStart = pos;
+        pos = end;
+    }
+    if (size - pos > BlockHeaderSize + MaxBlockPayload)
+        return size;
+
+    if (lastStart >= 0) {
+        file.seek(lastStart);
+        file.read(header, BlockHeaderSize);
+        const QByteArray payload = file.read(pos - lastStart - BlockHeaderSize);
+        if (CaptureFormat::crc32(payload.constData(), payload.size()) != qFromLittleEndian<quint32>(header + 12))
+            pos = lastStart;
+    }
+    return pos;
+}
+
+// pcapng: 依 block 長度欄位走到最後一個前後長度一致的 block;
+// 剩下的量超過一個 chunk 可能的大小就不是半筆寫入,整檔保留
+static qint64 pcapngTailEnd(QFile &file)
+{
+    constexpr qint64 MaxPartialBlock = 1 << 20;
+    const qint64 size = file.size();
+    qint64 pos = 0;
+    char header[8];
+    char trailer[4];
+    while (pos + 12 <= size) {
+        file.seek(pos);
+        if (file.read(header, 8) != 8)
+            break;
+        // 後面接了非 little-endian 的 section: 不解析,整檔保留
+        if (pos > 0 && qFromLittleEndian<quint32>(header) == Pcapng::SectionHeaderType) {
+            char bom[4];
+            if (file.read(bom, 4) == 4 && qFromLittleEndian<quint32>(bom) != Pcapng::ByteOrderMagic)
+                return size;
+        }
+        const quint32 len = qFromLittleEndian<quint32>(header + 4);
+        if (len < 12 || len % 4 != 0 || pos + len > size)
+            break;
+        file.seek(pos + len - 4);
+        if (file.read(trailer, 4) != 4 || qFromLittleEndian<quint32>(trailer) != len)
+            break;
+        pos += len;
+    }
+    return size - pos > MaxPartialBlock ? size : pos;
+}
+
+// 既有檔的開頭是哪一種
+enum class Sniffed { Empty, Capture, PcapngLE, PcapngBE, Text, Binary };
+
+static Sniffed sniff(QFile &file)
+{
+    file.seek(0);
+    const QByteArray head = file.read(4096);
+    if (head.isEmpty())
+        return Sniffed::Empty;
+    if (head.startsWith(QByteArrayView(CaptureFormat::FileMagic, sizeof(CaptureFormat::FileMagic))))
+        return Sniffed::Capture;
+    if (head.size() >= 12 && qFromLittleEndian<quint32>(head.constData()) == Pcapng::SectionHeaderType) {
+        if (qFromLittleEndian<quint32>(head.constData() + 8) == Pcapng::ByteOrderMagic)
+            return Sniffed::PcapngLE;
+        if (qFromBigEndian<quint32>(head.constData() + 8) == Pcapng::ByteOrderMagic)
+            return Sniffed::PcapngBE;
+        return Sniffed::Binary;
+    }
+    // 文字檔不含 NUL;整檔都在 head 內時,檔尾延遲配置留下的 NUL 不算
+    qsizetype textEnd = head.size();
+    if (head.size() == file.size()) {
+        while (textEnd > 0 && head.at(textEnd - 1) == '\0')
+            --textEnd;
+    }
+    return QByteArrayView(head.constData(), textEnd).contains('\0') ? Sniffed::Binary : Sniffed::Text;
+}
+
+LogSink::Content LogSink::detectContent(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return Lines;
+    switch (sniff(file)) {
+    case Sniffed::Capture:
+        return Capture;
+    case Sniffed::PcapngLE:
+    case Sniffed::PcapngBE:
+        return Pcapng;
+    default:
+        return Lines;
+    }
+}
+
+// 既有檔能不能接續寫 content(big-endian pcapng 不解析,但另起 section 照樣可接)
+static bool sniffMatches(Sniffed kind, LogSink::Content content)
+{
+    switch (content) {
+    case LogSink::Capture: return kind == Sniffed::Capture;
+    case LogSink::Pcapng:  return kind == Sniffed::PcapngLE || kind == Sniffed::PcapngBE;
+    case LogSink::Lines:   return kind == Sniffed::Text;
+    }
+    return false;
+}
+
+bool LogSink::validate()
+{
+    m_error.clear();
+    const QFileInfo dir(m_dir);
+    if (!dir.isDir() || !dir.isWritable()) {
+        m_error = QStringLiteral("cannot write to ") + m_dir;
+        return false;
+    }
+    // segment: 新內容寫進新檔,格式不符的舊 segment 只是不修
+    if (m_rotation.isSegmented())
+        return true;
+    QFile file(m_basePath);
+    if (!file.exists() || file.size() == 0)
+        return true;
+    if (!file.open(QIODevice::ReadOnly) || !QFileInfo(m_basePath).isWritable()) {
+        m_error = QStringLiteral("cannot open ") + m_basePath;
+        return false;
+    }
+    if (!sniffMatches(sniff(file), m_content)) {
+        m_error = notThisFormatError(m_basePath, m_content);
+        return false;
+    }
+    return true;
+}
+
+qint64 LogSink::recoverTail(const QString &path, Content content)
+{
+    QFile file(path);
+    if (!file.exists() || file.size() == 0)
+        return 0;
+    if (!file.open(QIODevice::ReadWrite))
+        return CannotOpen;
+
+    const qint64 size = file.size();
+    const Sniffed kind = sniff(file);
+    if (!sniffMatches(kind, content))
+        return NotThisFormat;
+    qint64 keep = size;
+    switch (content) {
+    case Capture:
+        keep = qMax<qint64>(CaptureFormat::FileHeaderSize, captureTailEnd(file));
+        break;
+    case Pcapng:
+        // big-endian section 不解析;新的 session 另起 section,照樣可接
+        if (kind == Sniffed::PcapngBE)
+            return 0;
+        keep = pcapngTailEnd(file);
+        if (keep == 0)
+            keep = size;   // 第一個 section header 都不完整: 不截
+        break;
+    case Lines:
+        keep = lineTailEnd(file);
+        break;
+    }
+    if (keep >= size)
+        return 0;
+    // 截之前先留下紀錄(GUI / headless 之後另外顯示截掉的量)
+    qWarning("log recovery: truncating %lld bytes of an incomplete record at the end of %s",
+             size - keep, qUtf8Printable(path));
+    if (!file.resize(keep))
+        return CannotOpen;
+    // 修復的 segment 之後不會再經過 LogIndex::Writer::open,sidecar 在這裡一起截
+    LogIndex::truncate(path, keep);
+    return size - keep;
+}
@@ -0,0 +1,137 @@
+#ifndef LOGSINK_H
+#define LOGSINK_H
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QRegularExpression>
+#include <QString>
+#include <atomic>
+#include <memory>
+
+struct z_stream_s;
+
+// 輪替 / 壓縮 / 磁碟預算設定(開始記錄時決定,記錄中不變)
+struct LogRotation {
+    qint64 maxBytes = 0;      // 單一 segment 寫入量(壓縮前)上限,0 = 不依大小
+    qint64 intervalMs = 0;    // segment 時間長度上限,0 = 不依時間
+    bool compress = false;    // gzip 串流壓縮(每個 segment 一個 deflate stream)
+    qint64 diskBudget = 0;    // 所有 segment 的磁碟總量上限,0 = 不限
+
+    bool isSegmented() const { return maxBytes > 0 || intervalMs > 0 || compress; }
+};
+
+// 耐久等級(由 LogWriter 執行,開始記錄時決定):
+// - Buffered: 寫進 OS 即可(原行為),斷電可能遺失最後數秒
+// - Group: 自上次同步起累積到 groupMs 或 groupBytes 即 fdatasync 一次
+// - Line: 每筆紀錄寫出後立即同步(最慢,供關鍵測試)
+struct LogDurability {
+    enum Mode { Buffered, Group, Line };
+    Mode mode = Buffered;
+    qint64 groupMs = 1000;
+    qint64 groupBytes = 1 << 20;
+
+    // "buffered" | "group" | "line",其他視為 buffered
+    static Mode modeFromName(QStringView name)
+    {
+        if (name == QLatin1String("group"))
+            return Group;
+        if (name == QLatin1String("line"))
+            return Line;
+        return Buffered;
+    }
+};
+
+// LogWriter 的輸出端。
+// - 不輪替也不壓縮: 直接 append 到指定路徑(與舊行為相同)
+// - 否則寫成 segment: "<stem>.<NNNN><.ext>[.gz]",編號接續目錄中既有的最大值;
+//   輪替後依 diskBudget 由最舊的 segment 開始刪除(不刪目前這個,seq 索引 sidecar 一併刪)
+// - 壓縮: 每個 segment 一個 gzip stream(zlib deflate,字典跨寫入延續),在 writer thread 進行;
+//   flush() 時 Z_SYNC_FLUSH,已寫出的部分即可解壓(zcat 讀得到為止);輪替 / 關檔時結束 stream
+// - 開檔前先修復要接續的檔案(append 的檔 / 最新的未壓縮 segment): 截掉當機留下的半筆紀錄。
+//   只在既有檔的格式與要寫的內容相符時修復,且不截到格式檔頭以下;文字檔只截確定是
+//   自己留下的殘骸(半筆 JSONL / 檔尾 NUL),其他沒有換行結尾的內容保留,補換行後接續;
+//   認不出的既有檔(例: 對 binary 檔選了 text)不修也不 append,open() 失敗
+// open() 在 GUI thread 呼叫(失敗同步回報),之後只由 writer thread 使用;
+// diskBytes() / currentPath() 可跨 thread 讀取
+class LogSink
+{
+public:
+    // 要寫的內容: 決定既有檔怎麼修復、能不能接續
+    enum Content { Lines, Capture, Pcapng };
+    // recoverTail 的錯誤值
+    static constexpr qint64 CannotOpen = -1;
+    static constexpr qint64 NotThisFormat = -2;
+
+    LogSink(const QString &basePath, const LogRotation &rotation, Content content = Lines);
+    ~LogSink();
+
+    // open() 前的檢查,不動任何檔案: 目錄可寫、要 append 的既有檔可寫且格式相符
+    // (多個輸出檔先全部檢查過再開,後面的失敗不會留下已修復 / 新建的檔)
+    bool validate();
+    bool open();
+    void close();
+    // validate() / open() 失敗的原因
+    QString errorString() const { return m_error; }
+
+    // 目前 segment 開啟時是空檔(需要寫檔頭,例如 capture 的 file header)
+    bool isNewFile() const { return m_newFile; }
+    bool isCompressed() const { return m_rotation.compress; }
+    // 目前檔案的寫入位置(未壓縮時即檔案大小;seq 索引的 offset)
+    qint64 position() const { return m_currentBytes.load(); }
+
+    qint64 write(const char *data, qsizetype size);
+    // 提交點(writer 寫出全部 buffer 後): 壓縮時把 deflate 內部暫存的資料寫出
+    void flush();
+    // 把已寫出的資料落盤(fdatasync / FlushFileBuffers)
+    bool sync();
+    // pending: writer buffer 中尚未寫出的量
+    bool rotationDue(qint64 pending) const;
+    bool rotate();
+
+    qint64 diskBytes() const { return m_closedBytes.load() + m_currentBytes.load(); }
+    QString currentPath() const;
+    // open() 時修復截掉的 bytes
+    qint64 recoveredBytes() const { return m_recovered; }
+
+    // 截掉檔尾寫到一半的紀錄: capture / pcapng 依 block 結構,text / jsonl 見 lineTailEnd。
+    // 既有檔的開頭須與 content 相符;回傳截掉的 bytes(0 = 完整或不需修),
+    // CannotOpen = 無法開檔,NotThisFormat = 不是這種格式(不動檔案)
+    static qint64 recoverTail(const QString &path, Content content);
+    // --recover: 依檔頭判斷(capture / pcapng,其餘當作文字)
+    static Content detectContent(const QString &path);
+
+private:
+    QString segmentPath(int index) const;
+    QRegularExpression segmentPattern() const;
+    bool openSegment();
+    void prune();
+    void writeRaw(const char *data, qsizetype size);
+    void deflateChunk(const char *data, qsizetype size, int flush);
+    void finishStream();
+
+    const LogRotation m_rotation;
+    const Content m_content;
+    QString m_error;
+    QString m_basePath;
+    QString m_dir;
+    QString m_stem;
+    QString m_suffix;   // 含 '.',可能為空
+    int m_index = 0;
+
+    std::unique_ptr<QFile> m_file;
+    bool m_newFile = false;
+    qint64 m_segmentInput = 0;
+    QElapsedTimer m_segmentAge;
+    qint64 m_recovered = 0;
+    std::unique_ptr<z_stream_s> m_zstream;   // 壓縮中的 segment
+    QByteArray m_zbuf;
+    bool m_deflatePending = false;           // 上次 flush 後有新輸入
+
+    std::atomic<qint64> m_closedBytes { 0 };
+    std::atomic<qint64> m_currentBytes { 0 };
+    mutable QMutex m_pathMutex;
+    QString m_currentPath;
+};
+
+#endif // LOGSINK_H
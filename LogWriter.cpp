@@ -0,0 +1,543 @@
+#include "LogWriter.h"
+#include <QDateTime>
+#include <cstring>
+#include "TerminalEntry.h"
+#include "version.h"
+
+// 原本以 QIODevice::Text 開檔(Windows 會轉 CRLF);改成 binary 寫入後自行輸出平台換行
+#ifdef Q_OS_WIN
+static const QLatin1String kNewline("\r\n");
+#else
+static const QLatin1String kNewline("\n");
+#endif
+
+LogWriter::LogWriter(const LogDurability &durability, QObject *parent)
+    : QThread(parent)
+    , m_durability(durability)
+    , m_queue(QueueCapacity)
+{
+    setObjectName(QStringLiteral("LogWriter"));
+}
+
+LogWriter::~LogWriter()
+{
+    if (isRunning())
+        finish(QDateTime::currentMSecsSinceEpoch());
+}
+
+void LogWriter::addOutput(LogSink *sink, Format format, const FilterQuery &filter)
+{
+    auto out = std::make_unique<Output>();
+    out->sink.reset(sink);
+    out->format = format;
+    if (!filter.isEmpty()) {
+        // 相同 query 的輸出共用同一個 filter 結果
+        for (int i = 0; i < m_filters.size() && out->filter < 0; ++i) {
+            if (m_filters.at(i).source() == filter.source())
+                out->filter = i;
+        }
+        if (out->filter < 0) {
+            out->filter = int(m_filters.size());
+            m_filters.append(filter);
+        }
+    }
+    m_outputs.push_back(std::move(out));
+    m_filterHits.resize(m_filters.size());
+}
+
+qint64 LogWriter::diskBytes() const
+{
+    qint64 total = 0;
+    for (const auto &out : m_outputs)
+        total += out->sink->diskBytes();
+    return total;
+}
+
+void LogWriter::wakeWriter()
+{
+    if (m_idle.load()) {
+        QMutexLocker locker(&m_wakeMutex);
+        m_wake.wakeOne();
+    }
+}
+
+void LogWriter::enqueue(LogRecord &&record)
+{
+    // spill 有東西時新紀錄排在它後面,順序不變
+    if ((m_spill.empty() || drainSpill() == 0) && m_queue.push(std::move(record))) {
+        wakeWriter();
+        return;
+    }
+    if (m_blockWhenFull) {
+        ++m_stalls;
+        pushBlocking(std::move(record));
+        return;
+    }
+    // 磁碟跟不上: GUI thread 不等,先暫存;spill 也滿了才丟
+    if (m_spill.size() >= SpillLimit) {
+        ++m_dropped;
+        return;
+    }
+    if (m_spill.empty())
+        ++m_stalls;
+    m_spill.push_back(std::move(record));
+    wakeWriter();
+}
+
+size_t LogWriter::drainSpill()
+{
+    bool moved = false;
+    while (!m_spill.empty() && m_queue.push(std::move(m_spill.front()))) {
+        m_spill.pop_front();
+        moved = true;
+    }
+    if (moved)
+        wakeWriter();
+    return m_spill.size();
+}
+
+// 在 m_space 上等 writer 取出紀錄,不丟資料也不空轉。
+// 旗標與等待都在 m_wakeMutex 內,writer 的喚醒不會漏;每次等待仍有上限
+void LogWriter::pushBlocking(LogRecord &&record)
+{
+    QElapsedTimer stalled;
+    stalled.start();
+    QMutexLocker locker(&m_wakeMutex);
+    if (m_queue.push(std::move(record))) {
+        m_wake.wakeOne();
+        return;
+    }
+    m_producerWaiting.store(true);
+    m_wake.wakeOne();
+    while (!m_queue.push(std::move(record)))
+        m_space.wait(&m_wakeMutex, SpaceWaitMs);
+    m_producerWaiting.store(false);
+    m_wake.wakeOne();
+    m_stallNs += stalled.nsecsElapsed();
+}
+
+void LogWriter::finish(qint64 wallMs)
+{
+    while (!m_spill.empty()) {
+        pushBlocking(std::move(m_spill.front()));
+        m_spill.pop_front();
+    }
+    LogRecord stop;
+    stop.kind = LogRecord::SessionStop;
+    stop.wallMs = wallMs;
+    pushBlocking(std::move(stop));
+    wait();
+}
+
+void LogWriter::run()
+{
+    for (const auto &out : m_outputs) {
+        out->buffer.resize(BufferSize);
+        out->sinceWrite.start();
+    }
+
+    LogRecord record;
+    for (;;) {
+        while (m_queue.pop(record)) {
+            if (m_producerWaiting.load()) {
+                QMutexLocker locker(&m_wakeMutex);
+                m_space.wakeOne();
+            }
+            format(record);
+            if (record.kind == LogRecord::SessionStop) {
+                for (const auto &out : m_outputs) {
+                    commit(*out);
+                    out->sink->close();
+                    out->index.close();
+                }
+                return;
+            }
+            for (const auto &out : m_outputs) {
+                if (out->sink->rotationDue(out->used + out->block.payloadSize()))
+                    rotateSegment(*out);
+                if (commitDue(*out))
+                    commit(*out);
+            }
+        }
+
+        int waitMs = IdleFlushMs;
+        for (const auto &out : m_outputs) {
+            if ((out->used > 0 || !out->block.isEmpty()) && out->sinceWrite.elapsed() >= IdleFlushMs) {
+                sealBlock(*out);
+                writeOut(*out, true);
+            }
+            if (out->sink->rotationDue(0))
+                rotateSegment(*out);   // 依時間輪替: 沒有新資料時也要切
+            if (commitDue(*out))
+                commit(*out);          // group 的時間上限: 沒有新資料時也要同步
+
+            // group 有未同步的紀錄時,等待不超過剩餘的時間上限
+            if (m_durability.mode == LogDurability::Group && out->unsynced.isValid()) {
+                waitMs = qMin(waitMs, int(qBound<qint64>(1, m_durability.groupMs - out->unsynced.elapsed(),
+                                                         IdleFlushMs)));
+            }
+        }
+
+        // 先標記 idle 再檢查佇列: producer 在這之後入列必定看到 idle 並 wake
+        QMutexLocker locker(&m_wakeMutex);
+        m_idle.store(true);
+        if (m_queue.size() == 0)
+            m_wake.wait(&m_wakeMutex, waitMs);
+        m_idle.store(false);
+    }
+}
+
+void LogWriter::format(const LogRecord &record)
+{
+    m_encoded = 0;
+    m_filterHits.fill(-1);
+    if (record.kind == LogRecord::SessionStart) {
+        m_ports = record.text.split(QLatin1Char('\n'));
+        m_rxComments.clear();
+        m_txComments.clear();
+        for (const QString &port : std::as_const(m_ports)) {
+            m_rxComments.append(Pcapng::packetComment(CaptureFormat::Rx, port));
+            m_txComments.append(Pcapng::packetComment(CaptureFormat::Tx, port));
+        }
+    }
+
+    for (const auto &out : m_outputs) {
+        switch (out->format) {
+        case Capture:
+            formatCapture(*out, record);
+            break;
+        case Pcapng:
+            formatPcapng(*out, record);
+            break;
+        case Text:
+        case Jsonl:
+            formatLines(*out, record);
+            break;
+        }
+    }
+}
+
+// 同一筆對同一個 filter 只求值一次
+bool LogWriter::passes(const Output &out, const LogRecord &record)
+{
+    if (out.filter < 0)
+        return true;
+    qint8 &hit = m_filterHits[out.filter];
+    if (hit < 0)
+        hit = m_filters.at(out.filter).matches(record.type, record.timestamp, record.text, record.hex) ? 1 : 0;
+    return hit == 1;
+}
+
+void LogWriter::encode(QStringView text)
+{
+    const qsizetype used = m_line.size();
+    m_line.resize(used + m_encoder.requiredSpace(text.size()));
+    char *end = m_encoder.appendToBuffer(m_line.data() + used, text);
+    m_line.resize(end - m_line.constData());   // 縮回不釋放容量
+}
+
+// text 行(Line 也用於 jsonl 檔: 原樣寫入)
+const QByteArray &LogWriter::textLine(const LogRecord &record)
+{
+    if (m_encoded & HaveText)
+        return m_line;
+    m_encoded |= HaveText;
+    m_line.resize(0);
+
+    switch (record.kind) {
+    case LogRecord::SessionStart:
+    case LogRecord::SessionStop: {
+        const bool start = record.kind == LogRecord::SessionStart;
+        const QDateTime when = QDateTime::fromMSecsSinceEpoch(record.wallMs);
+        encode(start ? QStringLiteral("=== UART PRO Log Session — ")
+                     : QStringLiteral("=== Session ended — "));
+        encode(when.toString(QStringLiteral("yyyy-MM-dd HH:mm:ss")));
+        m_line.append(" ===");
+        m_line.append(kNewline.data(), kNewline.size());
+        if (!start)
+            m_line.append(kNewline.data(), kNewline.size());
+        return m_line;
+    }
+    case LogRecord::Line:
+        encode(record.text);
+        m_line.append(kNewline.data(), kNewline.size());
+        return m_line;
+    case LogRecord::Entry:
+    case LogRecord::Chunk:
+        break;
+    }
+
+    // text: "[ts] PREFIX> data",版面依入列當下的顯示偏好;多 port 時 prefix 前加 port 名稱
+    if (record.layout & LogRecord::TextTimestamp) {
+        m_line.append('[');
+        if (record.layout & LogRecord::TextIsoTimestamp) {
+            char iso[IsoTimestamp::Length];
+            m_isoTs.format(record.wallMs, iso);
+            m_line.append(iso, IsoTimestamp::Length);
+        } else {
+            encode(record.timestamp);
+        }
+        m_line.append("] ");
+    }
+    if (m_ports.size() > 1 && record.port < m_ports.size()) {
+        encode(m_ports.at(record.port));
+        m_line.append(' ');
+    }
+    if (record.layout & LogRecord::TextPrefix) {
+        const QLatin1String prefix = terminalPrefix(record.type);
+        m_line.append(prefix.data(), prefix.size());
+    }
+    const bool hex = (record.layout & LogRecord::TextHex) && !record.hex.isEmpty();
+    encode(hex ? record.hex : record.text);
+    m_line.append(kNewline.data(), kNewline.size());
+    return m_line;
+}
+
+// JSONL 一筆: {"ts":ISO8601含毫秒,"seq":N,["port":...,]"type":...,"ascii":...,"hex":...}
+// seq 依檔案而異,共用的部分在 ts 之後切開(m_jsonSplit)
+// 在 jsonl 模式下 session 標頭/結尾也是 JSONL 事件列,維持整檔可逐行解析
+const QByteArray &LogWriter::jsonLine(const LogRecord &record)
+{
+    if (m_encoded & HaveJson)
+        return m_json.data();
+    m_encoded |= HaveJson;
+
+    m_json.clear();
+    m_json.begin();
+    m_json.timestampField("ts", record.wallMs);
+    if (record.kind == LogRecord::Entry) {
+        m_jsonSplit = m_json.data().size();
+        if (m_ports.size() > 1 && record.port < m_ports.size())
+            m_json.field("port", m_ports.at(record.port));
+        m_json.field("type", record.type);
+        m_json.field("ascii", record.text);
+        if (!record.hex.isEmpty())
+            m_json.field("hex", record.hex);
+    } else {
+        const bool start = record.kind == LogRecord::SessionStart;
+        m_jsonSplit = -1;
+        m_json.field("type", QLatin1String("session"));
+        m_json.field("event", start ? QLatin1String("start") : QLatin1String("stop"));
+        m_json.field("app", QStringLiteral(APP_NAME));
+        m_json.field("version", QStringLiteral(APP_VERSION_STR));
+    }
+    m_json.end(kNewline);
+    return m_json.data();
+}
+
+void LogWriter::formatLines(Output &out, const LogRecord &record)
+{
+    switch (record.kind) {
+    case LogRecord::Chunk:
+        return;   // 原始 chunk 只進 capture / pcapng
+    case LogRecord::SessionStart:
+        if (out.format == Jsonl)
+            openIndex(out, true);
+        break;
+    case LogRecord::Entry:
+    case LogRecord::Line:
+        if (!passes(out, record))
+            return;
+        break;
+    case LogRecord::SessionStop:
+        break;
+    }
+
+    if (out.format != Jsonl || record.kind == LogRecord::Line) {
+        append(out, textLine(record));
+        return;
+    }
+
+    const QByteArray &json = jsonLine(record);
+    if (m_jsonSplit < 0) {
+        append(out, json);
+        return;
+    }
+    // checkpoint 的 offset = 已交給 sink 的量 + buffer 內的位置(之後 writeOut 搬移也不變)
+    if (out.index.isOpen() && out.index.wants(out.seq))
+        out.index.add(out.seq, record.wallMs, out.sink->position() + out.used);
+    char seq[32] = ",\"seq\":";
+    const qsizetype n = 7 + qsnprintf(seq + 7, sizeof(seq) - 7, "%lld", out.seq++);
+    append(out, json.constData(), m_jsonSplit);
+    append(out, seq, n);
+    append(out, json.constData() + m_jsonSplit, json.size() - m_jsonSplit);
+}
+
+void LogWriter::formatCapture(Output &out, const LogRecord &record)
+{
+    using namespace CaptureFormat;
+
+    switch (record.kind) {
+    case LogRecord::SessionStart:
+        // 新檔才寫 file header;append 到既有 capture 時直接接 block
+        if (out.sink->isNewFile() && out.used == 0)
+            append(out, fileHeader());
+        out.block.add(Marker, record.wallMs * 1000000, QByteArrayLiteral("start"));
+        break;
+    case LogRecord::SessionStop:
+        out.block.add(Marker, record.wallMs * 1000000, QByteArrayLiteral("stop"));
+        break;
+    case LogRecord::Chunk:
+        out.block.add(Direction(record.direction), record.tsNs, record.bytes, record.frameIndex);
+        break;
+    case LogRecord::Entry:
+    case LogRecord::Line:
+        return;   // 切好的行可由 --convert 從 chunk 重建
+    }
+
+    if (!out.unsynced.isValid())
+        out.unsynced.start();
+    if (out.block.payloadSize() >= MaxBlockPayload)
+        sealBlock(out);
+}
+
+void LogWriter::formatPcapng(Output &out, const LogRecord &record)
+{
+    switch (record.kind) {
+    case LogRecord::SessionStart:
+        beginPcapngSection(out);
+        break;
+    case LogRecord::Chunk:
+        if (record.direction != CaptureFormat::Rx && record.direction != CaptureFormat::Tx)
+            return;
+        if (!(m_encoded & HavePacket)) {
+            m_encoded |= HavePacket;
+            const int port = record.port < m_ports.size() ? record.port : 0;
+            Pcapng::encodePacket(m_packet, record.tsNs, record.direction, record.bytes,
+                                 record.direction == CaptureFormat::Tx ? m_txComments.at(port)
+                                                                       : m_rxComments.at(port),
+                                 quint32(port));
+        }
+        append(out, m_packet);
+        break;
+    case LogRecord::SessionStop:
+    case LogRecord::Entry:
+    case LogRecord::Line:
+        return;   // 切好的行 / session 結尾在 pcapng 沒有對應的 block
+    }
+}
+
+// 每個 session / segment 一個 section: append 到既有檔或輪替後都能獨立開啟
+void LogWriter::beginPcapngSection(Output &out)
+{
+    append(out, Pcapng::sectionHeader());
+    for (const QString &port : std::as_const(m_ports))
+        append(out, Pcapng::interfaceBlock(port));
+}
+
+void LogWriter::rotateSegment(Output &out)
+{
+    // 先把目前 segment 的內容完整寫出(並依耐久等級同步),新 segment 從完整的紀錄開始
+    commit(out);
+    out.sink->rotate();
+    if (out.format == Capture)
+        append(out, CaptureFormat::fileHeader());
+    else if (out.format == Pcapng)
+        beginPcapngSection(out);
+    else if (out.format == Jsonl)
+        openIndex(out, false);   // seq 跨 segment 接續
+}
+
+// gzip segment 無法 seek,不建索引
+void LogWriter::openIndex(Output &out, bool resumeSeq)
+{
+    out.index.close();
+    if (out.sink->isCompressed())
+        return;
+    const qint64 next = out.index.open(out.sink->currentPath(), out.sink->position());
+    if (resumeSeq && next > 0)
+        out.seq = next;
+}
+
+bool LogWriter::commitDue(const Output &out) const
+{
+    if (!out.unsynced.isValid())
+        return false;
+    switch (m_durability.mode) {
+    case LogDurability::Line:
+        return true;
+    case LogDurability::Group:
+        return out.unsynced.elapsed() >= m_durability.groupMs
+            || out.written - out.syncedBytes + out.used + out.block.payloadSize() >= m_durability.groupBytes;
+    case LogDurability::Buffered:
+        break;
+    }
+    return false;
+}
+
+// 封 block、寫出全部;Buffered 以外再落盤
+void LogWriter::commit(Output &out)
+{
+    sealBlock(out);
+    writeOut(out, true);
+    if (m_durability.mode == LogDurability::Buffered)
+        return;
+
+    QElapsedTimer t;
+    t.start();
+    out.sink->sync();
+    recordLatency(t.nsecsElapsed());
+    out.unsynced.invalidate();
+    out.syncedBytes = out.written;
+}
+
+void LogWriter::recordLatency(qint64 ns)
+{
+    m_syncCount.fetch_add(1, std::memory_order_relaxed);
+    m_syncNsTotal.fetch_add(ns, std::memory_order_relaxed);
+    if (ns > m_syncNsMax.load(std::memory_order_relaxed))
+        m_syncNsMax.store(ns, std::memory_order_relaxed);   // 只有 writer thread 寫入
+}
+
+void LogWriter::sealBlock(Output &out)
+{
+    if (!out.block.isEmpty())
+        append(out, out.block.seal());
+}
+
+void LogWriter::append(Output &out, const char *data, qsizetype size)
+{
+    if (out.used + size > out.buffer.size()) {
+        writeOut(out, false);
+        if (out.used + size > out.buffer.size())
+            writeOut(out, true);
+        if (size > out.buffer.size())
+            out.buffer.resize(size);   // 單行超過 buffer(極少見)
+    }
+    memcpy(out.buffer.data() + out.used, data, size_t(size));
+    out.used += size;
+    if (!out.unsynced.isValid())
+        out.unsynced.start();
+}
+
+void LogWriter::writeOut(Output &out, bool all)
+{
+    // 一般情況只寫 64 KiB 的整數倍,零頭搬到 buffer 前端等下一批;
+    // all = 提交點(commit / idle / 輪替 / 關檔),壓縮時也把 deflate 暫存的資料寫出
+    const qsizetype n = all ? out.used : (out.used / WriteBlock) * WriteBlock;
+    if (n <= 0) {
+        if (all)
+            out.sink->flush();
+        return;
+    }
+
+    if (m_durability.mode == LogDurability::Buffered) {
+        QElapsedTimer t;
+        t.start();
+        out.sink->write(out.buffer.constData(), n);
+        recordLatency(t.nsecsElapsed());
+    } else {
+        out.sink->write(out.buffer.constData(), n);
+    }
+    if (all)
+        out.sink->flush();
+    out.written += n;
+    m_bytesWritten.fetch_add(n, std::memory_order_relaxed);
+    if (out.index.isOpen())
+        out.index.flush(out.sink->position());
+
+    out.used -= n;
+    if (out.used > 0)
+        memmove(out.buffer.data(), out.buffer.constData() + n, size_t(out.used));
+    out.sinceWrite.restart();
+}
@@ -0,0 +1,231 @@
+#ifndef LOGWRITER_H
+#define LOGWRITER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QStringEncoder>
+#include <QThread>
+#include <QWaitCondition>
+#include <QVector>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "CaptureFormat.h"
+#include "FilterQuery.h"
+#include "JsonlWriter.h"
+#include "LogIndex.h"
+#include "LogSink.h"
+#include "PcapngFormat.h"
+
+// 入列的原始紀錄: GUI thread 只搬 QString(隱式共用,不複製內容),格式化 / 編碼在 writer thread
+struct LogRecord {
+    enum Kind : quint8 { Entry, Line, Chunk, SessionStart, SessionStop };
+    // TextIsoTimestamp: text 行的時間改用 wallMs 的 ISO 日期時間(headless: 跨日 log 可排序)
+    enum LayoutFlag : quint8 { TextTimestamp = 0x1, TextPrefix = 0x2, TextHex = 0x4, TextIsoTimestamp = 0x8 };
+
+    Kind kind = Line;
+    quint8 layout = 0;     // text 格式的版面(入列當下的 UI 偏好)
+    qint64 wallMs = 0;     // 入列時間(jsonl ts / session 標頭)
+    QString timestamp;     // 顯示用 "HH:mm:ss.zzz"(text 行、filter 的 time:)
+    QString type;
+    QString text;          // Entry: ascii;Line: 整行;SessionStart: port 名稱(多 port 以 '\n' 分隔)
+    QString hex;
+    // Chunk(capture): 切行前的原始 bytes
+    QByteArray bytes;
+    qint64 tsNs = 0;           // epoch ns
+    qint64 frameIndex = -1;    // chunk 到達前已切出的 RX 行數,-1 = 無
+    quint8 direction = 0;      // CaptureFormat::Direction
+    quint16 port = 0;          // Entry / Chunk: SessionStart 的 port 清單 index
+};
+
+// 單一 producer / 單一 consumer 的固定容量 ring(容量為 2 的次方)。
+// head 只由 producer 寫、tail 只由 consumer 寫,兩者分在不同 cache line
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(size_t capacityPow2)
+        : m_mask(capacityPow2 - 1)
+        , m_slots(new T[capacityPow2])
+    {
+    }
+
+    bool push(T &&value)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) > m_mask)
+            return false;
+        m_slots[head & m_mask] = std::move(value);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &out)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire))
+            return false;
+        // move 走之後 slot 留空字串,不讓已寫出的資料滯留在 ring 內
+        out = std::move(m_slots[tail & m_mask]);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const
+    {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+private:
+    const size_t m_mask;
+    std::unique_ptr<T[]> m_slots;
+    alignas(64) std::atomic<size_t> m_head { 0 };
+    alignas(64) std::atomic<size_t> m_tail { 0 };
+};
+
+// FileLogger 的 writer thread: 從 SpscQueue 取紀錄,編碼成 UTF-8 進各輸出的 1 MiB buffer,
+// 滿了以 64 KiB 整數倍一次寫出(餘數留到下次);佇列空下來超過 100ms 才寫出零頭。
+// 輸出端(LogSink)由 GUI thread 開好後交給 writer 持有,finish() 寫完 session 結尾並關檔;
+// 輪替只發生在紀錄邊界(capture block 不會跨 segment)。
+// 耐久等級(LogDurability)決定何時 sync: Group 依時間 / 量聚合成一次 fdatasync,Line 每筆一次;
+// 延遲統計在 Buffered 時量 write(),其他量 sync。
+//
+// 多個輸出(sink router): 紀錄只入列一次,每筆在 writer thread 上
+// - 依輸出的 filter 過濾 Entry / Line;相同 query 的輸出共用一個 filter,每筆只求值一次
+// - 同一筆的編碼結果(text 行、JSONL 行、pcapng EPB)只做一次,各輸出只多一次 memcpy;
+//   JSONL 的 seq 每個檔各自遞增,插在共用的 ts 與其餘欄位之間
+// Capture 格式只收 Chunk / session 紀錄,累積成 CaptureFormat block 再進 buffer;
+// Pcapng 同樣只收 Chunk,每筆直接編成一個 EPB。
+// 多 port(headless): 紀錄依到達順序合併在同一個檔,text / jsonl 行標上 port,pcapng 每個 port 一個 interface。
+// Jsonl 另寫 seq 稀疏索引(LogIndex.h),append 到既有檔時 seq 接續檔內最大值
+class LogWriter : public QThread
+{
+public:
+    enum Format { Text, Jsonl, Capture, Pcapng };
+
+    explicit LogWriter(const LogDurability &durability = LogDurability(), QObject *parent = nullptr);
+    ~LogWriter() override;
+
+    // start() 之前加入;writer 接手 sink。filter 只套用在 Entry / Line(chunk 與 session 紀錄全收)
+    void addOutput(LogSink *sink, Format format, const FilterQuery &filter = FilterQuery());
+    int outputCount() const { return int(m_outputs.size()); }
+    const LogSink *sink(int index = 0) const { return m_outputs[size_t(index)]->sink.get(); }
+    // 所有輸出的磁碟總量
+    qint64 diskBytes() const;
+
+    // 佇列滿時: 預設先溢出到 producer 端的 spill(依序補進佇列,GUI thread 不會被擋住),
+    // spill 也滿了才丟棄並計數;blockWhenFull(headless)改為阻塞等 writer 騰出空間,不丟資料。
+    // start() 之前設定
+    void setBlockWhenFull(bool block) { m_blockWhenFull = block; }
+
+    // producer 端
+    void enqueue(LogRecord &&record);
+    // 把 spill 依序補進佇列(producer 定期呼叫,新紀錄入列時也會先補);回傳剩下的筆數
+    size_t drainSpill();
+    // 排入 session 結尾(時戳 wallMs,與其他紀錄同一時鐘)、等 writer 清空佇列並關檔。
+    // spill 與結尾一定寫入(此時可阻塞)
+    void finish(qint64 wallMs);
+
+    size_t queueDepth() const { return m_queue.size(); }
+    size_t spillDepth() const { return m_spill.size(); }
+    // spill 滿而丟掉的紀錄數(producer thread 讀取)
+    quint64 droppedRecords() const { return m_dropped; }
+    // 交給 sink 的量(壓縮前,所有輸出合計)
+    qint64 bytesWritten() const { return m_bytesWritten.load(std::memory_order_relaxed); }
+    // 佇列滿的次數(每次溢出 / 阻塞算一次)/ blockWhenFull 的累計阻塞時間(producer thread 讀取)
+    quint64 producerStalls() const { return m_stalls; }
+    qint64 producerStallNs() const { return m_stallNs; }
+    // 寫入 / 同步延遲(ns 累計與最大值,見上方說明)
+    quint64 syncCount() const { return m_syncCount.load(std::memory_order_relaxed); }
+    qint64 syncNsTotal() const { return m_syncNsTotal.load(std::memory_order_relaxed); }
+    qint64 syncNsMax() const { return m_syncNsMax.load(std::memory_order_relaxed); }
+
+protected:
+    void run() override;
+
+private:
+    // 一個輸出檔的狀態(除 sink 的跨 thread 讀取外只在 writer thread 使用)
+    struct Output {
+        std::unique_ptr<LogSink> sink;
+        Format format = Text;
+        int filter = -1;           // m_filters 的 index,-1 = 全收
+        QByteArray buffer;
+        qsizetype used = 0;
+        QElapsedTimer sinceWrite;
+        QElapsedTimer unsynced;    // 上次同步後第一筆紀錄起算;invalid = 沒有未同步的紀錄
+        qint64 written = 0;
+        qint64 syncedBytes = 0;
+        CaptureFormat::BlockEncoder block;
+        LogIndex::Writer index;
+        qint64 seq = 0;
+    };
+    // 目前這筆紀錄已做過的共用編碼
+    enum Encoded : quint8 { HaveText = 0x1, HaveJson = 0x2, HavePacket = 0x4 };
+
+    void format(const LogRecord &record);
+    bool passes(const Output &out, const LogRecord &record);
+    const QByteArray &textLine(const LogRecord &record);
+    const QByteArray &jsonLine(const LogRecord &record);
+    void encode(QStringView text);
+    void formatLines(Output &out, const LogRecord &record);
+    void formatCapture(Output &out, const LogRecord &record);
+    void formatPcapng(Output &out, const LogRecord &record);
+    void beginPcapngSection(Output &out);
+    void openIndex(Output &out, bool resumeSeq);
+    void sealBlock(Output &out);
+    void rotateSegment(Output &out);
+    bool commitDue(const Output &out) const;
+    void commit(Output &out);
+    void recordLatency(qint64 ns);
+    void append(Output &out, const char *data, qsizetype size);
+    void append(Output &out, const QByteArray &bytes) { append(out, bytes.constData(), bytes.size()); }
+    void writeOut(Output &out, bool all);
+    void pushBlocking(LogRecord &&record);
+    void wakeWriter();
+
+    static constexpr size_t QueueCapacity = 1 << 16;
+    static constexpr qsizetype BufferSize = 1 << 20;
+    static constexpr qsizetype WriteBlock = 64 * 1024;
+    static constexpr int IdleFlushMs = 100;
+    static constexpr int SpaceWaitMs = 10;   // producer 每次等待的上限
+    static constexpr size_t SpillLimit = 1 << 17;
+
+    std::vector<std::unique_ptr<Output>> m_outputs;
+    QList<FilterQuery> m_filters;   // 依 query 去重
+    const LogDurability m_durability;
+    SpscQueue<LogRecord> m_queue;
+    QMutex m_wakeMutex;
+    QWaitCondition m_wake;
+    QWaitCondition m_space;                       // writer → 等待空間的 producer
+    std::atomic<bool> m_idle { false };
+    std::atomic<bool> m_producerWaiting { false };
+    std::atomic<qint64> m_bytesWritten { 0 };
+    // 以下只在 producer thread 使用
+    bool m_blockWhenFull = false;
+    std::deque<LogRecord> m_spill;   // 佇列滿時依序暫存,先於之後的紀錄入列
+    quint64 m_stalls = 0;
+    qint64 m_stallNs = 0;
+    quint64 m_dropped = 0;
+    std::atomic<quint64> m_syncCount { 0 };
+    std::atomic<qint64> m_syncNsTotal { 0 };
+    std::atomic<qint64> m_syncNsMax { 0 };
+
+    // 以下只在 writer thread 使用: 每筆紀錄的共用編碼與 filter 結果
+    quint8 m_encoded = 0;
+    QVector<qint8> m_filterHits;   // -1 = 尚未求值
+    QStringEncoder m_encoder { QStringConverter::Utf8 };
+    IsoTimestamp m_isoTs;
+    QByteArray m_line;             // text 行(含換行)
+    JsonlWriter m_json;
+    qsizetype m_jsonSplit = -1;    // Entry: ts 欄位結尾(seq 插入點);-1 = 不帶 seq
+    QByteArray m_packet;
+    QStringList m_ports;           // session 的 port(輪替出的 segment 重寫 pcapng section 時用)
+    QList<QByteArray> m_rxComments;   // Pcapng: 依 port index
+    QList<QByteArray> m_txComments;
+};
+
+#endif // LOGWRITER_H
@@ -0,0 +1,982 @@
+#include "MappedLogModel.h"
+#include <QClipboard>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QRegularExpression>
+#include <QThread>
+#include <QUrl>
+#include <QWaitCondition>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include "CaptureFormat.h"
+#include "JsonlWriter.h"
+#include "LineSplitter.h"
+
+static const qint64 MAX_ROW_BYTES = 64 * 1024;   // text / jsonl 沒有換行時的強制切列
+static const int BUCKET_CACHE_LIMIT = 32;        // 解碼過的 bucket 上限(~32K 列,約數個畫面的來回捲動)
+static const int RUN_CACHE_LIMIT = 4096;
+static const int SLICE_MS = 20;                  // worker 每個工作輪流跑的時間片
+static const int PUBLISH_INTERVAL_MS = 100;      // 索引 / filter 結果送回 GUI 的間隔
+
+static MappedLogCheckpoint firstCheckpoint(const MappedLogSource &source)
+{
+    MappedLogCheckpoint cp;
+    cp.offset = source.format == MappedLogSource::Capture ? CaptureFormat::FileHeaderSize : 0;
+    return cp;
+}
+
+// 從 checkpoint 起循序解出列。text / jsonl 一行一列;capture 依 --convert 的規則
+// (LineSplitter + 50ms idle flush 重現)切行,與當時畫面 / 轉出的檔案一致
+class MappedLogScanner
+{
+public:
+    explicit MappedLogScanner(const MappedLogSource &source)
+        : m_source(source)
+        , m_reader(source.data, source.size)
+    {
+    }
+
+    void seek(const MappedLogCheckpoint &cp);
+    // out == nullptr: 只前進不組字串(建索引用)
+    bool next(TerminalEntry *out);
+    qint64 row() const { return m_row; }
+    // capture 的一筆 record 可能切出多列: 整筆取完才能存 checkpoint
+    bool atBoundary() const { return m_readyPos >= m_ready.size(); }
+    MappedLogCheckpoint checkpoint() const;
+    qint64 position() const;
+
+private:
+    struct CaptureRow {
+        QString type;
+        qint64 tsNs;
+        QByteArray bytes;   // system 列: marker 內容
+    };
+
+    bool nextLine(TerminalEntry *out);
+    bool nextCapture(TerminalEntry *out);
+    void parseText(QByteArrayView line, TerminalEntry &out) const;
+    void parseJsonl(QByteArrayView line, TerminalEntry &out) const;
+    void fillCapture(const CaptureRow &row, TerminalEntry &out);
+
+    MappedLogSource m_source;
+    qint64 m_pos = 0;
+    qint64 m_row = 0;
+    CaptureFormat::MemoryReader m_reader;
+    LineSplitter m_splitter;
+    qint64 m_lastRxTs = -1;
+    QList<CaptureRow> m_ready;
+    qsizetype m_readyPos = 0;
+    IsoTimestamp m_iso;
+};
+
+void MappedLogScanner::seek(const MappedLogCheckpoint &cp)
+{
+    m_pos = cp.offset;
+    m_row = cp.firstRow;
+    m_ready.clear();
+    m_readyPos = 0;
+    if (m_source.format != MappedLogSource::Capture)
+        return;
+    m_reader.seek(cp.offset, cp.record);
+    m_lastRxTs = cp.lastRxTs;
+    m_splitter.clear();
+    // 殘留不含完整行,feed 回去不會切出列
+    m_splitter.feed(cp.pending, [](const QByteArray &) {});
+}
+
+MappedLogCheckpoint MappedLogScanner::checkpoint() const
+{
+    MappedLogCheckpoint cp;
+    cp.firstRow = m_row;
+    if (m_source.format != MappedLogSource::Capture) {
+        cp.offset = m_pos;
+        return cp;
+    }
+    cp.offset = m_reader.blockOffset();
+    cp.record = m_reader.recordIndex();
+    cp.lastRxTs = m_lastRxTs;
+    cp.pending = m_splitter.pendingBytes();
+    return cp;
+}
+
+qint64 MappedLogScanner::position() const
+{
+    return m_source.format == MappedLogSource::Capture ? m_reader.position() : m_pos;
+}
+
+bool MappedLogScanner::next(TerminalEntry *out)
+{
+    const bool ok = m_source.format == MappedLogSource::Capture ? nextCapture(out) : nextLine(out);
+    if (!ok)
+        return false;
+    if (out)
+        out->entryIndex = int(m_row);
+    ++m_row;
+    return true;
+}
+
+bool MappedLogScanner::nextLine(TerminalEntry *out)
+{
+    while (m_pos < m_source.size) {
+        const char *start = m_source.data + m_pos;
+        const qint64 limit = qMin(m_source.size - m_pos, MAX_ROW_BYTES);
+        const char *nl = static_cast<const char *>(memchr(start, '\n', size_t(limit)));
+        qint64 length = nl ? nl - start : limit;
+        m_pos += nl ? length + 1 : length;
+        if (length > 0 && start[length - 1] == '\r')
+            --length;
+        if (length == 0)
+            continue;   // 空行(session 結尾的分隔)不成列
+        if (out) {
+            const QByteArrayView line(start, length);
+            if (m_source.format == MappedLogSource::Jsonl)
+                parseJsonl(line, *out);
+            else
+                parseText(line, *out);
+        }
+        return true;
+    }
+    return false;
+}
+
+void MappedLogScanner::parseText(QByteArrayView line, TerminalEntry &out) const
+{
+    // "[ts] PREFIX> data"(ts / prefix 依寫入當時的版面可有可無)
+    static const struct { QLatin1String prefix; QLatin1String type; } prefixes[] = {
+        { QLatin1String("RX> "),  QLatin1String("rx") },
+        { QLatin1String("TX> "),  QLatin1String("tx") },
+        { QLatin1String("SYS> "), QLatin1String("system") },
+        { QLatin1String("ERR> "), QLatin1String("error") },
+    };
+
+    const QString text = QString::fromUtf8(line);
+    out.timestamp.clear();
+    out.hexData.clear();
+    if (text.startsWith(QLatin1String("==="))) {
+        out.type = QStringLiteral("system");
+        out.msgText = text;
+        return;
+    }
+
+    QStringView rest(text);
+    if (rest.startsWith(QLatin1Char('['))) {
+        const qsizetype close = rest.indexOf(QLatin1String("] "));
+        if (close > 0) {
+            const QStringView ts = rest.mid(1, close - 1);
+            const qsizetype t = ts.indexOf(QLatin1Char('T'));
+            out.timestamp = (t >= 0 ? ts.mid(t + 1) : ts).toString();
+            rest = rest.mid(close + 2);
+        }
+    }
+    out.type = QStringLiteral("rx");
+    for (const auto &p : prefixes) {
+        if (rest.startsWith(p.prefix)) {
+            out.type = p.type;
+            rest = rest.mid(p.prefix.size());
+            break;
+        }
+    }
+    // FileLogger::logEntry 的 "  |HEX: " 附加欄
+    const qsizetype hex = rest.indexOf(QLatin1String("  |HEX: "));
+    if (hex >= 0) {
+        out.hexData = rest.mid(hex + 8).toString();
+        rest = rest.left(hex);
+    }
+    out.msgText = rest.toString();
+}
+
+void MappedLogScanner::parseJsonl(QByteArrayView line, TerminalEntry &out) const
+{
+    const QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromRawData(line.data(), line.size()));
+    out.hexData.clear();
+    if (!doc.isObject()) {
+        out.timestamp.clear();
+        out.type = QStringLiteral("error");
+        out.msgText = QString::fromUtf8(line);
+        return;
+    }
+
+    const QJsonObject o = doc.object();
+    const QString ts = o.value(QLatin1String("ts")).toString();
+    const qsizetype t = ts.indexOf(QLatin1Char('T'));
+    out.timestamp = t >= 0 ? ts.mid(t + 1) : ts;
+
+    const QString type = o.value(QLatin1String("type")).toString();
+    if (type == QLatin1String("rx") || type == QLatin1String("tx")
+        || type == QLatin1String("system") || type == QLatin1String("error")) {
+        out.type = type;
+        out.msgText = o.value(QLatin1String("ascii")).toString();
+        out.hexData = o.value(QLatin1String("hex")).toString();
+    } else if (type == QLatin1String("session")) {
+        out.type = QStringLiteral("system");
+        out.msgText = o.value(QLatin1String("event")).toString() == QLatin1String("start")
+            ? QStringLiteral("=== Session start ===") : QStringLiteral("=== Session ended ===");
+    } else {
+        // headless 的 event / exit 等其他紀錄: 原樣顯示
+        out.type = QStringLiteral("system");
+        out.msgText = QString::fromUtf8(line);
+    }
+}
+
+bool MappedLogScanner::nextCapture(TerminalEntry *out)
+{
+    using namespace CaptureFormat;
+    static const QString rx = QStringLiteral("rx");
+    static const QString tx = QStringLiteral("tx");
+    static const QString system = QStringLiteral("system");
+
+    while (m_readyPos >= m_ready.size()) {
+        m_ready.clear();
+        m_readyPos = 0;
+        qint64 lineTs = 0;
+        auto onRxLine = [&](const QByteArray &line) { m_ready.append({ rx, lineTs, line }); };
+
+        Record r;
+        if (!m_reader.next(r)) {
+            if (!m_splitter.hasPending())
+                return false;
+            lineTs = m_lastRxTs;
+            m_splitter.flush(onRxLine);
+            continue;
+        }
+        // 與前一個 RX chunk 相隔超過 idle 時間: 當時殘留資料已被 flush 成一行
+        if (m_splitter.hasPending() && (r.dir != Rx || r.tsNs - m_lastRxTs >= IdleFlushNs)) {
+            lineTs = r.dir == Rx ? m_lastRxTs + IdleFlushNs : r.tsNs;
+            m_splitter.flush(onRxLine);
+        }
+
+        switch (r.dir) {
+        case Rx:
+            lineTs = r.tsNs;
+            m_lastRxTs = r.tsNs;
+            m_splitter.feed(r.bytes, onRxLine);
+            break;
+        case Tx: {
+            QByteArray line = r.bytes;
+            while (line.endsWith('\n') || line.endsWith('\r'))
+                line.chop(1);
+            m_ready.append({ tx, r.tsNs, line });
+            break;
+        }
+        case Marker:
+            m_ready.append({ system, r.tsNs, r.bytes });
+            break;
+        }
+    }
+
+    const CaptureRow &row = m_ready.at(m_readyPos++);
+    if (out)
+        fillCapture(row, *out);
+    return true;
+}
+
+void MappedLogScanner::fillCapture(const CaptureRow &row, TerminalEntry &out)
+{
+    char ts[IsoTimestamp::Length];
+    m_iso.format(row.tsNs / 1000000, ts);
+    out.timestamp = QString::fromLatin1(ts + 11, IsoTimestamp::Length - 11);   // "HH:mm:ss.zzz"
+    out.type = row.type;
+    if (row.type == QLatin1String("system")) {
+        out.msgText = row.bytes == "start" ? QStringLiteral("=== Session start ===")
+                                           : QStringLiteral("=== Session ended ===");
+        out.hexData.clear();
+        return;
+    }
+    out.msgText = LineSplitter::asciiText(row.bytes);
+    out.hexData = LineSplitter::hexText(row.bytes);
+}
+
+MappedLogReader::MappedLogReader(const MappedLogSource &source,
+                                 const QList<MappedLogCheckpoint> &checkpoints)
+    : m_source(source)
+    , m_checkpoints(checkpoints)
+    , m_scanner(std::make_unique<MappedLogScanner>(source))
+{
+    m_scanner->seek(firstCheckpoint(m_source));
+}
+
+MappedLogReader::~MappedLogReader() = default;
+
+void MappedLogReader::seek(int row)
+{
+    auto it = std::upper_bound(m_checkpoints.cbegin(), m_checkpoints.cend(), row,
+                               [](int r, const MappedLogCheckpoint &cp) { return r < cp.firstRow; });
+    m_scanner->seek(it == m_checkpoints.cbegin() ? firstCheckpoint(m_source) : *(it - 1));
+    while (m_scanner->row() < row && m_scanner->next(nullptr)) {
+    }
+}
+
+bool MappedLogReader::next(TerminalEntry *out)
+{
+    return m_scanner->next(out);
+}
+
+// 背景掃描: 建索引 / filter / 搜尋各自持有一個 scanner,輪流跑一個時間片;
+// 結果以 queued 呼叫送回 model,帶 generation 讓 model 丟掉過期的結果
+class MappedLogWorker : public QThread
+{
+public:
+    MappedLogWorker(MappedLogModel *model, const MappedLogSource &source, int generation)
+        : m_model(model)
+        , m_source(source)
+        , m_generation(generation)
+    {
+    }
+
+    // filter 不生效 = 取消
+    void setFilter(int filterGeneration, const TerminalFilter &filter)
+    {
+        QMutexLocker lock(&m_mutex);
+        m_filterRequest = { filterGeneration, filter, QRegularExpression(), false };
+        m_hasFilterRequest = true;
+        m_wake.wakeOne();
+    }
+
+    void setSearch(int searchGeneration, const QRegularExpression &re, bool hexMode,
+                   const TerminalFilter &filter)
+    {
+        QMutexLocker lock(&m_mutex);
+        m_searchRequest = { searchGeneration, filter, re, hexMode };
+        m_hasSearchRequest = true;
+        m_wake.wakeOne();
+    }
+
+    void stop()
+    {
+        {
+            QMutexLocker lock(&m_mutex);
+            m_stop = true;
+            m_wake.wakeOne();
+        }
+        wait();
+    }
+
+protected:
+    void run() override;
+
+private:
+    struct Request {
+        int generation = 0;
+        TerminalFilter filter;
+        QRegularExpression re;   // 搜尋才有
+        bool hexMode = false;
+    };
+    struct Scan {
+        Scan(const MappedLogSource &source, const Request &request)
+            : scanner(source)
+            , request(request)
+        {
+            scanner.seek(firstCheckpoint(source));
+        }
+        MappedLogScanner scanner;
+        Request request;
+        QList<int> rows;
+    };
+
+    bool indexSlice();
+    bool scanSlice(Scan &scan, bool search);
+
+    MappedLogModel *m_model;
+    MappedLogSource m_source;
+    int m_generation;
+
+    QMutex m_mutex;
+    QWaitCondition m_wake;
+    bool m_stop = false;
+    Request m_filterRequest;
+    Request m_searchRequest;
+    bool m_hasFilterRequest = false;
+    bool m_hasSearchRequest = false;
+
+    std::unique_ptr<MappedLogScanner> m_indexer;
+    QList<MappedLogCheckpoint> m_fresh;   // 尚未送出的 checkpoint
+    qint64 m_lastCheckpointRow = 0;
+    QElapsedTimer m_publishClock;
+};
+
+void MappedLogWorker::run()
+{
+    m_indexer = std::make_unique<MappedLogScanner>(m_source);
+    m_indexer->seek(firstCheckpoint(m_source));
+    m_fresh.append(m_indexer->checkpoint());
+    m_publishClock.start();
+
+    bool indexDone = false;
+    std::unique_ptr<Scan> filter;
+    std::unique_ptr<Scan> search;
+    QElapsedTimer filterClock;
+
+    for (;;) {
+        {
+            QMutexLocker lock(&m_mutex);
+            while (!m_stop && indexDone && !filter && !search
+                   && !m_hasFilterRequest && !m_hasSearchRequest)
+                m_wake.wait(&m_mutex);
+            if (m_stop)
+                return;
+            if (m_hasFilterRequest) {
+                m_hasFilterRequest = false;
+                filter.reset();
+                if (m_filterRequest.filter.isActive()) {
+                    filter = std::make_unique<Scan>(m_source, m_filterRequest);
+                    filterClock.start();
+                }
+            }
+            if (m_hasSearchRequest) {
+                m_hasSearchRequest = false;
+                search = std::make_unique<Scan>(m_source, m_searchRequest);
+            }
+        }
+
+        if (!indexDone)
+            indexDone = indexSlice();
+
+        if (filter) {
+            const bool done = scanSlice(*filter, false);
+            if (done || filterClock.elapsed() >= PUBLISH_INTERVAL_MS) {
+                QMetaObject::invokeMethod(m_model, [model = m_model, gen = filter->request.generation,
+                                                    rows = filter->rows, done] {
+                    model->onFiltered(gen, rows, done);
+                }, Qt::QueuedConnection);
+                filter->rows.clear();
+                filterClock.restart();
+            }
+            if (done)
+                filter.reset();
+        }
+
+        if (search && scanSlice(*search, true)) {
+            QMetaObject::invokeMethod(m_model, [model = m_model, gen = search->request.generation,
+                                                rows = search->rows] {
+                model->onSearched(gen, rows);
+            }, Qt::QueuedConnection);
+            search.reset();
+        }
+    }
+}
+
+// 回傳 true = 整檔掃完
+bool MappedLogWorker::indexSlice()
+{
+    const int bucketRows = MappedLogModel::BucketRows;
+    bool done = false;
+    QElapsedTimer clock;
+    clock.start();
+    while (!done && clock.elapsed() < SLICE_MS) {
+        for (int i = 0; i < 1024; ++i) {
+            if (m_indexer->atBoundary() && m_indexer->row() - m_lastCheckpointRow >= bucketRows) {
+                m_fresh.append(m_indexer->checkpoint());
+                m_lastCheckpointRow = m_indexer->row();
+            }
+            if (!m_indexer->next(nullptr)) {
+                // 檔尾剛好落在 checkpoint 上: 那是空 bucket
+                if (m_indexer->row() > 0 && !m_fresh.isEmpty()
+                    && m_fresh.last().firstRow == m_indexer->row())
+                    m_fresh.removeLast();
+                done = true;
+                break;
+            }
+        }
+    }
+
+    if (done || m_publishClock.elapsed() >= PUBLISH_INTERVAL_MS) {
+        QMetaObject::invokeMethod(m_model, [model = m_model, gen = m_generation, cps = m_fresh,
+                                            rows = m_indexer->row(),
+                                            bytes = done ? m_source.size : m_indexer->position(), done] {
+            model->onIndexed(gen, cps, rows, bytes, done);
+        }, Qt::QueuedConnection);
+        m_fresh.clear();
+        m_publishClock.restart();
+    }
+    return done;
+}
+
+bool MappedLogWorker::scanSlice(Scan &scan, bool search)
+{
+    const Request &req = scan.request;
+    TerminalEntry e;
+    QElapsedTimer clock;
+    clock.start();
+    while (clock.elapsed() < SLICE_MS) {
+        for (int i = 0; i < 256; ++i) {
+            if (!scan.scanner.next(&e))
+                return true;
+            if (!req.filter.matches(e))
+                continue;
+            if (search) {
+                const QString &text = (req.hexMode && !e.hexData.isEmpty()) ? e.hexData : e.msgText;
+                if (!req.re.match(text).hasMatch())
+                    continue;
+            }
+            scan.rows.append(e.entryIndex);
+            if (search && scan.rows.size() >= MappedLogModel::MaxSearchHits)
+                return true;
+        }
+    }
+    return false;
+}
+
+MappedLogModel::MappedLogModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+MappedLogModel::~MappedLogModel()
+{
+    close();
+}
+
+bool MappedLogModel::open(const QString &filePath)
+{
+    close();
+
+    // QML FileDialog 給的是 file:// URL
+    const QString localPath = filePath.startsWith(QLatin1String("file:"))
+        ? QUrl(filePath).toLocalFile() : filePath;
+    m_file.setFileName(localPath);
+    auto fail = [this](const QString &message) {
+        m_error = message;
+        m_file.close();
+        emit activeChanged();
+        return false;
+    };
+    if (!m_file.open(QIODevice::ReadOnly))
+        return fail(m_file.errorString());
+    if (m_file.size() == 0)
+        return fail(QStringLiteral("File is empty"));
+
+    uchar *data = m_file.map(0, m_file.size());
+    if (!data)
+        return fail(m_file.errorString());
+    const char *bytes = reinterpret_cast<const char *>(data);
+    const qint64 size = m_file.size();
+    if (size >= 2 && quint8(bytes[0]) == 0x1f && quint8(bytes[1]) == 0x8b) {
+        m_file.unmap(data);
+        return fail(QStringLiteral("Compressed segment: decompress it first (gzip -d)"));
+    }
+
+    MappedLogSource source;
+    source.data = bytes;
+    source.size = size;
+    if (size >= qint64(sizeof(CaptureFormat::FileMagic))
+        && memcmp(bytes, CaptureFormat::FileMagic, sizeof(CaptureFormat::FileMagic)) == 0)
+        source.format = MappedLogSource::Capture;
+    else if (bytes[0] == '{')
+        source.format = MappedLogSource::Jsonl;
+
+    beginResetModel();
+    m_source = source;
+    m_path = localPath;
+    m_error.clear();
+    m_checkpoints.clear();
+    m_totalRows = 0;
+    m_bytesDone = 0;
+    m_indexDone = false;
+    m_visible.clear();
+    m_filterDone = !m_filter.isActive();
+    m_searching = false;
+    m_buckets.clear();
+    m_bucketOrder.clear();
+    m_runCache.clear();
+    endResetModel();
+    m_selection.clear();
+
+    m_worker = new MappedLogWorker(this, m_source, ++m_generation);
+    if (m_filter.isActive())
+        m_worker->setFilter(++m_filterGeneration, m_filter);
+    m_worker->start(QThread::LowPriority);
+
+    emit activeChanged();
+    emit progressChanged();
+    emit countChanged();
+    emit totalCountChanged();
+    return true;
+}
+
+void MappedLogModel::close()
+{
+    // 匯出中的 reader 還在讀映射區: 先讓持有者停下
+    if (isActive())
+        emit aboutToClose();
+    if (m_worker) {
+        m_worker->stop();
+        delete m_worker;
+        m_worker = nullptr;
+    }
+    ++m_generation;
+    ++m_filterGeneration;
+    ++m_searchGeneration;
+    if (!isActive())
+        return;
+
+    beginResetModel();
+    m_file.unmap(reinterpret_cast<uchar *>(const_cast<char *>(m_source.data)));
+    m_file.close();
+    m_source = MappedLogSource();
+    m_path.clear();
+    m_checkpoints.clear();
+    m_totalRows = 0;
+    m_bytesDone = 0;
+    m_visible.clear();
+    m_searching = false;
+    m_buckets.clear();
+    m_bucketOrder.clear();
+    m_runCache.clear();
+    endResetModel();
+    m_selection.clear();
+
+    emit activeChanged();
+    emit progressChanged();
+    emit countChanged();
+    emit totalCountChanged();
+}
+
+std::unique_ptr<MappedLogReader> MappedLogModel::createReader() const
+{
+    if (!isActive())
+        return nullptr;
+    return std::make_unique<MappedLogReader>(m_source, m_checkpoints);
+}
+
+QString MappedLogModel::format() const
+{
+    if (!isActive())
+        return QString();
+    switch (m_source.format) {
+    case MappedLogSource::Jsonl:   return QStringLiteral("jsonl");
+    case MappedLogSource::Capture: return QStringLiteral("cap");
+    case MappedLogSource::Text:    break;
+    }
+    return QStringLiteral("text");
+}
+
+qreal MappedLogModel::progress() const
+{
+    if (!isActive() || m_indexDone)
+        return 1.0;
+    return qreal(m_bytesDone) / qreal(m_source.size);
+}
+
+void MappedLogModel::onIndexed(int generation, const QList<MappedLogCheckpoint> &checkpoints,
+                               qint64 totalRows, qint64 bytesDone, bool done)
+{
+    if (generation != m_generation)
+        return;
+
+    // 最後一個 bucket 可能在上次解碼後又長了
+    if (!m_checkpoints.isEmpty()) {
+        const int last = int(m_checkpoints.size()) - 1;
+        m_buckets.remove(last);
+        m_bucketOrder.removeOne(last);
+    }
+    m_checkpoints.append(checkpoints);
+    m_bytesDone = bytesDone;
+    m_indexDone = done;
+
+    const int rows = int(qMin<qint64>(totalRows, std::numeric_limits<int>::max()));
+    if (rows > m_totalRows) {
+        if (!m_filter.isActive())
+            beginInsertRows(QModelIndex(), m_totalRows, rows - 1);
+        m_totalRows = rows;
+        if (!m_filter.isActive()) {
+            endInsertRows();
+            emit countChanged();
+        }
+        emit totalCountChanged();
+    }
+    emit progressChanged();
+}
+
+void MappedLogModel::onFiltered(int filterGeneration, const QList<int> &rows, bool done)
+{
+    if (filterGeneration != m_filterGeneration)
+        return;
+    if (!rows.isEmpty()) {
+        const int first = m_visible.size();
+        beginInsertRows(QModelIndex(), first, first + rows.size() - 1);
+        m_visible.append(rows);
+        endInsertRows();
+        emit countChanged();
+    }
+    if (done) {
+        m_filterDone = true;
+        emit progressChanged();
+    }
+}
+
+void MappedLogModel::onSearched(int searchGeneration, const QList<int> &rows)
+{
+    if (searchGeneration != m_searchGeneration)
+        return;
+    m_searching = false;
+
+    // worker 回報的是檔內列號;filter 生效時換成可見列(filter 還沒掃到的命中先略過)
+    QVariantList matches;
+    matches.reserve(rows.size());
+    for (int row : rows) {
+        if (!m_filter.isActive()) {
+            matches.append(row);
+            continue;
+        }
+        auto it = std::lower_bound(m_visible.cbegin(), m_visible.cend(), row);
+        if (it != m_visible.cend() && *it == row)
+            matches.append(int(it - m_visible.cbegin()));
+    }
+    emit progressChanged();
+    emit searchFinished(matches);
+}
+
+int MappedLogModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return count();
+}
+
+int MappedLogModel::globalRow(int row) const
+{
+    if (row < 0 || row >= count())
+        return -1;
+    return m_filter.isActive() ? m_visible.at(row) : row;
+}
+
+int MappedLogModel::bucketRows(int bucket) const
+{
+    const qint64 end = bucket + 1 < m_checkpoints.size() ? m_checkpoints.at(bucket + 1).firstRow
+                                                         : qint64(m_totalRows);
+    return int(end - m_checkpoints.at(bucket).firstRow);
+}
+
+TerminalEntry MappedLogModel::entryAt(int globalRow) const
+{
+    auto it = std::upper_bound(m_checkpoints.cbegin(), m_checkpoints.cend(), globalRow,
+                               [](int row, const MappedLogCheckpoint &cp) { return row < cp.firstRow; });
+    if (globalRow < 0 || globalRow >= m_totalRows || it == m_checkpoints.cbegin())
+        return TerminalEntry{ {}, {}, {}, {}, -1, {} };
+    const int bucket = int(it - m_checkpoints.cbegin()) - 1;
+
+    const QList<TerminalEntry> *rows;
+    auto cached = m_buckets.find(bucket);
+    if (cached != m_buckets.end()) {
+        m_bucketOrder.removeOne(bucket);
+        m_bucketOrder.append(bucket);
+        rows = &cached.value();
+    } else {
+        // 從 checkpoint 解一整個 bucket(~1024 列)
+        MappedLogScanner scanner(m_source);
+        scanner.seek(m_checkpoints.at(bucket));
+        const int n = bucketRows(bucket);
+        QList<TerminalEntry> decoded;
+        decoded.reserve(n);
+        TerminalEntry e;
+        while (decoded.size() < n && scanner.next(&e))
+            decoded.append(e);
+        if (m_buckets.size() >= BUCKET_CACHE_LIMIT)
+            m_buckets.remove(m_bucketOrder.takeFirst());
+        m_bucketOrder.append(bucket);
+        rows = &m_buckets.insert(bucket, decoded).value();
+    }
+
+    const int offset = globalRow - int(m_checkpoints.at(bucket).firstRow);
+    return offset < rows->size() ? rows->at(offset) : TerminalEntry{ {}, {}, {}, {}, -1, {} };
+}
+
+QVariant MappedLogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= count())
+        return QVariant();
+
+    const TerminalEntry e = entryAt(globalRow(index.row()));
+    switch (role) {
+    case TerminalModel::TimestampRole:  return e.timestamp;
+    case TerminalModel::MsgTextRole:    return e.msgText;
+    case TerminalModel::HexDataRole:    return e.hexData;
+    case TerminalModel::TypeRole:       return e.type;
+    case TerminalModel::EntryIndexRole: return e.entryIndex;
+    case TerminalModel::StyleRunsRole:  return QVariant::fromValue(cachedRuns(e));
+    case TerminalModel::LineColorRole:  return m_styler.lineColor(m_styler.displayText(e));
+    default:                            return QVariant();
+    }
+}
+
+QHash<int, QByteArray> MappedLogModel::roleNames() const
+{
+    return TerminalModel::entryRoleNames();
+}
+
+QList<int> MappedLogModel::cachedRuns(const TerminalEntry &e) const
+{
+    auto it = m_runCache.constFind(e.entryIndex);
+    if (it != m_runCache.constEnd())
+        return it.value();
+    if (m_runCache.size() >= RUN_CACHE_LIMIT)
+        m_runCache.clear();
+    const QList<int> runs = m_styler.runs(m_styler.displayText(e));
+    m_runCache.insert(e.entryIndex, runs);
+    return runs;
+}
+
+void MappedLogModel::invalidateStyles()
+{
+    m_runCache.clear();
+    if (count() > 0)
+        emit dataChanged(index(0), index(count() - 1),
+                         { TerminalModel::StyleRunsRole, TerminalModel::LineColorRole });
+    emit styleChanged();
+}
+
+void MappedLogModel::setColorNumbers(bool enabled)
+{
+    if (m_styler.colorNumbers() == enabled)
+        return;
+    m_styler.setColorNumbers(enabled);
+    invalidateStyles();
+}
+
+void MappedLogModel::setSearchHighlight(const QString &query, bool isRegex)
+{
+    m_styler.setSearch(query, isRegex);
+    invalidateStyles();
+}
+
+void MappedLogModel::setHighlightKeywords(const QVariantList &keywords, bool hexMode)
+{
+    m_styler.setKeywords(keywords);
+    m_styler.setHexMode(hexMode);
+    invalidateStyles();
+}
+
+QVariantMap MappedLogModel::get(int row) const
+{
+    const int g = globalRow(row);
+    if (g < 0)
+        return QVariantMap();
+    return TerminalModel::entryToMap(entryAt(g));
+}
+
+void MappedLogModel::setFilters(const QVariantList &filters)
+{
+    QStringList errors;
+    const TerminalFilter filter = TerminalFilter::fromVariantList(filters, &errors);
+    for (const QString &err : std::as_const(errors))
+        emit filterQueryError(err);
+
+    // 沒開檔時也記下來,下次 open 直接套用
+    beginResetModel();
+    m_filter = filter;
+    m_visible.clear();
+    m_filterDone = !m_filter.isActive();
+    ++m_filterGeneration;
+    endResetModel();
+    if (m_worker)
+        m_worker->setFilter(m_filterGeneration, m_filter);
+
+    emit countChanged();
+    emit filterActiveChanged();
+    emit progressChanged();
+}
+
+QVariantList MappedLogModel::search(const QString &query, bool isRegex, bool hexMode)
+{
+    ++m_searchGeneration;
+    m_searching = false;
+    const QString pattern = isRegex ? query : QRegularExpression::escape(query);
+    QRegularExpression re(pattern, QRegularExpression::CaseInsensitiveOption);
+    if (!m_worker || query.isEmpty() || !re.isValid()) {
+        emit progressChanged();
+        emit searchFinished({});
+        return {};
+    }
+
+    m_searching = true;
+    m_worker->setSearch(m_searchGeneration, re, hexMode, m_filter);
+    emit progressChanged();
+    return {};
+}
+
+QVariantList MappedLogModel::entryIndicesInRange(int loRow, int hiRow) const
+{
+    QVariantList result;
+    if (count() == 0)
+        return result;
+    const int lo = qBound(0, loRow, count() - 1);
+    const int hi = qBound(0, hiRow, count() - 1);
+    for (int row = lo; row <= hi; ++row)
+        result.append(globalRow(row));
+    return result;
+}
+
+int MappedLogModel::entryIndexAt(int row) const
+{
+    // entryIndex 就是檔內列號,不必解碼
+    return globalRow(row);
+}
+
+void MappedLogModel::selectRows(int fromRow, int toRow, bool extend)
+{
+    if (count() == 0)
+        return;
+    const int lo = qBound(0, qMin(fromRow, toRow), count() - 1);
+    const int hi = qBound(0, qMax(fromRow, toRow), count() - 1);
+    m_selection.selectRange(entryIndexAt(lo), entryIndexAt(hi), extend);
+}
+
+void MappedLogModel::selectAll()
+{
+    if (count() == 0)
+        return;
+    m_selection.selectRange(entryIndexAt(0), entryIndexAt(count() - 1), false);
+}
+
+template <typename Fn>
+void MappedLogModel::forEachSelected(Fn fn) const
+{
+    for (const TerminalSelection::Range &r : m_selection.ranges()) {
+        if (!m_filter.isActive()) {
+            const int hi = qMin(r.hi, m_totalRows - 1);
+            for (int row = qMax(0, r.lo); row <= hi; ++row)
+                fn(entryAt(row));
+            continue;
+        }
+        auto it = std::lower_bound(m_visible.cbegin(), m_visible.cend(), r.lo);
+        for (; it != m_visible.cend() && *it <= r.hi; ++it)
+            fn(entryAt(*it));
+    }
+}
+
+qint64 MappedLogModel::selectedRows() const
+{
+    qint64 rows = 0;
+    for (const TerminalSelection::Range &r : m_selection.ranges()) {
+        if (!m_filter.isActive()) {
+            rows += qMax(0, qMin(r.hi, m_totalRows - 1) - qMax(0, r.lo) + 1);
+            continue;
+        }
+        rows += std::upper_bound(m_visible.cbegin(), m_visible.cend(), r.hi)
+              - std::lower_bound(m_visible.cbegin(), m_visible.cend(), r.lo);
+    }
+    return rows;
+}
+
+int MappedLogModel::copySelection(bool timestamp, bool prefix, bool hexMode) const
+{
+    // 剪貼簿只收得下有限的量: selectAll 後數 GB 的檔不在 GUI thread 解碼
+    if (selectedRows() > MaxCopyLines)
+        return -1;
+
+    QString text;
+    int lines = 0;
+    forEachSelected([&](const TerminalEntry &e) {
+        if (lines++ > 0)
+            text += QLatin1Char('\n');
+        appendEntryLine(text, e, timestamp, prefix, hexMode);
+    });
+    if (lines > 0)
+        QGuiApplication::clipboard()->setText(text);
+    return lines;
+}
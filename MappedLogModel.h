@@ -0,0 +1,183 @@
+#ifndef MAPPEDLOGMODEL_H
+#define MAPPEDLOGMODEL_H
+
+#include <QAbstractListModel>
+#include <QFile>
+#include <QHash>
+#include <QVariantList>
+#include <QVariantMap>
+#include <QtQml/qqmlregistration.h>
+#include <memory>
+#include "TerminalModel.h"
+
+class MappedLogScanner;
+class MappedLogWorker;
+
+// 要檢視的檔案(mmap 後唯讀,worker 與 GUI thread 共用)
+struct MappedLogSource {
+    enum Format { Text, Jsonl, Capture };
+    const char *data = nullptr;
+    qint64 size = 0;
+    Format format = Text;
+};
+
+// 稀疏列索引: 每 ~1024 列一個,解碼從這裡開始。capture 另存當時的切行狀態
+struct MappedLogCheckpoint {
+    qint64 offset = 0;      // text / jsonl: 行首位置;capture: block 位置
+    qint64 firstRow = 0;
+    quint32 record = 0;     // capture: block 內第幾筆 record
+    qint64 lastRxTs = -1;   // capture: 上一個 RX chunk 的時戳(idle flush 重現)
+    QByteArray pending;     // capture: LineSplitter 殘留
+};
+
+// 匯出用: 在別的 thread 依檔內列號循序解碼,持有來源與 checkpoint 的快照。
+// 使用期間檔案必須保持映射: MappedLogModel 關檔前發 aboutToClose,持有者要先停下
+class MappedLogReader
+{
+public:
+    MappedLogReader(const MappedLogSource &source, const QList<MappedLogCheckpoint> &checkpoints);
+    ~MappedLogReader();
+
+    // 從 row 所在 bucket 的 checkpoint 解到 row
+    void seek(int row);
+    bool next(TerminalEntry *out);
+
+private:
+    MappedLogSource m_source;
+    QList<MappedLogCheckpoint> m_checkpoints;
+    std::unique_ptr<MappedLogScanner> m_scanner;
+};
+
+// 「開啟 log」: mmap 既有的 text / JSONL / capture 檔,以與 TerminalModel 相同的 role 呈現。
+// - 背景 thread 建稀疏索引(每 ~1024 列一個 checkpoint),數 GB 的檔索引也只有數 MB;
+//   邊建邊發布,第一批列一出來就能顯示,進度見 progress
+// - 列在被取用時才以 checkpoint 為單位解碼(LRU 快取),TerminalRenderer / 選取 / 複製沿用
+// - filter 與搜尋在同一個 worker 掃全檔,結果分批送回;entryIndex = 檔內列號
+// - keyword scroll bar 標記需要掃全檔,這裡不提供(highlightMarkers 回傳空)
+class MappedLogModel : public QAbstractListModel
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("MappedLogModel is provided by the application as mappedLog")
+    Q_PROPERTY(bool active READ isActive NOTIFY activeChanged)
+    Q_PROPERTY(QString path READ path NOTIFY activeChanged)
+    Q_PROPERTY(QString format READ format NOTIFY activeChanged)
+    Q_PROPERTY(qint64 fileSize READ fileSize NOTIFY activeChanged)
+    Q_PROPERTY(QString errorString READ errorString NOTIFY activeChanged)
+    Q_PROPERTY(bool indexing READ indexing NOTIFY progressChanged)
+    Q_PROPERTY(qreal progress READ progress NOTIFY progressChanged)
+    Q_PROPERTY(bool filtering READ filtering NOTIFY progressChanged)
+    Q_PROPERTY(bool searching READ searching NOTIFY progressChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(int totalCount READ totalCount NOTIFY totalCountChanged)
+    Q_PROPERTY(bool filterActive READ filterActive NOTIFY filterActiveChanged)
+    Q_PROPERTY(bool colorNumbers READ colorNumbers WRITE setColorNumbers NOTIFY styleChanged)
+    Q_PROPERTY(TerminalSelection *selection READ selection CONSTANT)
+
+public:
+    explicit MappedLogModel(QObject *parent = nullptr);
+    ~MappedLogModel() override;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    bool isActive() const { return m_source.data != nullptr; }
+    QString path() const { return m_path; }
+    QString format() const;
+    qint64 fileSize() const { return m_source.size; }
+    QString errorString() const { return m_error; }
+    bool indexing() const { return isActive() && !m_indexDone; }
+    qreal progress() const;
+    bool filtering() const { return isActive() && m_filter.isActive() && !m_filterDone; }
+    bool searching() const { return m_searching; }
+    int count() const { return m_filter.isActive() ? int(m_visible.size()) : m_totalRows; }
+    int totalCount() const { return m_totalRows; }
+    bool filterActive() const { return m_filter.isActive(); }
+    bool colorNumbers() const { return m_styler.colorNumbers(); }
+    void setColorNumbers(bool enabled);
+    TerminalSelection *selection() { return &m_selection; }
+    const TerminalFilter &filter() const { return m_filter; }
+    // 未開檔時回傳 nullptr
+    std::unique_ptr<MappedLogReader> createReader() const;
+
+    // 失敗時 errorString 說明原因
+    Q_INVOKABLE bool open(const QString &filePath);
+    Q_INVOKABLE void close();
+
+    // 與 TerminalModel 同名同義(QML 依 active 切換呼叫對象)
+    Q_INVOKABLE QVariantMap get(int row) const;
+    Q_INVOKABLE void setFilters(const QVariantList &filters);
+    // 非同步: 立即回傳空清單,掃完全檔後以 searchFinished(rows) 送回(最多 MaxSearchHits 筆)
+    Q_INVOKABLE QVariantList search(const QString &query, bool isRegex, bool hexMode);
+    Q_INVOKABLE QVariantList entryIndicesInRange(int loRow, int hiRow) const;
+    Q_INVOKABLE int entryIndexAt(int row) const;
+    Q_INVOKABLE void selectRows(int fromRow, int toRow, bool extend);
+    Q_INVOKABLE void selectAll();
+    // 在 GUI thread 解碼,超過 MaxCopyLines 列時拒絕並回傳 -1(大量請改用 TerminalExporter 匯出)
+    Q_INVOKABLE int copySelection(bool timestamp, bool prefix, bool hexMode) const;
+    Q_INVOKABLE void setHighlightKeywords(const QVariantList &keywords, bool hexMode);
+    Q_INVOKABLE QVariantList highlightMarkers() const { return {}; }
+    Q_INVOKABLE void setSearchHighlight(const QString &query, bool isRegex);
+
+    static constexpr int BucketRows = 1024;
+    static constexpr int MaxSearchHits = 100000;
+    static constexpr int MaxCopyLines = 100000;
+
+signals:
+    void activeChanged();
+    void aboutToClose();
+    void progressChanged();
+    void countChanged();
+    void totalCountChanged();
+    void filterActiveChanged();
+    void filterQueryError(const QString &message);
+    void searchFinished(const QVariantList &rows);
+    void styleChanged();
+
+private:
+    friend class MappedLogScanner;
+class MappedLogWorker;
+
+    // worker → GUI thread(queued);generation 不符的結果(已關檔 / 條件已變)丟棄
+    void onIndexed(int generation, const QList<MappedLogCheckpoint> &checkpoints,
+                   qint64 totalRows, qint64 bytesDone, bool done);
+    void onFiltered(int filterGeneration, const QList<int> &rows, bool done);
+    void onSearched(int searchGeneration, const QList<int> &rows);
+
+    int globalRow(int row) const;
+    TerminalEntry entryAt(int globalRow) const;
+    int bucketRows(int bucket) const;
+    QList<int> cachedRuns(const TerminalEntry &e) const;
+    void invalidateStyles();
+    template <typename Fn> void forEachSelected(Fn fn) const;
+    qint64 selectedRows() const;
+
+    QFile m_file;
+    QString m_path;
+    QString m_error;
+    MappedLogSource m_source;
+    MappedLogWorker *m_worker = nullptr;
+    int m_generation = 0;
+
+    QList<MappedLogCheckpoint> m_checkpoints;
+    int m_totalRows = 0;
+    qint64 m_bytesDone = 0;
+    bool m_indexDone = false;
+
+    TerminalFilter m_filter;
+    int m_filterGeneration = 0;
+    bool m_filterDone = true;
+    QList<int> m_visible;   // filter 生效時: 通過的檔內列號,遞增
+    int m_searchGeneration = 0;
+    bool m_searching = false;
+
+    // 解碼過的 bucket(LRU)與 styleRuns 快取
+    mutable QHash<int, QList<TerminalEntry>> m_buckets;
+    mutable QList<int> m_bucketOrder;
+    mutable QHash<int, QList<int>> m_runCache;
+    TerminalStyler m_styler;
+    TerminalSelection m_selection;
+};
+
+#endif // MAPPEDLOGMODEL_H
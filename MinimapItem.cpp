@@ -0,0 +1,253 @@
+#include "MinimapItem.h"
+#include <QQuickWindow>
+#include <QSGImageNode>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+const qreal DensityFullChars = 80;   // 平均行長到此即視為滿密度
+const qreal DensityFloor = 0.35;
+} // namespace
+
+void MinimapItem::Bucket::add(const TerminalEntry &e, QRgb hl, int sign)
+{
+    if (e.type == QLatin1String("rx"))          rx += sign;
+    else if (e.type == QLatin1String("tx"))     tx += sign;
+    else if (e.type == QLatin1String("error"))  error += sign;
+    else                                        system += sign;
+    chars += sign * e.msgText.size();
+    if (!e.hlColor.isEmpty()) {
+        highlighted += sign;
+        if (sign > 0)
+            hlColor = hl;
+    }
+}
+
+void MinimapItem::Bucket::merge(const Bucket &other)
+{
+    rx += other.rx;
+    tx += other.tx;
+    system += other.system;
+    error += other.error;
+    chars += other.chars;
+    if (other.highlighted > 0)
+        hlColor = other.hlColor;
+    highlighted += other.highlighted;
+}
+
+MinimapItem::MinimapItem(QQuickItem *parent)
+    : QQuickItem(parent)
+    , m_image(TextureWidth, TextureRows, QImage::Format_ARGB32_Premultiplied)
+{
+    setFlag(ItemHasContents, true);
+    m_image.fill(Qt::transparent);
+    connect(this, &MinimapItem::appearanceChanged, this, &MinimapItem::repaintAll);
+}
+
+void MinimapItem::setModel(TerminalModel *model)
+{
+    if (m_model == model)
+        return;
+    for (const QMetaObject::Connection &c : std::as_const(m_modelConnections))
+        disconnect(c);
+    m_modelConnections.clear();
+
+    m_model = model;
+    if (m_model) {
+        m_modelConnections
+            << connect(m_model, &QAbstractItemModel::rowsInserted, this, &MinimapItem::onRowsInserted)
+            << connect(m_model, &QAbstractItemModel::rowsAboutToBeRemoved, this, &MinimapItem::onRowsAboutToBeRemoved)
+            << connect(m_model, &QAbstractItemModel::rowsRemoved, this, &MinimapItem::onRowsRemoved)
+            << connect(m_model, &QAbstractItemModel::modelReset, this, &MinimapItem::rebuild)
+            << connect(m_model, &TerminalModel::highlightKeywordsChanged, this, &MinimapItem::rebuild);
+    }
+    emit modelChanged();
+    rebuild();
+}
+
+QRgb MinimapItem::hlRgb(const QString &color)
+{
+    // 連續命中同一 keyword 是常態: 只快取上一個
+    if (color != m_lastHlName) {
+        m_lastHlName = color;
+        m_lastHlRgb = QColor(color).rgb();
+    }
+    return m_lastHlRgb;
+}
+
+void MinimapItem::addRow(int row, int sign)
+{
+    const TerminalEntry &e = m_model->visibleEntry(row);
+    const qint64 index = ((m_origin + row) >> m_shift) - m_firstBucket;
+    while (m_buckets.size() <= index)
+        m_buckets.append(Bucket());
+    m_buckets[index].add(e, e.hlColor.isEmpty() ? 0 : hlRgb(e.hlColor), sign);
+}
+
+void MinimapItem::onRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+    // TerminalModel 只在尾端插入;其他情況保守重建
+    if (last != m_model->rowCount() - 1) {
+        rebuild();
+        return;
+    }
+
+    const int firstDirty = int(((m_origin + first) >> m_shift) - m_firstBucket);
+    for (int row = first; row <= last; ++row)
+        addRow(row, +1);
+
+    if (m_buckets.size() > TextureRows) {
+        while (m_buckets.size() > TextureRows)
+            coarsen();
+        repaintAll();
+        return;
+    }
+    for (int i = qMax(0, firstDirty); i < m_buckets.size(); ++i)
+        paintBucket(i);
+    markDirty();
+}
+
+void MinimapItem::onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+    if (first != 0) {
+        m_pendingRebuild = true;
+        return;
+    }
+
+    // 修剪去頭: 整個落在移除範圍的 bucket 直接丟掉,跨界的首個 bucket 扣掉被移除的列
+    const qint64 newOrigin = m_origin + last + 1;
+    const qint64 newFirstBucket = newOrigin >> m_shift;
+    const qint64 partialStart = qMax<qint64>(0, (newFirstBucket << m_shift) - m_origin);
+    for (qint64 row = partialStart; row <= last; ++row)
+        addRow(int(row), -1);
+
+    const int drop = int(qMin<qint64>(newFirstBucket - m_firstBucket, m_buckets.size()));
+    m_buckets.remove(0, drop);
+    m_origin = newOrigin;
+    m_firstBucket = newFirstBucket;
+
+    // image 跟著往上捲 drop 列,尾端清空;首列重算
+    if (drop > 0) {
+        const qsizetype bpl = m_image.bytesPerLine();
+        uchar *bits = m_image.bits();
+        std::memmove(bits, bits + drop * bpl, (TextureRows - drop) * bpl);
+        std::memset(bits + (TextureRows - drop) * bpl, 0, drop * bpl);
+    }
+    if (!m_buckets.isEmpty())
+        paintBucket(0);
+    markDirty();
+}
+
+void MinimapItem::onRowsRemoved(const QModelIndex &parent, int, int)
+{
+    if (parent.isValid())
+        return;
+    if (m_pendingRebuild)
+        rebuild();
+}
+
+void MinimapItem::coarsen()
+{
+    // bucket 大小加倍: 相鄰兩個彙總值合併
+    const qint64 newFirst = m_firstBucket >> 1;
+    QList<Bucket> merged;
+    merged.reserve(m_buckets.size() / 2 + 1);
+    for (int i = 0; i < m_buckets.size(); ++i) {
+        const qint64 index = ((m_firstBucket + i) >> 1) - newFirst;
+        if (merged.size() <= index)
+            merged.append(Bucket());
+        merged[index].merge(m_buckets.at(i));
+    }
+    m_buckets.swap(merged);
+    m_firstBucket = newFirst;
+    ++m_shift;
+}
+
+void MinimapItem::rebuild()
+{
+    m_pendingRebuild = false;
+    m_buckets.clear();
+    m_origin = 0;
+    m_firstBucket = 0;
+    m_shift = 0;
+
+    const int rows = m_model ? m_model->rowCount() : 0;
+    while (rows > 0 && ((rows - 1) >> m_shift) >= TextureRows)
+        ++m_shift;
+    for (int row = 0; row < rows; ++row)
+        addRow(row, +1);
+    repaintAll();
+}
+
+void MinimapItem::repaintAll()
+{
+    m_image.fill(Qt::transparent);
+    for (int i = 0; i < m_buckets.size(); ++i)
+        paintBucket(i);
+    markDirty();
+}
+
+void MinimapItem::paintBucket(int index)
+{
+    QRgb *line = reinterpret_cast<QRgb *>(m_image.scanLine(index));
+    const Bucket &b = m_buckets.at(index);
+    const int lines = b.lines();
+    if (lines <= 0) {
+        std::fill(line, line + TextureWidth, 0);
+        return;
+    }
+
+    // type: 有 error 即紅;否則依 rx / tx / system 筆數加權混色
+    qreal r, g, bl;
+    if (b.error > 0) {
+        r = m_errorColor.redF(); g = m_errorColor.greenF(); bl = m_errorColor.blueF();
+    } else {
+        const qreal n = lines;
+        r = (m_rxColor.redF() * b.rx + m_txColor.redF() * b.tx + m_systemColor.redF() * b.system) / n;
+        g = (m_rxColor.greenF() * b.rx + m_txColor.greenF() * b.tx + m_systemColor.greenF() * b.system) / n;
+        bl = (m_rxColor.blueF() * b.rx + m_txColor.blueF() * b.tx + m_systemColor.blueF() * b.system) / n;
+    }
+    const qreal avgChars = qreal(b.chars) / lines;
+    const qreal alpha = DensityFloor + (1 - DensityFloor) * qMin<qreal>(1, avgChars / DensityFullChars);
+    const QRgb typeRgb = qPremultiply(qRgba(int(r * 255), int(g * 255), int(bl * 255), int(alpha * 255)));
+
+    std::fill(line, line + TypeColumns, typeRgb);
+    line[TypeColumns] = 0;
+    std::fill(line + TypeColumns + 1, line + TextureWidth,
+              b.highlighted > 0 ? (b.hlColor | 0xff000000u) : 0u);
+}
+
+void MinimapItem::markDirty()
+{
+    m_imageDirty = true;
+    update();
+}
+
+QSGNode *MinimapItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    auto *node = static_cast<QSGImageNode *>(oldNode);
+    if (m_buckets.isEmpty() || width() <= 0 || height() <= 0) {
+        delete node;
+        m_imageDirty = true;
+        return nullptr;
+    }
+    if (!node) {
+        node = window()->createImageNode();
+        node->setOwnsTexture(true);
+        node->setFiltering(QSGTexture::Linear);
+        m_imageDirty = true;
+    }
+    // 只有 bucket 內容變動時才重新上傳(TextureWidth × TextureRows,約 64KB)
+    if (m_imageDirty) {
+        node->setTexture(window()->createTextureFromImage(m_image));
+        m_imageDirty = false;
+    }
+    // 已用的 bucket 列拉伸到整個高度
+    node->setRect(boundingRect());
+    node->setSourceRect(QRectF(0, 0, TextureWidth, m_buckets.size()));
+    return node;
+}
@@ -0,0 +1,94 @@
+#ifndef MINIMAPITEM_H
+#define MINIMAPITEM_H
+
+#include <QColor>
+#include <QImage>
+#include <QList>
+#include <QPointer>
+#include <QQuickItem>
+#include <QtQml/qqmlregistration.h>
+#include "TerminalModel.h"
+
+// 整個 buffer 的 minimap 條(TerminalModel 的可見列)。
+// - 列分組成 bucket(每 bucket 2^shift 列),每個 bucket 一列 texel:
+//   左側依 type 比例混色(有 error 即紅),右側為 keyword highlight 色,alpha = 行長密度
+// - bucket 數超過 texture 高度時 shift+1、相鄰兩 bucket 合併(由彙總值合併,不回頭讀 entry)
+// - 新列只更新尾端 bucket 的 texel;修剪只把 image 往上捲、重算首列;
+//   filter / keyword 變更才整批重建
+// - 沒有新資料時不重傳 texture,每 frame 成本為 0
+class MinimapItem : public QQuickItem
+{
+    Q_OBJECT
+    QML_ELEMENT
+    Q_PROPERTY(TerminalModel *model READ model WRITE setModel NOTIFY modelChanged)
+    Q_PROPERTY(QColor rxColor MEMBER m_rxColor NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor txColor MEMBER m_txColor NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor systemColor MEMBER m_systemColor NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor errorColor MEMBER m_errorColor NOTIFY appearanceChanged)
+
+public:
+    explicit MinimapItem(QQuickItem *parent = nullptr);
+
+    TerminalModel *model() const { return m_model; }
+    void setModel(TerminalModel *model);
+
+signals:
+    void modelChanged();
+    void appearanceChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+
+private slots:
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onRowsRemoved(const QModelIndex &parent, int first, int last);
+    void rebuild();
+    void repaintAll();
+
+private:
+    struct Bucket {
+        int rx = 0;
+        int tx = 0;
+        int system = 0;
+        int error = 0;
+        int highlighted = 0;
+        QRgb hlColor = 0;    // 最近一筆命中的 keyword 色
+        qint64 chars = 0;    // msgText 長度總和(密度)
+
+        int lines() const { return rx + tx + system + error; }
+        void add(const TerminalEntry &e, QRgb hl, int sign);
+        void merge(const Bucket &other);
+    };
+
+    void addRow(int row, int sign);
+    void coarsen();
+    void paintBucket(int index);
+    void markDirty();
+    QRgb hlRgb(const QString &color);
+
+    static constexpr int TextureRows = 2048;
+    static constexpr int TextureWidth = 8;
+    static constexpr int TypeColumns = 5;   // 其後 1 欄留空,最後 2 欄為 highlight
+
+    QPointer<TerminalModel> m_model;
+    QList<QMetaObject::Connection> m_modelConnections;
+
+    QList<Bucket> m_buckets;   // m_buckets[i] = bucket id m_firstBucket + i
+    int m_shift = 0;
+    qint64 m_origin = 0;       // model row 0 的絕對位置(修剪累計)
+    qint64 m_firstBucket = 0;
+    bool m_pendingRebuild = false;
+
+    QImage m_image;            // TextureWidth × TextureRows,第 i 列 = m_buckets[i]
+    bool m_imageDirty = true;
+    QString m_lastHlName;
+    QRgb m_lastHlRgb = 0;
+
+    QColor m_rxColor = QColor(0x00, 0xff, 0x88);
+    QColor m_txColor = QColor(0x00, 0xd4, 0xff);
+    QColor m_systemColor = QColor(0xff, 0x00, 0xff);
+    QColor m_errorColor = QColor(0xff, 0x33, 0x66);
+};
+
+#endif // MINIMAPITEM_H
@@ -0,0 +1,253 @@
+#include "PcapngFormat.h"
+#include <QDateTime>
+#include <QFile>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtEndian>
+#include <cstdio>
+#include <cstring>
+#include "CaptureFormat.h"
+#include "version.h"
+
+namespace Pcapng {
+
+// option code
+enum : quint16 {
+    OptEnd = 0,
+    OptComment = 1,
+    ShbUserAppl = 4,
+    IfName = 2,
+    IfDescription = 3,
+    IfTsResol = 9,
+    EpbFlags = 2,
+};
+
+static constexpr qsizetype pad4(qsizetype n)
+{
+    return (n + 3) & ~qsizetype(3);
+}
+
+static void appendU16(QByteArray &out, quint16 v)
+{
+    char b[2];
+    qToLittleEndian(v, b);
+    out.append(b, 2);
+}
+
+static void appendU32(QByteArray &out, quint32 v)
+{
+    char b[4];
+    qToLittleEndian(v, b);
+    out.append(b, 4);
+}
+
+static void appendOption(QByteArray &out, quint16 code, const QByteArray &value)
+{
+    appendU16(out, code);
+    appendU16(out, quint16(value.size()));
+    out.append(value);
+    out.append(pad4(value.size()) - value.size(), '\0');
+}
+
+// body = type / 長度之後、結尾長度之前的內容
+static QByteArray block(quint32 type, const QByteArray &body)
+{
+    const quint32 total = quint32(12 + body.size());
+    QByteArray out;
+    out.reserve(total);
+    appendU32(out, type);
+    appendU32(out, total);
+    out.append(body);
+    appendU32(out, total);
+    return out;
+}
+
+QByteArray sectionHeader()
+{
+    QByteArray body;
+    appendU32(body, ByteOrderMagic);
+    appendU16(body, 1);   // major
+    appendU16(body, 0);   // minor
+    appendU32(body, 0xFFFFFFFF);   // section length: 未知(-1)
+    appendU32(body, 0xFFFFFFFF);
+    appendOption(body, ShbUserAppl, QByteArray(APP_NAME " " APP_VERSION_STR));
+    appendU32(body, OptEnd);
+    return block(SectionHeaderType, body);
+}
+
+QByteArray interfaceBlock(const QString &interfaceName)
+{
+    const QString name = interfaceName.isEmpty() ? QStringLiteral("uart") : interfaceName;
+    QByteArray body;
+    appendU16(body, LinkTypeUser0);
+    appendU16(body, 0);   // reserved
+    appendU32(body, 0);   // snaplen: 不限
+    appendOption(body, IfName, name.toUtf8());
+    appendOption(body, IfDescription, QByteArrayLiteral("UART raw read/write chunks"));
+    appendOption(body, IfTsResol, QByteArray(1, char(9)));   // 10^-9 s
+    appendU32(body, OptEnd);
+    return block(InterfaceType, body);
+}
+
+QByteArray packetComment(quint8 direction, const QString &interfaceName)
+{
+    const QString name = interfaceName.isEmpty() ? QStringLiteral("uart") : interfaceName;
+    return (direction == CaptureFormat::Tx ? QByteArrayLiteral("TX ") : QByteArrayLiteral("RX "))
+           + name.toUtf8();
+}
+
+void encodePacket(QByteArray &out, qint64 tsNs, quint8 direction,
+                  const QByteArray &bytes, const QByteArray &comment, quint32 interfaceId)
+{
+    const qsizetype dataLen = pad4(bytes.size());
+    const qsizetype commentLen = comment.isEmpty() ? 0 : 4 + pad4(comment.size());
+    // type, len, interface, ts hi, ts lo, caplen, origlen | data | flags | comment | end | len
+    const qsizetype total = 28 + dataLen + 8 + commentLen + 4 + 4;
+    out.resize(total);
+    char *p = out.data();
+
+    auto put32 = [&p](quint32 v) {
+        qToLittleEndian(v, p);
+        p += 4;
+    };
+    auto put16 = [&p](quint16 v) {
+        qToLittleEndian(v, p);
+        p += 2;
+    };
+    auto putBytes = [&p](const QByteArray &b, qsizetype padded) {
+        memcpy(p, b.constData(), size_t(b.size()));
+        memset(p + b.size(), 0, size_t(padded - b.size()));
+        p += padded;
+    };
+
+    const quint64 ts = quint64(tsNs);
+    put32(EnhancedPacketType);
+    put32(quint32(total));
+    put32(interfaceId);
+    put32(quint32(ts >> 32));
+    put32(quint32(ts));
+    put32(quint32(bytes.size()));
+    put32(quint32(bytes.size()));
+    putBytes(bytes, dataLen);
+
+    put16(EpbFlags);
+    put16(4);
+    put32(direction == CaptureFormat::Tx ? 2 : 1);   // bit 0-1: 1 = inbound, 2 = outbound
+    if (!comment.isEmpty()) {
+        put16(OptComment);
+        put16(quint16(comment.size()));
+        putBytes(comment, pad4(comment.size()));
+    }
+    put32(OptEnd);
+    put32(quint32(total));
+}
+
+int convert(const QString &inPath, const QString &outPath, const QString &interfaceName)
+{
+    QFile in(inPath);
+    if (!in.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "cannot open input: %s\n", qUtf8Printable(inPath));
+        return 3;
+    }
+    CaptureFormat::Reader reader(&in);
+    const bool capture = reader.isValid();
+    if (!capture) {
+        in.seek(0);
+        char first = 0;
+        if (!in.getChar(&first) || first != '{') {
+            fprintf(stderr, "not a capture or JSONL log: %s\n", qUtf8Printable(inPath));
+            return 7;
+        }
+        in.seek(0);
+    }
+
+    QFile out;
+    const bool ok = outPath.isEmpty() ? out.open(stdout, QIODevice::WriteOnly)
+                                      : (out.setFileName(outPath), out.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    if (!ok) {
+        fprintf(stderr, "cannot open output: %s\n", qUtf8Printable(outPath));
+        return 3;
+    }
+
+    // 寫不進去(磁碟滿 / pipe 關閉)就停止並回報,不留下看似完整的輸出
+    QByteArray buffer = sectionHeader();
+    bool writeFailed = false;
+    auto writeBuffer = [&]() {
+        if (!writeFailed && out.write(buffer) != buffer.size())
+            writeFailed = true;
+        buffer.resize(0);
+    };
+
+    // 每個 port 一個 IDB,第一次出現時才寫(IDB 可出現在 section 內任何位置,與 live writer 相同的
+    // "一個 port 一個 interface");沒有 port 欄位的紀錄與 capture 用 interfaceName
+    struct Interface {
+        quint32 id;
+        QByteArray rxComment;
+        QByteArray txComment;
+    };
+    QHash<QString, Interface> interfaces;
+    auto interfaceFor = [&](const QString &port) -> const Interface & {
+        auto it = interfaces.find(port);
+        if (it == interfaces.end()) {
+            const QString name = port.isEmpty() ? interfaceName : port;
+            buffer += interfaceBlock(name);
+            it = interfaces.insert(port, { quint32(interfaces.size()),
+                                           packetComment(CaptureFormat::Rx, name),
+                                           packetComment(CaptureFormat::Tx, name) });
+        }
+        return it.value();
+    };
+
+    QByteArray packet;
+    auto emitPacket = [&](qint64 tsNs, quint8 dir, const QByteArray &bytes, const QString &port) {
+        const Interface &iface = interfaceFor(port);
+        encodePacket(packet, tsNs, dir, bytes,
+                     dir == CaptureFormat::Tx ? iface.txComment : iface.rxComment, iface.id);
+        buffer += packet;
+        if (buffer.size() >= (1 << 20))
+            writeBuffer();
+    };
+
+    if (capture) {
+        // 每個 chunk 原樣一個 packet;session marker 不是線上資料,略過
+        CaptureFormat::Record r;
+        while (!writeFailed && reader.next(r)) {
+            if (r.dir == CaptureFormat::Rx || r.dir == CaptureFormat::Tx)
+                emitPacket(r.tsNs, r.dir, r.bytes, QString());
+        }
+        if (reader.skippedBlocks() > 0)
+            fprintf(stderr, "skipped %lld damaged block(s)\n", reader.skippedBlocks());
+    } else {
+        // JSONL: rx / tx 紀錄的 hex(沒有 hex 時用 ascii 的 UTF-8)還原成 bytes;ts 為本地時間含毫秒;
+        // 多 port 的 log 每筆帶 port
+        while (!writeFailed && !in.atEnd()) {
+            const QJsonDocument doc = QJsonDocument::fromJson(in.readLine());
+            if (!doc.isObject())
+                continue;
+            const QJsonObject o = doc.object();
+            const QString type = o.value(QLatin1String("type")).toString();
+            const bool tx = type == QLatin1String("tx");
+            if (!tx && type != QLatin1String("rx"))
+                continue;
+            const QString hex = o.value(QLatin1String("hex")).toString();
+            const QByteArray bytes = hex.isEmpty() ? o.value(QLatin1String("ascii")).toString().toUtf8()
+                                                   : QByteArray::fromHex(hex.toLatin1());
+            const QDateTime ts = QDateTime::fromString(o.value(QLatin1String("ts")).toString(),
+                                                       Qt::ISODateWithMs);
+            emitPacket(ts.isValid() ? ts.toMSecsSinceEpoch() * 1000000 : 0,
+                       tx ? CaptureFormat::Tx : CaptureFormat::Rx, bytes,
+                       o.value(QLatin1String("port")).toString());
+        }
+    }
+    if (interfaces.isEmpty())
+        interfaceFor(QString());   // 沒有任何 packet 仍輸出合法的 SHB + IDB
+    writeBuffer();
+    if (writeFailed || !out.flush()) {
+        fprintf(stderr, "write failed: %s\n", qUtf8Printable(outPath.isEmpty() ? QStringLiteral("stdout") : outPath));
+        return 3;
+    }
+    return 0;
+}
+
+} // namespace Pcapng
@@ -0,0 +1,44 @@
+#ifndef PCAPNGFORMAT_H
+#define PCAPNGFORMAT_H
+
+#include <QByteArray>
+#include <QString>
+
+// --format pcapng: 原始 chunk 直接寫成 pcapng(little-endian),交給 Wireshark 等工具。
+//
+//   SHB(section header)| IDB(interface: if_name = port,if_tsresol = ns)| EPB ...
+//   EPB: 一個 chunk 一個 packet,ns 時戳;epb_flags 標方向(inbound = RX / outbound = TX),
+//        opt_comment = "RX COM3" / "TX COM3"
+//
+// UART 沒有標準 linktype,用 DLT_USER0(147): Wireshark 可在 "DLT_USER" 設定指定 dissector。
+// 每個 session 開頭(含 append 到既有檔、輪替出的新 segment)都重寫 SHB + IDB:
+// 多個 section 串接是合法的 pcapng,各段帶自己的 port。
+// headless 多 port: 每個 port 一個 IDB(依 --port 順序),EPB 的 interface id 即 port index
+namespace Pcapng {
+
+constexpr quint32 SectionHeaderType = 0x0A0D0D0A;
+constexpr quint32 InterfaceType = 0x00000001;
+constexpr quint32 EnhancedPacketType = 0x00000006;
+constexpr quint32 ByteOrderMagic = 0x1A2B3C4D;
+constexpr quint16 LinkTypeUser0 = 147;
+
+QByteArray sectionHeader();
+// interfaceName 空白時為 "uart"
+QByteArray interfaceBlock(const QString &interfaceName);
+// 每筆 packet 的 comment("RX COM3");writer 開 section 時算一次
+QByteArray packetComment(quint8 direction, const QString &interfaceName);
+
+// 清空 out 後寫入一個 EPB(保留容量: writer 每筆重用同一個 buffer,不配置記憶體)
+// direction = CaptureFormat::Rx / Tx;interfaceId = section 內第幾個 IDB
+void encodePacket(QByteArray &out, qint64 tsNs, quint8 direction,
+                  const QByteArray &bytes, const QByteArray &comment, quint32 interfaceId = 0);
+
+// --convert ... --format pcapng: 輸入為 capture(每個 chunk 一個 packet,byte-exact)
+// 或 JSONL 紀錄(每行的 hex 還原成 bytes,一行一個 packet;行尾換行已在切行時去掉;
+// 帶 port 欄位時每個 port 一個 IDB)。
+// 串流處理,記憶體固定。回傳 exit code: 0 成功, 3 檔案開啟 / 寫入失敗, 7 不是 capture / JSONL
+int convert(const QString &inPath, const QString &outPath, const QString &interfaceName);
+
+} // namespace Pcapng
+
+#endif // PCAPNGFORMAT_H
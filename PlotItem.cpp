@@ -0,0 +1,177 @@
+#include "PlotItem.h"
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+#include <QtMath>
+#include <algorithm>
+#include <limits>
+
+namespace {
+const qreal VerticalPadding = 4;
+} // namespace
+
+PlotItem::PlotItem(QQuickItem *parent)
+    : QQuickItem(parent)
+    , m_colors({ QColor(0x00, 0xff, 0x88), QColor(0x00, 0xd4, 0xff), QColor(0xff, 0x00, 0xff),
+                 QColor(0xff, 0xaa, 0x00), QColor(0xff, 0x33, 0x66), QColor(0xe0, 0xe0, 0xe0),
+                 QColor(0x88, 0x66, 0xff), QColor(0x66, 0xff, 0xff) })
+{
+    setFlag(ItemHasContents, true);
+    setClip(true);
+    connect(this, &PlotItem::colorsChanged, this, &PlotItem::scheduleRefresh);
+}
+
+void PlotItem::setSource(SignalExtractor *source)
+{
+    if (m_source == source)
+        return;
+    disconnect(m_sourceConnection);
+    m_source = source;
+    if (m_source)
+        m_sourceConnection = connect(m_source, &SignalExtractor::samplesAppended,
+                                     this, &PlotItem::scheduleRefresh);
+    emit sourceChanged();
+    scheduleRefresh();
+}
+
+void PlotItem::setWindowSamples(int samples)
+{
+    samples = qMax(2, samples);
+    if (m_windowSamples == samples)
+        return;
+    m_windowSamples = samples;
+    emit windowSamplesChanged();
+    scheduleRefresh();
+}
+
+void PlotItem::scheduleRefresh()
+{
+    polish();
+    update();
+}
+
+void PlotItem::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size())
+        scheduleRefresh();
+}
+
+void PlotItem::updatePolish()
+{
+    m_frame.clear();
+    const int columns = qFloor(width());
+    if (!m_source || columns < 1 || height() <= 2 * VerticalPadding)
+        return;
+
+    // 每個序列先抽成「像素欄 → [min, max]」(值空間),再依全體範圍換算 y
+    struct Column { float lo; float hi; };
+    QList<QList<Column>> perSeries;
+    QList<QList<int>> perSeriesX;
+    float lo = std::numeric_limits<float>::max();
+    float hi = std::numeric_limits<float>::lowest();
+
+    const QList<SignalExtractor::Series> &series = m_source->series();
+    const qint64 window = m_windowSamples;
+    for (const SignalExtractor::Series &s : series) {
+        QList<Column> cols;
+        QList<int> xs;
+        const int n = int(qMin<qint64>(s.size, window));
+        const int first = s.size - n;
+        int currentCol = -1;
+        for (int i = 0; i < n; ++i) {
+            // 右對齊: 最新樣本落在最後一欄
+            const int col = int((qint64(i) + window - n) * columns / window);
+            const float v = s.at(first + i);
+            if (col != currentCol) {
+                cols.append({ v, v });
+                xs.append(col);
+                currentCol = col;
+            } else {
+                cols.last().lo = qMin(cols.last().lo, v);
+                cols.last().hi = qMax(cols.last().hi, v);
+            }
+            lo = qMin(lo, v);
+            hi = qMax(hi, v);
+        }
+        perSeries.append(cols);
+        perSeriesX.append(xs);
+    }
+
+    if (lo > hi) {
+        lo = 0;
+        hi = 1;
+    } else if (hi - lo < 1e-6f) {
+        lo -= 0.5f;
+        hi += 0.5f;
+    }
+    if (m_yMin != lo || m_yMax != hi) {
+        m_yMin = lo;
+        m_yMax = hi;
+        emit rangeChanged();
+    }
+
+    const qreal plotH = height() - 2 * VerticalPadding;
+    const qreal scale = plotH / (hi - lo);
+    auto yOf = [&](float v) { return VerticalPadding + (hi - v) * scale; };
+
+    for (int si = 0; si < perSeries.size(); ++si) {
+        const QList<Column> &cols = perSeries.at(si);
+        if (cols.isEmpty())
+            continue;
+        FrameSeries fs;
+        fs.color = m_colors.isEmpty() ? QColor(Qt::white) : m_colors.at(si % m_colors.size());
+        fs.vertices.reserve(cols.size() * 2);
+        for (int c = 0; c < cols.size(); ++c) {
+            const qreal x = perSeriesX.at(si).at(c) + 0.5;
+            fs.vertices.append(QPointF(x, yOf(cols.at(c).lo)));
+            if (cols.at(c).hi != cols.at(c).lo)
+                fs.vertices.append(QPointF(x, yOf(cols.at(c).hi)));
+        }
+        m_frame.append(fs);
+    }
+}
+
+QSGNode *PlotItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    // root 底下每個序列一個 line strip geometry node(數量跟著序列數增減)
+    QSGNode *root = oldNode ? oldNode : new QSGNode;
+
+    while (root->childCount() > m_frame.size()) {
+        QSGNode *child = root->lastChild();
+        root->removeChildNode(child);
+        delete child;
+    }
+    while (root->childCount() < m_frame.size()) {
+        auto *node = new QSGGeometryNode;
+        auto *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawLineStrip);
+        node->setGeometry(geometry);
+        node->setMaterial(new QSGFlatColorMaterial);
+        node->setFlags(QSGNode::OwnsGeometry | QSGNode::OwnsMaterial);
+        root->appendChildNode(node);
+    }
+
+    QSGNode *child = root->firstChild();
+    for (const FrameSeries &fs : std::as_const(m_frame)) {
+        auto *node = static_cast<QSGGeometryNode *>(child);
+        QSGGeometry *geometry = node->geometry();
+        geometry->setLineWidth(float(m_lineWidth));
+        // 單一頂點的 strip 畫不出東西: 複製一份成為一點長的線段
+        const int count = fs.vertices.size() == 1 ? 2 : int(fs.vertices.size());
+        geometry->allocate(count);
+        QSGGeometry::Point2D *v = geometry->vertexDataAsPoint2D();
+        for (int i = 0; i < fs.vertices.size(); ++i)
+            v[i].set(float(fs.vertices.at(i).x()), float(fs.vertices.at(i).y()));
+        if (fs.vertices.size() == 1)
+            v[1].set(v[0].x + 1, v[0].y);
+
+        auto *material = static_cast<QSGFlatColorMaterial *>(node->material());
+        if (material->color() != fs.color) {
+            material->setColor(fs.color);
+            node->markDirty(QSGNode::DirtyMaterial);
+        }
+        node->markDirty(QSGNode::DirtyGeometry);
+        child = child->nextSibling();
+    }
+    return root;
+}
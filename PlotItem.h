@@ -0,0 +1,69 @@
+#ifndef PLOTITEM_H
+#define PLOTITEM_H
+
+#include <QColor>
+#include <QList>
+#include <QPointer>
+#include <QQuickItem>
+#include <QtQml/qqmlregistration.h>
+#include "SignalExtractor.h"
+
+// SignalExtractor 序列的即時折線圖(scene graph)。
+// - x 軸 = 樣本序號,最新樣本貼齊右緣,顯示最近 windowSamples 筆
+// - min/max-per-pixel 抽樣: 每個像素欄只輸出該欄的最小 / 最大兩個頂點,
+//   頂點數上限 = 2 × 寬度,與取樣率無關
+// - y 軸依可見範圍自動縮放(yMin / yMax 給 QML 畫刻度)
+// - 新樣本只 polish + update,一個 frame 至多重算一次
+class PlotItem : public QQuickItem
+{
+    Q_OBJECT
+    QML_ELEMENT
+    Q_PROPERTY(SignalExtractor *source READ source WRITE setSource NOTIFY sourceChanged)
+    Q_PROPERTY(int windowSamples READ windowSamples WRITE setWindowSamples NOTIFY windowSamplesChanged)
+    Q_PROPERTY(QList<QColor> colors MEMBER m_colors NOTIFY colorsChanged)
+    Q_PROPERTY(qreal lineWidth MEMBER m_lineWidth NOTIFY colorsChanged)
+    Q_PROPERTY(qreal yMin READ yMin NOTIFY rangeChanged)
+    Q_PROPERTY(qreal yMax READ yMax NOTIFY rangeChanged)
+
+public:
+    explicit PlotItem(QQuickItem *parent = nullptr);
+
+    SignalExtractor *source() const { return m_source; }
+    void setSource(SignalExtractor *source);
+    int windowSamples() const { return m_windowSamples; }
+    void setWindowSamples(int samples);
+    qreal yMin() const { return m_yMin; }
+    qreal yMax() const { return m_yMax; }
+
+signals:
+    void sourceChanged();
+    void windowSamplesChanged();
+    void colorsChanged();
+    void rangeChanged();
+
+protected:
+    void updatePolish() override;
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+
+private:
+    void scheduleRefresh();
+
+    struct FrameSeries {
+        QColor color;
+        QList<QPointF> vertices;   // item 座標,line strip
+    };
+
+    QPointer<SignalExtractor> m_source;
+    QMetaObject::Connection m_sourceConnection;
+    int m_windowSamples = 10000;
+    QList<QColor> m_colors;
+    qreal m_lineWidth = 1;
+    qreal m_yMin = 0;
+    qreal m_yMax = 1;
+
+    // updatePolish(GUI thread)產生,updatePaintNode 消費
+    QList<FrameSeries> m_frame;
+};
+
+#endif // PLOTITEM_H
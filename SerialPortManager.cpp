@@ -25,8 +25,8 @@ SerialPortManager::SerialPortManager(QObject *parent)
     m_idleFlushTimer->setSingleShot(true);
     m_idleFlushTimer->setInterval(50);
     connect(m_idleFlushTimer, &QTimer::timeout, this, [this]() {
-        if (!m_rxBuffer.isEmpty())
-            processRxBuffer(true);
+        if (m_splitter.hasPending())
+            flushRxLines();
     });
 
     m_rxNotifyTimer = new QTimer(this);
@@ -36,7 +36,8 @@ SerialPortManager::SerialPortManager(QObject *parent)
         emit rxBytesChanged();
     });
 
-    refreshPorts();
+    // 不在建構時列舉 port(GUI 啟動完成時自行 refreshPorts): headless 多 port 時每個 port 一個實例,
+    // 每次列舉在 Windows 上要數十 ms
 }
 
 SerialPortManager::~SerialPortManager()
@@ -121,7 +122,8 @@ bool SerialPortManager::connectToPort(const QString &portName, int baudRate,
 
     if (m_serialPort->open(QIODevice::ReadWrite)) {
         m_idleFlushTimer->stop();
-        m_rxBuffer.clear();
+        m_splitter.clear();
+        m_rxLineCount = 0;
         m_rxBytes = 0;
         m_txBytes = 0;
         emit rxBytesChanged();
@@ -146,8 +148,8 @@ void SerialPortManager::disconnectPort()
     if (m_serialPort->isOpen()) {
         // Flush any remaining buffered data before closing
         m_idleFlushTimer->stop();
-        if (!m_rxBuffer.isEmpty())
-            processRxBuffer(true);
+        if (m_splitter.hasPending())
+            flushRxLines();
         m_serialPort->close();
         emit connectedChanged();
     }
@@ -169,6 +171,7 @@ bool SerialPortManager::sendData(const QString &data, bool hexMode)
     qint64 written = m_serialPort->write(bytes);
     if (written > 0) {
         m_txBytes += written;
+        emit rawDataSent(written == bytes.size() ? bytes : bytes.left(written));
         emit txBytesChanged();
         return true;
     }
@@ -210,61 +213,20 @@ void SerialPortManager::handleReadyRead()
 
     m_rxBytes += data.size();
     scheduleRxBytesNotify();
+    emit rawDataReceived(data);
 
-    m_rxBuffer.append(data);
-    processRxBuffer(false);
+    m_splitter.feed(data, [this](const QByteArray &line) { emitLine(line); });
 
     // 殘留資料(無換行結尾)在 idle 50ms 後吐出,避免「資料永遠不顯示」
-    if (!m_rxBuffer.isEmpty())
+    if (m_splitter.hasPending())
         m_idleFlushTimer->start();
     else
         m_idleFlushTimer->stop();
 }
 
-// Split buffer by line endings (\r\n, \n, or \r) — 單趟掃描,結尾一次 remove
-void SerialPortManager::processRxBuffer(bool flushAll)
+void SerialPortManager::flushRxLines()
 {
-    int pos = 0;
-    const int size = m_rxBuffer.size();
-    while (pos < size) {
-        int splitPos = -1;
-        int skipLen = 0;
-        for (int i = pos; i < size; ++i) {
-            char c = m_rxBuffer.at(i);
-            if (c == '\n') {
-                splitPos = i;
-                skipLen = 1;
-                break;
-            }
-            if (c == '\r') {
-                if (i + 1 < size) {
-                    splitPos = i;
-                    skipLen = (m_rxBuffer.at(i + 1) == '\n') ? 2 : 1;
-                } else if (flushAll) {
-                    splitPos = i;
-                    skipLen = 1;
-                }
-                // 結尾孤立 \r 且非 flushAll: 可能是 \r\n 被拆包,等下一個 chunk
-                break;
-            }
-        }
-        if (splitPos < 0) {
-            if (size - pos >= MAX_LINE_BYTES) {
-                emitLine(m_rxBuffer.mid(pos, MAX_LINE_BYTES));
-                pos += MAX_LINE_BYTES;
-                continue;
-            }
-            break;
-        }
-        emitLine(m_rxBuffer.mid(pos, splitPos - pos));
-        pos = splitPos + skipLen;
-    }
-    if (pos > 0)
-        m_rxBuffer.remove(0, pos);
-    if (flushAll && !m_rxBuffer.isEmpty()) {
-        emitLine(m_rxBuffer);
-        m_rxBuffer.clear();
-    }
+    m_splitter.flush([this](const QByteArray &line) { emitLine(line); });
 }
 
 void SerialPortManager::scheduleRxBytesNotify()
@@ -278,22 +240,9 @@ void SerialPortManager::emitLine(const QByteArray &lineData)
     if (lineData.isEmpty())
         return;
 
+    ++m_rxLineCount;
     QString timestamp = QDateTime::currentDateTime().toString(QStringLiteral("HH:mm:ss.zzz"));
-
-    // Build ASCII representation, replace non-printable chars with '.'
-    QString asciiStr;
-    asciiStr.reserve(lineData.size());
-    for (int i = 0; i < lineData.size(); ++i) {
-        char c = lineData.at(i);
-        if (c >= 32 && c <= 126)
-            asciiStr += QLatin1Char(c);
-        else
-            asciiStr += QLatin1Char('.');
-    }
-
-    QString hexStr = QString::fromLatin1(lineData.toHex(' ')).toUpper();
-
-    emit dataReceived(timestamp, asciiStr, hexStr);
+    emit dataReceived(timestamp, LineSplitter::asciiText(lineData), LineSplitter::hexText(lineData));
 }
 
 void SerialPortManager::handleError(QSerialPort::SerialPortError error)
@@ -7,6 +7,7 @@
 #include <QStringList>
 #include <QDateTime>
 #include <QTimer>
+#include "LineSplitter.h"
 
 class SerialPortManager : public QObject
 {
@@ -26,6 +27,8 @@ public:
     bool isReconnecting() const;
     qint64 rxBytes() const;
     qint64 txBytes() const;
+    // 連線後已切出的 RX 行數(capture 的 framing index)
+    qint64 rxLineCount() const { return m_rxLineCount; }
 
     Q_INVOKABLE void refreshPorts();
     Q_INVOKABLE bool connectToPort(const QString &portName, int baudRate,
@@ -40,6 +43,8 @@ signals:
     void rxBytesChanged();
     void txBytesChanged();
     void dataReceived(const QString &timestamp, const QString &asciiData, const QString &hexData);
+    void rawDataReceived(const QByteArray &data);   // 切行前的原始 chunk(hex dump / capture 用)
+    void rawDataSent(const QByteArray &data);       // 實際寫出的 bytes(capture 用)
     void errorOccurred(const QString &error);
     void reconnected();          // fires when auto-reconnect succeeds
     void connectionLost();       // fires when device unexpectedly disconnects
@@ -52,15 +57,13 @@ private slots:
 private:
     void emitLine(const QByteArray &lineData);
     void applyPortSettings();
-    void processRxBuffer(bool flushAll);
+    void flushRxLines();
     void scheduleRxBytesNotify();
 
-    // 無換行資料的強制切行上限,避免 binary 資料讓 buffer 無限增長
-    static const int MAX_LINE_BYTES = 4096;
-
     QSerialPort *m_serialPort;
     QStringList m_availablePorts;
-    QByteArray m_rxBuffer;
+    LineSplitter m_splitter;
+    qint64 m_rxLineCount = 0;
     qint64 m_rxBytes;
     qint64 m_txBytes;
 
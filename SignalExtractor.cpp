@@ -0,0 +1,157 @@
+#include "SignalExtractor.h"
+#include <cmath>
+#include <limits>
+
+// key 允許 "imu.ax" 這類點號;數值含正負號、小數與指數
+static const QRegularExpression KEY_VALUE_RE(
+    QStringLiteral("([A-Za-z_][\\w.]*)\\s*[=:]\\s*([-+]?(?:\\d+\\.?\\d*|\\.\\d+)(?:[eE][-+]?\\d+)?)"));
+
+void SignalExtractor::Series::push(float v)
+{
+    ring[head] = v;
+    head = (head + 1) % ring.size();
+    if (size < ring.size())
+        ++size;
+    ++total;
+}
+
+SignalExtractor::SignalExtractor(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void SignalExtractor::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled)
+        return;
+    m_enabled = enabled;
+    emit enabledChanged();
+}
+
+void SignalExtractor::setPattern(const QString &pattern)
+{
+    if (m_pattern == pattern)
+        return;
+    m_pattern = pattern;
+    m_patternError.clear();
+    m_groupNames.clear();
+    m_regex = QRegularExpression();
+
+    if (!pattern.trimmed().isEmpty()) {
+        QRegularExpression re(pattern);
+        if (!re.isValid()) {
+            m_patternError = re.errorString();
+        } else if (re.captureCount() == 0) {
+            m_patternError = QStringLiteral("pattern needs at least one capture group");
+        } else {
+            re.optimize();
+            m_regex = re;
+            const QStringList named = re.namedCaptureGroups();
+            bool anyNamed = false;
+            for (int i = 1; i < named.size(); ++i)
+                anyNamed = anyNamed || !named.at(i).isEmpty();
+            m_groupNames.append(QString());   // group 0 = 整段比對,不取
+            for (int i = 1; i < named.size(); ++i)
+                m_groupNames.append(anyNamed ? named.at(i) : QStringLiteral("g%1").arg(i));
+        }
+    }
+
+    // 換 pattern 後舊序列的語意不同,重新開始
+    clear();
+    emit patternChanged();
+}
+
+void SignalExtractor::setCapacity(int samples)
+{
+    samples = qBound(1000, samples, 1000000);
+    if (m_capacity == samples)
+        return;
+    m_capacity = samples;
+    clear();
+    emit capacityChanged();
+}
+
+QStringList SignalExtractor::seriesNames() const
+{
+    QStringList names;
+    for (const Series &s : m_series)
+        names.append(s.name);
+    return names;
+}
+
+void SignalExtractor::clear()
+{
+    if (m_series.isEmpty())
+        return;
+    m_series.clear();
+    emit seriesChanged();
+    emit samplesAppended();
+}
+
+double SignalExtractor::lastValue(int series) const
+{
+    if (series < 0 || series >= m_series.size() || m_series.at(series).size == 0)
+        return std::numeric_limits<double>::quiet_NaN();
+    const Series &s = m_series.at(series);
+    return s.at(s.size - 1);
+}
+
+int SignalExtractor::seriesIndex(const QString &name)
+{
+    for (int i = 0; i < m_series.size(); ++i) {
+        if (m_series.at(i).name == name)
+            return i;
+    }
+    if (m_series.size() >= MaxSeries)
+        return -1;
+
+    Series s;
+    s.name = name;
+    s.ring.resize(m_capacity);
+    m_series.append(s);
+    emit seriesChanged();
+    return m_series.size() - 1;
+}
+
+void SignalExtractor::push(const QString &name, QStringView text, bool *appended)
+{
+    bool ok = false;
+    const double v = text.toDouble(&ok);
+    if (!ok || !std::isfinite(v))
+        return;
+    const int idx = seriesIndex(name);
+    if (idx < 0)
+        return;
+    m_series[idx].push(float(v));
+    *appended = true;
+}
+
+void SignalExtractor::processBatch(const TerminalBatch &batch)
+{
+    if (!m_enabled || !m_patternError.isEmpty())
+        return;
+
+    const bool custom = !m_groupNames.isEmpty();
+    bool appended = false;
+    for (const TerminalEntry &e : batch) {
+        if (e.type != QLatin1String("rx"))
+            continue;
+        if (custom) {
+            const QRegularExpressionMatch m = m_regex.match(e.msgText);
+            if (!m.hasMatch())
+                continue;
+            for (int g = 1; g < m_groupNames.size(); ++g) {
+                if (!m_groupNames.at(g).isEmpty() && m.hasCaptured(g))
+                    push(m_groupNames.at(g), m.capturedView(g), &appended);
+            }
+        } else {
+            QRegularExpressionMatchIterator it = KEY_VALUE_RE.globalMatch(e.msgText);
+            while (it.hasNext()) {
+                const QRegularExpressionMatch m = it.next();
+                push(m.captured(1), m.capturedView(2), &appended);
+            }
+        }
+    }
+    if (appended)
+        emit samplesAppended();
+}
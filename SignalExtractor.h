@@ -0,0 +1,83 @@
+#ifndef SIGNALEXTRACTOR_H
+#define SIGNALEXTRACTOR_H
+
+#include <QList>
+#include <QObject>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QtQml/qqmlregistration.h>
+#include "TerminalEntry.h"
+
+// 從 RX 行抽出數值序列(給 PlotItem)。
+// - pattern 空白: key=value / key:value(例 "temp=23.4 rpm=1200"),key 即序列名稱
+// - pattern 為 regex: 具名 group 各為一個序列(無具名 group 時依序 g1, g2 ...)
+// - 每個序列一個固定容量 ring buffer(float),記憶體上限 = MaxSeries × capacity
+// - 直接吃 TerminalModel 的 flush 批次(entriesFlushed),不經 QML
+class SignalExtractor : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("SignalExtractor is provided by the application as signalExtractor")
+    Q_PROPERTY(bool enabled READ enabled WRITE setEnabled NOTIFY enabledChanged)
+    Q_PROPERTY(QString pattern READ pattern WRITE setPattern NOTIFY patternChanged)
+    Q_PROPERTY(QString patternError READ patternError NOTIFY patternChanged)
+    Q_PROPERTY(int capacity READ capacity WRITE setCapacity NOTIFY capacityChanged)
+    Q_PROPERTY(QStringList seriesNames READ seriesNames NOTIFY seriesChanged)
+
+public:
+    static constexpr int MaxSeries = 8;
+
+    // 固定容量 ring buffer;index 0 = 目前保留的最舊樣本
+    struct Series {
+        QString name;
+        QList<float> ring;
+        int head = 0;       // 下一個寫入位置
+        int size = 0;
+        qint64 total = 0;   // 累計樣本數(含已被覆蓋的)
+
+        float at(int i) const { return ring.at((head - size + i + ring.size()) % ring.size()); }
+        void push(float v);
+    };
+
+    explicit SignalExtractor(QObject *parent = nullptr);
+
+    bool enabled() const { return m_enabled; }
+    void setEnabled(bool enabled);
+    QString pattern() const { return m_pattern; }
+    void setPattern(const QString &pattern);
+    QString patternError() const { return m_patternError; }
+    int capacity() const { return m_capacity; }
+    void setCapacity(int samples);
+    QStringList seriesNames() const;
+
+    const QList<Series> &series() const { return m_series; }
+
+    Q_INVOKABLE void clear();
+    // 序列最新一筆(沒有資料 = NaN)
+    Q_INVOKABLE double lastValue(int series) const;
+
+public slots:
+    void processBatch(const TerminalBatch &batch);
+
+signals:
+    void enabledChanged();
+    void patternChanged();
+    void capacityChanged();
+    void seriesChanged();
+    // 本批有新樣本(每次 flush 至多一次)
+    void samplesAppended();
+
+private:
+    int seriesIndex(const QString &name);
+    void push(const QString &name, QStringView text, bool *appended);
+
+    bool m_enabled = false;
+    QString m_pattern;
+    QString m_patternError;
+    QRegularExpression m_regex;
+    QStringList m_groupNames;   // regex 模式: group i 對應的序列名稱(空 = 不取)
+    int m_capacity = 100000;
+    QList<Series> m_series;
+};
+
+#endif // SIGNALEXTRACTOR_H
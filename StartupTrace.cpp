@@ -0,0 +1,68 @@
+#include "StartupTrace.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QQuickWindow>
+#include <cstdio>
+
+static double toMs(qint64 ns)
+{
+    return ns / 1e6;
+}
+
+static void printJson(const QJsonObject &obj)
+{
+    printf("%s\n", QJsonDocument(obj).toJson(QJsonDocument::Compact).constData());
+    fflush(stdout);
+}
+
+StartupTrace::StartupTrace(bool enabled, QObject *parent)
+    : QObject(parent)
+    , m_enabled(enabled)
+{
+    m_clock.start();
+}
+
+void StartupTrace::mark(const QString &phase)
+{
+    if (!m_enabled || m_finished)
+        return;
+
+    const qint64 now = m_clock.nsecsElapsed();
+    const qint64 delta = now - m_lastNs;
+    m_lastNs = now;
+    m_phases.append({ phase, delta });
+
+    QJsonObject obj;
+    obj[QStringLiteral("event")] = QStringLiteral("startup");
+    obj[QStringLiteral("phase")] = phase;
+    obj[QStringLiteral("ms")] = toMs(now);
+    obj[QStringLiteral("delta_ms")] = toMs(delta);
+    printJson(obj);
+}
+
+void StartupTrace::attachWindow(QQuickWindow *window)
+{
+    if (!m_enabled || !window)
+        return;
+    // frameSwapped 在 render thread 發出: queued 回 GUI thread,只取第一次
+    connect(window, &QQuickWindow::frameSwapped, this, &StartupTrace::finish,
+            static_cast<Qt::ConnectionType>(Qt::QueuedConnection | Qt::SingleShotConnection));
+}
+
+void StartupTrace::finish()
+{
+    if (m_finished)
+        return;
+    mark(QStringLiteral("first_frame"));
+    m_finished = true;
+
+    QJsonObject phases;
+    for (const auto &p : std::as_const(m_phases))
+        phases[p.first] = toMs(p.second);
+    QJsonObject obj;
+    obj[QStringLiteral("event")] = QStringLiteral("startup");
+    obj[QStringLiteral("phase")] = QStringLiteral("total");
+    obj[QStringLiteral("ms")] = toMs(m_lastNs);
+    obj[QStringLiteral("phases")] = phases;
+    printJson(obj);
+}
@@ -0,0 +1,38 @@
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QPair>
+#include <QString>
+
+class QQuickWindow;
+
+// --startup-trace: 冷啟動各階段耗時(到第一個 frame 為止)。
+// 每個 mark 印一行 JSONL 到 stdout,第一個 frameSwapped 時印總表:
+//   {"event":"startup","phase":"qml_create","ms":812.4,"delta_ms":640.1}
+//   {"event":"startup","phase":"first_frame","ms":930.2,"phases":{...}}
+// 未啟用時 mark 為 no-op(QML 端可無條件呼叫)
+class StartupTrace : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StartupTrace(bool enabled, QObject *parent = nullptr);
+
+    bool isEnabled() const { return m_enabled; }
+    Q_INVOKABLE void mark(const QString &phase);
+    void attachWindow(QQuickWindow *window);
+
+private:
+    void finish();
+
+    bool m_enabled;
+    bool m_finished = false;
+    QElapsedTimer m_clock;
+    qint64 m_lastNs = 0;
+    QList<QPair<QString, qint64>> m_phases;   // (phase, delta ns)
+};
+
+#endif // STARTUPTRACE_H
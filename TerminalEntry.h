@@ -0,0 +1,42 @@
+#ifndef TERMINALENTRY_H
+#define TERMINALENTRY_H
+
+#include <QLatin1String>
+#include <QList>
+#include <QString>
+
+// 終端機一行(TerminalModel 儲存單位;flush 時整批以 QList 直接交給 FileLogger,字串隱式共用)
+struct TerminalEntry {
+    QString timestamp;   // 顯示用 "HH:mm:ss.zzz"
+    QString msgText;
+    QString hexData;
+    QString type;        // "rx" | "tx" | "system" | "error"
+    int     entryIndex;  // 全域遞增,clear 後歸零
+    QString hlColor;     // 命中的第一個 keyword 色彩(scroll bar 標記用),空=未命中
+};
+
+using TerminalBatch = QList<TerminalEntry>;
+
+// 顯示 / 複製 / log 共用的行首 prefix
+inline QLatin1String terminalPrefix(const QString &type)
+{
+    if (type == QLatin1String("rx"))     return QLatin1String("RX> ");
+    if (type == QLatin1String("tx"))     return QLatin1String("TX> ");
+    if (type == QLatin1String("system")) return QLatin1String("SYS> ");
+    if (type == QLatin1String("error"))  return QLatin1String("ERR> ");
+    return QLatin1String("> ");
+}
+
+// 複製 / 匯出選取列的一行版面
+inline void appendEntryLine(QString &out, const TerminalEntry &e, bool timestamp, bool prefix, bool hexMode)
+{
+    if (timestamp) {
+        out += e.timestamp;
+        out += QLatin1Char(' ');
+    }
+    if (prefix)
+        out += terminalPrefix(e.type);
+    out += (hexMode && !e.hexData.isEmpty()) ? e.hexData : e.msgText;
+}
+
+#endif // TERMINALENTRY_H
@@ -0,0 +1,460 @@
+#include "TerminalExporter.h"
+#include <QFile>
+#include <QMutex>
+#include <QStringEncoder>
+#include <QThread>
+#include <QUrl>
+#include <QWaitCondition>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include "JsonlWriter.h"
+#include "MappedLogModel.h"
+
+static const int CHUNK_ENTRIES = 4096;      // GUI thread 每次交給 worker 的 entry 數
+static const int MAX_IN_FLIGHT = 2;         // 同時在 worker 手上的段數(其餘留在 m_all,不另存)
+static const qsizetype WRITE_BYTES = 1 << 20;
+
+class TerminalExportWorker : public QThread
+{
+public:
+    enum Format { Text, Jsonl, Csv };
+
+    TerminalExportWorker(TerminalExporter *exporter, std::unique_ptr<QFile> file, Format format,
+                         const TerminalFilter &filter, const QList<TerminalSelection::Range> &ranges,
+                         bool selectionOnly, bool timestamp, bool prefix, bool hexMode,
+                         std::unique_ptr<MappedLogReader> reader = nullptr,
+                         const QList<TerminalSelection::Range> &spans = {})
+        : m_exporter(exporter)
+        , m_file(std::move(file))
+        , m_format(format)
+        , m_filter(filter)
+        , m_ranges(ranges)
+        , m_selectionOnly(selectionOnly)
+        , m_timestamp(timestamp)
+        , m_prefix(prefix)
+        , m_hexMode(hexMode)
+        , m_reader(std::move(reader))
+        , m_spans(spans)
+    {
+    }
+
+    void push(const TerminalBatch &chunk)
+    {
+        QMutexLocker lock(&m_mutex);
+        m_queue.append(chunk);
+        m_wake.wakeOne();
+    }
+
+    // 不再有新的段: 處理完佇列即結束
+    void finish()
+    {
+        QMutexLocker lock(&m_mutex);
+        m_end = true;
+        m_wake.wakeOne();
+    }
+
+    // 已排入的段丟棄,已格式化的照樣寫出
+    void cancel()
+    {
+        QMutexLocker lock(&m_mutex);
+        m_cancel = true;
+        m_wake.wakeOne();
+    }
+
+protected:
+    void run() override;
+
+private:
+    QString drainQueue();
+    QString decodeMapped();
+    bool processChunk(TerminalBatch &chunk, QString *error);
+    bool cancelled();
+    bool selected(int entryIndex);
+    void appendEntry(const TerminalEntry &e);
+    void appendUtf8(QStringView text);
+    bool writeOut();
+
+    TerminalExporter *m_exporter;
+    std::unique_ptr<QFile> m_file;
+    const Format m_format;
+    const TerminalFilter m_filter;
+    const QList<TerminalSelection::Range> m_ranges;
+    const bool m_selectionOnly;
+    const bool m_timestamp;
+    const bool m_prefix;
+    const bool m_hexMode;
+    // 開啟的 log: worker 依 m_spans(檔內列號區間)自行解碼,不經 m_queue
+    const std::unique_ptr<MappedLogReader> m_reader;
+    const QList<TerminalSelection::Range> m_spans;
+
+    QMutex m_mutex;
+    QWaitCondition m_wake;
+    QList<TerminalBatch> m_queue;
+    bool m_end = false;
+    bool m_cancel = false;
+
+    qsizetype m_range = 0;   // entry 依 entryIndex 遞增,選取區間只需往前走
+    QByteArray m_buf;
+    QString m_line;
+    QStringEncoder m_encoder { QStringConverter::Utf8 };
+    JsonlWriter m_json;
+};
+
+bool TerminalExportWorker::selected(int entryIndex)
+{
+    while (m_range < m_ranges.size() && m_ranges.at(m_range).hi < entryIndex)
+        ++m_range;
+    return m_range < m_ranges.size() && m_ranges.at(m_range).lo <= entryIndex;
+}
+
+void TerminalExportWorker::appendUtf8(QStringView text)
+{
+    const qsizetype used = m_buf.size();
+    m_buf.resize(used + m_encoder.requiredSpace(text.size()));
+    char *end = m_encoder.appendToBuffer(m_buf.data() + used, text);
+    m_buf.resize(end - m_buf.constData());
+}
+
+// RFC 4180: 含逗號 / 引號 / 換行的欄位加引號,引號重複一次
+static void appendCsvField(QString &out, const QString &value)
+{
+    if (!value.contains(QLatin1Char(',')) && !value.contains(QLatin1Char('"'))
+        && !value.contains(QLatin1Char('\n')) && !value.contains(QLatin1Char('\r'))) {
+        out += value;
+        return;
+    }
+    out += QLatin1Char('"');
+    for (QChar c : value) {
+        if (c == QLatin1Char('"'))
+            out += QLatin1Char('"');
+        out += c;
+    }
+    out += QLatin1Char('"');
+}
+
+void TerminalExportWorker::appendEntry(const TerminalEntry &e)
+{
+    switch (m_format) {
+    case Text:
+        m_line.clear();
+        appendEntryLine(m_line, e, m_timestamp, m_prefix, m_hexMode);
+        m_line += QLatin1Char('\n');
+        appendUtf8(m_line);
+        break;
+    case Jsonl:
+        // entry 只有顯示用的時間(無日期),ts 照原樣輸出;seq = entryIndex
+        m_json.clear();
+        m_json.begin();
+        m_json.field("ts", e.timestamp);
+        m_json.field("seq", e.entryIndex);
+        m_json.field("type", e.type);
+        m_json.field("ascii", e.msgText);
+        if (!e.hexData.isEmpty())
+            m_json.field("hex", e.hexData);
+        m_json.end();
+        m_buf += m_json.data();
+        break;
+    case Csv:
+        m_line.clear();
+        appendCsvField(m_line, e.timestamp);
+        m_line += QLatin1Char(',');
+        m_line += QString::number(e.entryIndex);
+        m_line += QLatin1Char(',');
+        appendCsvField(m_line, e.type);
+        m_line += QLatin1Char(',');
+        appendCsvField(m_line, e.msgText);
+        m_line += QLatin1Char(',');
+        appendCsvField(m_line, e.hexData);
+        m_line += QLatin1String("\r\n");
+        appendUtf8(m_line);
+        break;
+    }
+}
+
+bool TerminalExportWorker::writeOut()
+{
+    if (m_buf.isEmpty())
+        return true;
+    const bool ok = m_file->write(m_buf) == m_buf.size();
+    m_buf.resize(0);
+    return ok;
+}
+
+// 一段 entry: filter / 選取 → 格式化,滿 WRITE_BYTES 寫出後回報 GUI thread
+bool TerminalExportWorker::processChunk(TerminalBatch &chunk, QString *error)
+{
+    int lines = 0;
+    for (const TerminalEntry &e : std::as_const(chunk)) {
+        if (m_filter.isActive() && !m_filter.matches(e))
+            continue;
+        if (m_selectionOnly && !selected(e.entryIndex))
+            continue;
+        appendEntry(e);
+        ++lines;
+    }
+    const int nextIndex = chunk.isEmpty() ? 0 : chunk.constLast().entryIndex + 1;
+    chunk.clear();   // 先放掉字串參照再要下一段
+
+    if (m_buf.size() >= WRITE_BYTES && !writeOut()) {
+        *error = m_file->errorString();
+        return false;
+    }
+    QMetaObject::invokeMethod(m_exporter, [exporter = m_exporter, lines, nextIndex] {
+        exporter->onChunkDone(lines, nextIndex);
+    }, Qt::QueuedConnection);
+    return true;
+}
+
+bool TerminalExportWorker::cancelled()
+{
+    QMutexLocker lock(&m_mutex);
+    return m_cancel;
+}
+
+// 即時 buffer: 處理 GUI thread 送來的段,直到 finish / cancel
+QString TerminalExportWorker::drainQueue()
+{
+    QString error;
+    for (;;) {
+        TerminalBatch chunk;
+        {
+            QMutexLocker lock(&m_mutex);
+            while (m_queue.isEmpty() && !m_end && !m_cancel)
+                m_wake.wait(&m_mutex);
+            if (m_cancel || m_queue.isEmpty())
+                break;
+            chunk = m_queue.takeFirst();
+        }
+        if (!processChunk(chunk, &error))
+            break;
+    }
+    return error;
+}
+
+// 開啟的 log: 逐區間從 checkpoint 解碼,每 CHUNK_ENTRIES 列處理一次並檢查取消
+QString TerminalExportWorker::decodeMapped()
+{
+    QString error;
+    TerminalBatch chunk;
+    chunk.reserve(CHUNK_ENTRIES);
+    TerminalEntry e;
+    for (const TerminalSelection::Range &span : m_spans) {
+        m_reader->seek(span.lo);
+        while (m_reader->next(&e) && e.entryIndex <= span.hi) {
+            chunk.append(e);
+            if (chunk.size() < CHUNK_ENTRIES)
+                continue;
+            if (cancelled() || !processChunk(chunk, &error))
+                return error;
+        }
+    }
+    if (!chunk.isEmpty() && !cancelled())
+        processChunk(chunk, &error);
+    return error;
+}
+
+void TerminalExportWorker::run()
+{
+    m_buf.reserve(WRITE_BYTES + 64 * 1024);
+    if (m_format == Csv)
+        appendUtf8(u"timestamp,index,type,ascii,hex\r\n");
+
+    QString error = m_reader ? decodeMapped() : drainQueue();
+    if (error.isEmpty() && (!writeOut() || !m_file->flush()))
+        error = m_file->errorString();
+    m_file->close();
+    QMetaObject::invokeMethod(m_exporter, [exporter = m_exporter, error] {
+        exporter->onWorkerDone(error);
+    }, Qt::QueuedConnection);
+}
+
+TerminalExporter::TerminalExporter(TerminalModel *model, MappedLogModel *mappedLog, QObject *parent)
+    : QObject(parent)
+    , m_model(model)
+    , m_mappedLog(mappedLog)
+{
+    // entryIndex 在 clear 後歸零,游標不再有意義: 已送出的寫完就結束
+    connect(m_model, &TerminalModel::storeCleared, this, [this]() {
+        if (m_worker && !m_mapped)
+            stopFeeding();
+    });
+    // 關檔前 worker 必須離開映射區: 同步取消並等它結束,結果照常由 onWorkerDone 回報
+    connect(m_mappedLog, &MappedLogModel::aboutToClose, this, [this]() {
+        if (m_worker && m_mapped) {
+            m_fed = true;
+            m_worker->cancel();
+            m_worker->wait();
+        }
+    });
+}
+
+TerminalExporter::~TerminalExporter()
+{
+    if (m_worker) {
+        m_worker->cancel();
+        m_worker->wait();
+        delete m_worker;
+    }
+}
+
+qreal TerminalExporter::progress() const
+{
+    if (!m_worker || m_fed || m_lastIndex < m_firstIndex)
+        return m_worker ? 1.0 : 0.0;
+    const qreal span = qreal(m_lastIndex) - m_firstIndex + 1;
+    return qBound(0.0, (m_cursor - m_firstIndex) / span, 1.0);
+}
+
+bool TerminalExporter::start(const QString &filePath, const QString &scope, const QString &format,
+                             bool timestamp, bool prefix, bool hexMode)
+{
+    if (m_worker)
+        return false;
+
+    // QML FileDialog 給的是 file:// URL
+    const QString localPath = filePath.startsWith(QLatin1String("file:"))
+        ? QUrl(filePath).toLocalFile() : filePath;
+    QString fmt = format;
+    if (fmt.isEmpty()) {
+        if (localPath.endsWith(QLatin1String(".jsonl"), Qt::CaseInsensitive))
+            fmt = QStringLiteral("jsonl");
+        else if (localPath.endsWith(QLatin1String(".csv"), Qt::CaseInsensitive))
+            fmt = QStringLiteral("csv");
+    }
+    const TerminalExportWorker::Format workerFormat =
+        fmt == QLatin1String("jsonl") ? TerminalExportWorker::Jsonl
+        : fmt == QLatin1String("csv") ? TerminalExportWorker::Csv
+        : TerminalExportWorker::Text;
+
+    // 只有 text 沿用平台換行;JSONL 固定 \n,CSV 固定 \r\n
+    auto file = std::make_unique<QFile>(localPath);
+    QIODevice::OpenMode mode = QIODevice::WriteOnly | QIODevice::Truncate;
+    if (workerFormat == TerminalExportWorker::Text)
+        mode |= QIODevice::Text;
+    if (!file->open(mode)) {
+        emit finished(0, localPath, file->errorString());
+        return false;
+    }
+
+    const bool all = scope == QLatin1String("all");
+    m_mapped = m_mappedLog->isActive();
+    m_selectionOnly = scope == QLatin1String("selection");
+    m_fed = false;
+    m_inFlight = 0;
+    m_lines = 0;
+    m_path = localPath;
+
+    if (m_mapped) {
+        // entryIndex = 檔內列號;worker 只解碼要匯出的區間(全檔 = 一個到檔尾的區間)
+        m_ranges = m_selectionOnly ? m_mappedLog->selection()->ranges() : QList<TerminalSelection::Range>();
+        const QList<TerminalSelection::Range> spans = m_selectionOnly
+            ? m_ranges : QList<TerminalSelection::Range>{ { 0, std::numeric_limits<int>::max() } };
+        m_firstIndex = spans.isEmpty() ? 0 : spans.first().lo;
+        m_lastIndex = m_selectionOnly ? (spans.isEmpty() ? -1 : spans.last().hi)
+                                      : m_mappedLog->totalCount() - 1;
+        m_worker = new TerminalExportWorker(this, std::move(file), workerFormat,
+                                            all ? TerminalFilter() : m_mappedLog->filter(), m_ranges,
+                                            m_selectionOnly, timestamp, prefix, hexMode,
+                                            m_mappedLog->createReader(), spans);
+    } else {
+        m_ranges = m_selectionOnly ? m_model->selection()->ranges() : QList<TerminalSelection::Range>();
+        const TerminalBatch &entries = m_model->entries();
+        m_firstIndex = entries.isEmpty() ? 0 : entries.first().entryIndex;
+        m_lastIndex = entries.isEmpty() ? -1 : entries.last().entryIndex;
+        m_worker = new TerminalExportWorker(this, std::move(file), workerFormat,
+                                            all ? TerminalFilter() : m_model->filter(), m_ranges,
+                                            m_selectionOnly, timestamp, prefix, hexMode);
+    }
+    m_cursor = m_firstIndex;
+    m_worker->start(QThread::LowPriority);
+    emit runningChanged();
+    emit progressChanged();
+    feed();
+    return true;
+}
+
+void TerminalExporter::cancel()
+{
+    if (m_worker) {
+        m_fed = true;
+        m_worker->cancel();
+    }
+}
+
+bool TerminalExporter::nextChunk(TerminalBatch &chunk)
+{
+    if (m_cursor > m_lastIndex)
+        return false;
+
+    // selection: 直接跳到下一個區間,區間之間的列不必經過 worker
+    if (m_selectionOnly) {
+        auto r = std::lower_bound(m_ranges.cbegin(), m_ranges.cend(), m_cursor,
+                                  [](const TerminalSelection::Range &range, int v) { return range.hi < v; });
+        if (r == m_ranges.cend())
+            return false;
+        m_cursor = qMax(m_cursor, r->lo);
+    }
+
+    // 依 entryIndex 重新定位(期間可能被修剪,索引會平移)
+    const TerminalBatch &entries = m_model->entries();
+    auto byIndex = [](const TerminalEntry &e, int v) { return e.entryIndex < v; };
+    auto from = std::lower_bound(entries.cbegin(), entries.cend(), m_cursor, byIndex);
+    auto to = std::lower_bound(from, entries.cend(), m_lastIndex + 1, byIndex);
+    if (from == to)
+        return false;
+    to = from + qMin<qsizetype>(to - from, CHUNK_ENTRIES);
+    chunk = entries.mid(from - entries.cbegin(), to - from);
+    m_cursor = chunk.constLast().entryIndex + 1;
+    return true;
+}
+
+void TerminalExporter::feed()
+{
+    while (m_worker && !m_mapped && !m_fed && m_inFlight < MAX_IN_FLIGHT) {
+        TerminalBatch chunk;
+        if (!nextChunk(chunk)) {
+            stopFeeding();
+            break;
+        }
+        m_worker->push(chunk);
+        ++m_inFlight;
+    }
+}
+
+void TerminalExporter::stopFeeding()
+{
+    if (m_fed)
+        return;
+    m_fed = true;
+    m_worker->finish();
+    emit progressChanged();
+}
+
+void TerminalExporter::onChunkDone(int lines, int nextIndex)
+{
+    if (!m_worker)
+        return;
+    m_lines += lines;
+    if (m_mapped) {
+        // 進度依 worker 解到的列號
+        m_cursor = qMax(m_cursor, nextIndex);
+        emit progressChanged();
+        return;
+    }
+    --m_inFlight;
+    emit progressChanged();
+    feed();
+}
+
+void TerminalExporter::onWorkerDone(const QString &error)
+{
+    m_worker->wait();
+    delete m_worker;
+    m_worker = nullptr;
+    m_fed = true;
+    m_ranges.clear();
+    emit runningChanged();
+    emit progressChanged();
+    emit finished(m_lines, m_path, error);
+}
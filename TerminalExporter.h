@@ -0,0 +1,80 @@
+#ifndef TERMINALEXPORTER_H
+#define TERMINALEXPORTER_H
+
+#include <QObject>
+#include <QString>
+#include <QtQml/qqmlregistration.h>
+#include "TerminalEntry.h"
+#include "TerminalModel.h"
+#include "TerminalSelection.h"
+
+class MappedLogModel;
+class TerminalExportWorker;
+
+// 把 TerminalModel 的 buffer 串流匯出到檔案(取代逐列組 QVariantMap 的做法)。
+// - scope: "all" 全部 entry / "visible" 通過目前 filter 的列 / "selection" 可見且被選取的列
+// - format: "text"(與複製相同版面)/ "jsonl" / "csv"
+// - GUI thread 每次只從 m_all 複製一段(數千筆,字串隱式共用)交給 worker,
+//   worker 處理完才要下一段: 同時在途的最多兩段,記憶體固定不隨 buffer 成長
+// - 範圍在開始時決定(filter / 選取 / 最後一筆 entryIndex 取快照),之後收到的行不匯出;
+//   匯出中被修剪掉的列略過,clear 則提前結束
+// - 開啟的 log(MappedLogModel active)由 worker 自己從映射的檔案解碼,GUI thread 不碰 entry;
+//   範圍同樣以開始時的 filter / 選取為準,關檔時中止
+class TerminalExporter : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("TerminalExporter is provided by the application as terminalExporter")
+    Q_PROPERTY(bool running READ isRunning NOTIFY runningChanged)
+    Q_PROPERTY(qreal progress READ progress NOTIFY progressChanged)
+    Q_PROPERTY(int exportedLines READ exportedLines NOTIFY progressChanged)
+    Q_PROPERTY(QString path READ path NOTIFY runningChanged)
+
+public:
+    TerminalExporter(TerminalModel *model, MappedLogModel *mappedLog, QObject *parent = nullptr);
+    ~TerminalExporter() override;
+
+    bool isRunning() const { return m_worker != nullptr; }
+    qreal progress() const;
+    int exportedLines() const { return m_lines; }
+    QString path() const { return m_path; }
+
+    // filePath 可為 file:// URL;format 空字串時依副檔名(.jsonl / .csv,其他為 text)。
+    // 開檔失敗或已在匯出中回傳 false(錯誤見 finished)
+    Q_INVOKABLE bool start(const QString &filePath, const QString &scope, const QString &format,
+                           bool timestamp, bool prefix, bool hexMode);
+    Q_INVOKABLE void cancel();
+
+signals:
+    void runningChanged();
+    void progressChanged();
+    // error 空字串 = 成功(取消也算成功,lines 為已寫出的列數)
+    void finished(int lines, const QString &path, const QString &error);
+
+private:
+    friend class TerminalExportWorker;
+
+    // worker → GUI thread(queued)
+    void onChunkDone(int lines, int nextIndex);
+    void onWorkerDone(const QString &error);
+
+    void feed();
+    bool nextChunk(TerminalBatch &chunk);
+    void stopFeeding();
+
+    TerminalModel *m_model;
+    MappedLogModel *m_mappedLog;
+    TerminalExportWorker *m_worker = nullptr;
+    bool m_mapped = false;      // 這次匯出的是開啟的 log(worker 自行解碼,不必 feed)
+    QString m_path;
+    bool m_selectionOnly = false;
+    QList<TerminalSelection::Range> m_ranges;   // 開始時的選取快照
+    int m_firstIndex = 0;
+    int m_lastIndex = -1;       // 範圍: entryIndex [m_firstIndex, m_lastIndex]
+    int m_cursor = 0;           // 下一段的起點 entryIndex
+    bool m_fed = false;         // 已送出結尾
+    int m_inFlight = 0;         // 已送出、worker 尚未處理完的段數
+    int m_lines = 0;
+};
+
+#endif // TERMINALEXPORTER_H
@@ -1,7 +1,19 @@
 #include "TerminalModel.h"
+#include "TerminalSampleModel.h"
+#include <QClipboard>
+#include <QGuiApplication>
+#include <QQuickWindow>
 #include <QRegularExpression>
+#include <algorithm>
 
 static const int FLUSH_INTERVAL_MS = 16;
+static const int FRAME_FALLBACK_MS = 100;       // FrameFlush 時視窗不出圖(最小化)的兜底
+static const int FRAME_BATCH_MIN = 256;
+static const int FRAME_BATCH_MAX = 20000;
+static const qint64 FRAME_IDLE_NS = 100000000;  // 超過 100ms 的間隔視為閒置,不列入 frame 時間
+static const int RUN_CACHE_LIMIT = 4096;
+static const int RATE_INTERVAL_MS = 500;
+static const int FLOOD_SAMPLE_INTERVAL_MS = 100;   // 取樣畫面最多 10 Hz 更新,人眼還跟得上
 
 TerminalModel::TerminalModel(QObject *parent)
     : QAbstractListModel(parent)
@@ -9,6 +21,173 @@ TerminalModel::TerminalModel(QObject *parent)
     m_flushTimer.setSingleShot(true);
     m_flushTimer.setInterval(FLUSH_INTERVAL_MS);
     connect(&m_flushTimer, &QTimer::timeout, this, &TerminalModel::flushPending);
+    m_frameBatchLimit = FRAME_BATCH_MAX;
+
+    m_rateTimer.setInterval(RATE_INTERVAL_MS);
+    connect(&m_rateTimer, &QTimer::timeout, this, &TerminalModel::updateLineRate);
+    m_floodSample = new TerminalSampleModel(this);
+}
+
+QAbstractItemModel *TerminalModel::floodSample() const
+{
+    return m_floodSample;
+}
+
+void TerminalModel::setFloodThreshold(int linesPerSecond)
+{
+    linesPerSecond = qMax(0, linesPerSecond);
+    if (m_floodThreshold == linesPerSecond)
+        return;
+    m_floodThreshold = linesPerSecond;
+    emit floodThresholdChanged();
+    if (m_floodThreshold == 0)
+        setFlooding(false);
+}
+
+void TerminalModel::setFloodSampleRows(int rows)
+{
+    rows = qMax(1, rows);
+    if (m_floodSampleRows == rows)
+        return;
+    m_floodSampleRows = rows;
+    emit floodSampleRowsChanged();
+    if (m_flooding)
+        refreshFloodSample();
+}
+
+void TerminalModel::setFollowTail(bool follow)
+{
+    if (m_followTail == follow)
+        return;
+    const bool wasSampling = sampling();
+    m_followTail = follow;
+    emit followTailChanged();
+    if (sampling() != wasSampling)
+        emit samplingChanged();
+}
+
+void TerminalModel::updateLineRate()
+{
+    const qint64 elapsed = qMax<qint64>(1, m_rateClock.restart());
+    const int rate = int(qint64(m_rateCount) * 1000 / elapsed);
+    m_rateCount = 0;
+    if (rate != m_lineRate) {
+        m_lineRate = rate;
+        emit lineRateChanged();
+    }
+
+    // 進出門檻有遲滯,避免在門檻附近來回切換
+    if (m_floodThreshold > 0 && rate >= m_floodThreshold)
+        setFlooding(true);
+    else if (rate < m_floodThreshold * 7 / 10 || m_floodThreshold == 0)
+        setFlooding(false);
+
+    if (rate == 0 && !m_flooding)
+        m_rateTimer.stop();
+}
+
+void TerminalModel::setFlooding(bool flooding)
+{
+    if (m_flooding == flooding)
+        return;
+    const bool wasSampling = sampling();
+    m_flooding = flooding;
+    if (m_flooding)
+        refreshFloodSample();
+    emit floodingChanged();
+    if (sampling() != wasSampling)
+        emit samplingChanged();
+}
+
+void TerminalModel::refreshFloodSample()
+{
+    const int n = qMin(m_floodSampleRows, int(m_visible.size()));
+    QList<TerminalEntry> sample;
+    sample.reserve(n);
+    for (int row = m_visible.size() - n; row < m_visible.size(); ++row)
+        sample.append(m_all.at(m_visible.at(row)));
+    m_floodSample->setEntries(sample);
+    m_sampleClock.start();
+}
+
+void TerminalModel::setFlushMode(FlushMode mode)
+{
+    if (m_flushMode == mode)
+        return;
+    m_flushMode = mode;
+    m_frameRequested = false;
+    m_lastFrameNs = 0;
+    emit flushModeChanged();
+    if (!m_pending.isEmpty()) {
+        m_flushTimer.stop();
+        scheduleFlush();
+    }
+}
+
+void TerminalModel::attachWindow(QQuickWindow *window)
+{
+    disconnect(m_frameConnection);
+    m_window = window;
+    if (!m_window) {
+        setFlushMode(TimerFlush);
+        return;
+    }
+    // afterAnimating 在 GUI thread、sync 之前發出: 此時提交的列正好趕上這一個 frame
+    m_frameConnection = connect(m_window, &QQuickWindow::afterAnimating,
+                                this, &TerminalModel::onWindowFrame);
+    m_frameClock.start();
+    setFlushMode(FrameFlush);
+}
+
+void TerminalModel::scheduleFlush()
+{
+    if (m_flushMode == FrameFlush && m_window) {
+        if (!m_frameRequested) {
+            m_frameRequested = true;
+            m_window->requestUpdate();
+        }
+        if (!m_flushTimer.isActive())
+            m_flushTimer.start(FRAME_FALLBACK_MS);
+        return;
+    }
+    if (!m_flushTimer.isActive())
+        m_flushTimer.start(FLUSH_INTERVAL_MS);
+}
+
+void TerminalModel::onWindowFrame()
+{
+    m_frameRequested = false;
+    if (m_flushMode != FrameFlush)
+        return;
+
+    const qint64 now = m_frameClock.nsecsElapsed();
+    if (m_lastFrameNs > 0) {
+        const qint64 interval = now - m_lastFrameNs;
+        if (interval < FRAME_IDLE_NS)
+            m_frameIntervalNs = (m_frameIntervalNs * 7 + interval) / 8;
+    }
+    m_lastFrameNs = now;
+
+    if (m_pending.isEmpty())
+        return;
+    m_flushTimer.stop();
+
+    // 積壓超過 buffer 上限時整批提交(多出的部分反正會被修剪,但 log 仍需看到每一筆)
+    const int batch = m_pending.size() > m_maxLines ? m_pending.size()
+                                                    : qMin<int>(m_pending.size(), m_frameBatchLimit);
+    QElapsedTimer cost;
+    cost.start();
+    flushBatch(batch);
+    const qint64 costNs = qMax<qint64>(1, cost.nsecsElapsed());
+
+    // 提交成本控制在 frame 時間的 1/4 以內,其餘留給 layout / render
+    const qint64 budgetNs = m_frameIntervalNs / 4;
+    const qint64 fit = qint64(batch) * budgetNs / costNs;
+    const int target = int(qBound<qint64>(FRAME_BATCH_MIN, fit, FRAME_BATCH_MAX));
+    m_frameBatchLimit = (m_frameBatchLimit * 3 + target) / 4;
+
+    if (!m_pending.isEmpty())
+        scheduleFlush();
 }
 
 int TerminalModel::rowCount(const QModelIndex &parent) const
@@ -23,18 +202,63 @@ QVariant TerminalModel::data(const QModelIndex &index, int role) const
     if (!index.isValid() || index.row() < 0 || index.row() >= m_visible.size())
         return QVariant();
 
-    const TerminalEntry &e = m_all.at(m_visible.at(index.row()));
+    return entryData(m_all.at(m_visible.at(index.row())), role);
+}
+
+QHash<int, QByteArray> TerminalModel::roleNames() const
+{
+    return entryRoleNames();
+}
+
+QVariant TerminalModel::entryData(const TerminalEntry &e, int role) const
+{
     switch (role) {
     case TimestampRole:  return e.timestamp;
     case MsgTextRole:    return e.msgText;
     case HexDataRole:    return e.hexData;
     case TypeRole:       return e.type;
     case EntryIndexRole: return e.entryIndex;
+    case StyleRunsRole:  return QVariant::fromValue(cachedRuns(e));
+    case LineColorRole:  return m_styler.lineColor(m_styler.displayText(e));
     default:             return QVariant();
     }
 }
 
-QHash<int, QByteArray> TerminalModel::roleNames() const
+QList<int> TerminalModel::cachedRuns(const TerminalEntry &e) const
+{
+    auto it = m_runCache.constFind(e.entryIndex);
+    if (it != m_runCache.constEnd())
+        return it.value();
+    if (m_runCache.size() >= RUN_CACHE_LIMIT)
+        m_runCache.clear();
+    const QList<int> runs = m_styler.runs(m_styler.displayText(e));
+    m_runCache.insert(e.entryIndex, runs);
+    return runs;
+}
+
+void TerminalModel::invalidateStyles()
+{
+    m_runCache.clear();
+    if (!m_visible.isEmpty())
+        emit dataChanged(index(0), index(m_visible.size() - 1), { StyleRunsRole, LineColorRole });
+    emit styleChanged();
+}
+
+void TerminalModel::setColorNumbers(bool enabled)
+{
+    if (m_styler.colorNumbers() == enabled)
+        return;
+    m_styler.setColorNumbers(enabled);
+    invalidateStyles();
+}
+
+void TerminalModel::setSearchHighlight(const QString &query, bool isRegex)
+{
+    m_styler.setSearch(query, isRegex);
+    invalidateStyles();
+}
+
+QHash<int, QByteArray> TerminalModel::entryRoleNames()
 {
     return {
         { TimestampRole,  QByteArrayLiteral("timestamp") },
@@ -42,6 +266,8 @@ QHash<int, QByteArray> TerminalModel::roleNames() const
         { HexDataRole,    QByteArrayLiteral("hexData") },
         { TypeRole,       QByteArrayLiteral("type") },
         { EntryIndexRole, QByteArrayLiteral("entryIndex") },
+        { StyleRunsRole,  QByteArrayLiteral("styleRuns") },
+        { LineColorRole,  QByteArrayLiteral("lineColor") },
     };
 }
 
@@ -58,8 +284,12 @@ void TerminalModel::appendEntry(const QString &timestamp, const QString &msgText
                                 const QString &hexData, const QString &type)
 {
     m_pending.append({ timestamp, msgText, hexData, type, 0 });
-    if (!m_flushTimer.isActive())
-        m_flushTimer.start();
+    ++m_rateCount;
+    if (!m_rateTimer.isActive()) {
+        m_rateClock.start();
+        m_rateTimer.start();
+    }
+    scheduleFlush();
 }
 
 void TerminalModel::appendRxLine(const QString &timestamp, const QString &asciiData,
@@ -70,43 +300,54 @@ void TerminalModel::appendRxLine(const QString &timestamp, const QString &asciiD
 
 void TerminalModel::flushPending()
 {
-    if (m_pending.isEmpty())
+    m_frameRequested = false;
+    flushBatch(m_pending.size());
+}
+
+void TerminalModel::flushBatch(int maxEntries)
+{
+    if (m_pending.isEmpty() || maxEntries <= 0)
         return;
 
     QList<TerminalEntry> batch;
-    batch.swap(m_pending);
-
-    QVariantList appendedMaps;
-    appendedMaps.reserve(batch.size());
+    if (maxEntries >= m_pending.size()) {
+        batch.swap(m_pending);
+    } else {
+        batch = m_pending.first(maxEntries);
+        m_pending.remove(0, maxEntries);
+    }
 
-    int visibleAdds = 0;
-    for (TerminalEntry &e : batch) {
+    // filter 每筆只評估一次: 先收集可見的 m_all index,插入時直接用
+    const int firstAll = m_all.size();
+    QList<int> visibleAdds;
+    for (int i = 0; i < batch.size(); ++i) {
+        TerminalEntry &e = batch[i];
         e.entryIndex = m_nextIndex++;
-        e.hlColor = computeHlColor(e);
-        if (matchesFilter(e))
-            ++visibleAdds;
-        appendedMaps.append(entryToMap(e));
+        e.hlColor = m_styler.hlColor(e);
+        if (m_filter.matches(e))
+            visibleAdds.append(firstAll + i);
     }
 
-    if (visibleAdds > 0) {
+    if (!visibleAdds.isEmpty()) {
         const int first = m_visible.size();
-        beginInsertRows(QModelIndex(), first, first + visibleAdds - 1);
-        for (const TerminalEntry &e : batch) {
-            m_all.append(e);
-            if (matchesFilter(e))
-                m_visible.append(m_all.size() - 1);
-        }
+        beginInsertRows(QModelIndex(), first, first + visibleAdds.size() - 1);
+        m_all.append(batch);
+        m_visible.append(visibleAdds);
         endInsertRows();
         emit countChanged();
     } else {
-        for (const TerminalEntry &e : batch)
-            m_all.append(e);
+        m_all.append(batch);
     }
     emit totalCountChanged();
+    emit entriesCommitted(firstAll, batch.size());
 
     trimIfNeeded();
 
-    emit entriesAppended(appendedMaps);
+    if (m_flooding && m_sampleClock.elapsed() >= FLOOD_SAMPLE_INTERVAL_MS)
+        refreshFloodSample();
+
+    emit entriesFlushed(batch);
+    emit entriesAppended(batch.size());
 }
 
 void TerminalModel::trimIfNeeded()
@@ -118,19 +359,14 @@ void TerminalModel::trimIfNeeded()
     const int removeCount = qMax(m_maxLines / 10, m_all.size() - m_maxLines);
     const int removedMaxEntryIndex = m_all.at(removeCount - 1).entryIndex;
 
-    int visRemove = 0;
-    while (visRemove < m_visible.size() && m_visible.at(visRemove) < removeCount)
-        ++visRemove;
-
-    if (visRemove > 0) {
+    const int visRemove = TerminalFilter::trimmedRows(m_visible, removeCount);
+    if (visRemove > 0)
         beginRemoveRows(QModelIndex(), 0, visRemove - 1);
-        m_visible.remove(0, visRemove);
-        endRemoveRows();
-    }
-    for (int &idx : m_visible)
-        idx -= removeCount;
-
+    TerminalFilter::dropTrimmed(m_visible, visRemove, removeCount);
     m_all.remove(0, removeCount);
+    if (visRemove > 0)
+        endRemoveRows();
+    m_selection.trimBelow(removedMaxEntryIndex + 1);
 
     if (visRemove > 0)
         emit countChanged();
@@ -138,20 +374,37 @@ void TerminalModel::trimIfNeeded()
     emit trimmed(removeCount, removedMaxEntryIndex);
 }
 
-bool TerminalModel::matchesFilter(const TerminalEntry &e) const
+int TerminalFilter::trimmedRows(const QList<int> &visible, int removedCount)
+{
+    return int(std::lower_bound(visible.cbegin(), visible.cend(), removedCount) - visible.cbegin());
+}
+
+void TerminalFilter::dropTrimmed(QList<int> &visible, int rows, int removedCount)
+{
+    visible.remove(0, rows);
+    for (int &idx : visible)
+        idx -= removedCount;
+}
+
+bool TerminalFilter::matches(const TerminalEntry &e) const
 {
-    // system / error 訊息永遠顯示
+    for (const FilterQuery &q : queries) {
+        if (!q.matches(e.type, e.timestamp, e.msgText, e.hexData))
+            return false;
+    }
+
+    // system / error 訊息不受 include/exclude 影響
     if (e.type == QLatin1String("system") || e.type == QLatin1String("error"))
         return true;
 
-    if (m_includes.isEmpty() && m_excludes.isEmpty())
+    if (includes.isEmpty() && excludes.isEmpty())
         return true;
 
     const QString text = e.msgText.toLower();
 
-    if (!m_includes.isEmpty()) {
+    if (!includes.isEmpty()) {
         bool hit = false;
-        for (const QString &inc : m_includes) {
+        for (const QString &inc : includes) {
             if (text.contains(inc)) {
                 hit = true;
                 break;
@@ -161,34 +414,53 @@ bool TerminalModel::matchesFilter(const TerminalEntry &e) const
             return false;
     }
 
-    for (const QString &exc : m_excludes) {
+    for (const QString &exc : excludes) {
         if (text.contains(exc))
             return false;
     }
     return true;
 }
 
-void TerminalModel::setFilters(const QVariantList &filters)
+TerminalFilter TerminalFilter::fromVariantList(const QVariantList &filters, QStringList *errors)
 {
-    m_includes.clear();
-    m_excludes.clear();
+    TerminalFilter result;
     for (const QVariant &v : filters) {
         const QVariantMap f = v.toMap();
         if (!f.value(QStringLiteral("enabled")).toBool())
             continue;
+        const QString filterType = f.value(QStringLiteral("filterType")).toString();
+        if (filterType == QLatin1String("query")) {
+            const FilterQuery q = FilterQuery::compile(f.value(QStringLiteral("text")).toString());
+            if (!q.isValid()) {
+                if (errors)
+                    errors->append(q.source() + QStringLiteral(": ") + q.errorString());
+            } else if (!q.isEmpty()) {
+                result.queries.append(q);
+            }
+            continue;
+        }
         const QString text = f.value(QStringLiteral("text")).toString().toLower();
         if (text.isEmpty())
             continue;
-        if (f.value(QStringLiteral("filterType")).toString() == QLatin1String("include"))
-            m_includes.append(text);
+        if (filterType == QLatin1String("include"))
+            result.includes.append(text);
         else
-            m_excludes.append(text);
+            result.excludes.append(text);
     }
+    return result;
+}
+
+void TerminalModel::setFilters(const QVariantList &filters)
+{
+    QStringList errors;
+    m_filter = TerminalFilter::fromVariantList(filters, &errors);
+    for (const QString &err : std::as_const(errors))
+        emit filterQueryError(err);
 
     beginResetModel();
     m_visible.clear();
     for (int i = 0; i < m_all.size(); ++i) {
-        if (matchesFilter(m_all.at(i)))
+        if (m_filter.matches(m_all.at(i)))
             m_visible.append(i);
     }
     endResetModel();
@@ -232,49 +504,24 @@ void TerminalModel::clear()
     m_all.clear();
     m_visible.clear();
     m_nextIndex = 0;
+    m_runCache.clear();
     endResetModel();
+    m_selection.clear();
+    m_floodSample->setEntries({});
+    emit storeCleared();
     emit countChanged();
     emit totalCountChanged();
 }
 
-QVariantList TerminalModel::allEntries() const
-{
-    QVariantList result;
-    result.reserve(m_all.size());
-    for (const TerminalEntry &e : m_all)
-        result.append(entryToMap(e));
-    return result;
-}
-
-QString TerminalModel::computeHlColor(const TerminalEntry &e) const
-{
-    if (m_hlKeywords.isEmpty())
-        return QString();
-    const QString text = ((m_hlHexMode && !e.hexData.isEmpty()) ? e.hexData : e.msgText).toLower();
-    for (const HlKeyword &kw : m_hlKeywords) {
-        if (text.contains(kw.textLower))
-            return kw.color;
-    }
-    return QString();
-}
-
 void TerminalModel::setHighlightKeywords(const QVariantList &keywords, bool hexMode)
 {
-    m_hlKeywords.clear();
-    for (const QVariant &v : keywords) {
-        const QVariantMap kw = v.toMap();
-        if (!kw.value(QStringLiteral("enabled")).toBool())
-            continue;
-        const QString text = kw.value(QStringLiteral("text")).toString().toLower();
-        if (text.isEmpty())
-            continue;
-        m_hlKeywords.append({ text, kw.value(QStringLiteral("color")).toString() });
-    }
-    m_hlHexMode = hexMode;
+    m_styler.setKeywords(keywords);
+    m_styler.setHexMode(hexMode);
 
     for (TerminalEntry &e : m_all)
-        e.hlColor = computeHlColor(e);
+        e.hlColor = m_styler.hlColor(e);
 
+    invalidateStyles();
     emit highlightKeywordsChanged();
 }
 
@@ -303,6 +550,56 @@ QVariantList TerminalModel::entryIndicesInRange(int loRow, int hiRow) const
     return result;
 }
 
+int TerminalModel::entryIndexAt(int row) const
+{
+    if (row < 0 || row >= m_visible.size())
+        return -1;
+    return m_all.at(m_visible.at(row)).entryIndex;
+}
+
+void TerminalModel::selectRows(int fromRow, int toRow, bool extend)
+{
+    if (m_visible.isEmpty())
+        return;
+    const int lo = qBound(0, qMin(fromRow, toRow), m_visible.size() - 1);
+    const int hi = qBound(0, qMax(fromRow, toRow), m_visible.size() - 1);
+    m_selection.selectRange(entryIndexAt(lo), entryIndexAt(hi), extend);
+}
+
+void TerminalModel::selectAll()
+{
+    if (m_visible.isEmpty())
+        return;
+    m_selection.selectRange(entryIndexAt(0), entryIndexAt(m_visible.size() - 1), false);
+}
+
+template <typename Fn>
+void TerminalModel::forEachSelected(Fn fn) const
+{
+    // 選取區間與 m_visible 都依 entryIndex 遞增: 每個區間二分找起點後線性走
+    auto rowEntry = [this](int allIndex) { return m_all.at(allIndex).entryIndex; };
+    for (const TerminalSelection::Range &r : m_selection.ranges()) {
+        auto it = std::lower_bound(m_visible.cbegin(), m_visible.cend(), r.lo,
+                                   [&](int allIndex, int v) { return rowEntry(allIndex) < v; });
+        for (; it != m_visible.cend() && rowEntry(*it) <= r.hi; ++it)
+            fn(m_all.at(*it));
+    }
+}
+
+int TerminalModel::copySelection(bool timestamp, bool prefix, bool hexMode) const
+{
+    QString text;
+    int lines = 0;
+    forEachSelected([&](const TerminalEntry &e) {
+        if (lines++ > 0)
+            text += QLatin1Char('\n');
+        appendEntryLine(text, e, timestamp, prefix, hexMode);
+    });
+    if (lines > 0)
+        QGuiApplication::clipboard()->setText(text);
+    return lines;
+}
+
 QVariantMap TerminalModel::entryToMap(const TerminalEntry &e)
 {
     return {
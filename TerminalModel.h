@@ -2,31 +2,68 @@
 #define TERMINALMODEL_H
 
 #include <QAbstractListModel>
+#include <QElapsedTimer>
+#include <QPointer>
 #include <QTimer>
 #include <QVariantList>
 #include <QVariantMap>
 #include <QStringList>
+#include <QtQml/qqmlregistration.h>
+#include "FilterQuery.h"
+#include "TerminalEntry.h"
+#include "TerminalSelection.h"
+#include "TerminalStyler.h"
+
+class QQuickWindow;
+class TerminalSampleModel;
+
+// include/exclude filter 組(已 lowercase)+ 編譯後的 query,TerminalModel 與每個 TerminalView 各持一份
+struct TerminalFilter {
+    QStringList includes;
+    QStringList excludes;
+    QList<FilterQuery> queries;   // filterType "query",全部成立才顯示(不豁免 system/error)
+
+    bool isActive() const { return !includes.isEmpty() || !excludes.isEmpty() || !queries.isEmpty(); }
+    bool matches(const TerminalEntry &e) const;
+    // QML filter 清單 [{text, filterType, enabled}] → 已啟用的 filter 組
+    // 編譯失敗的 query 略過,錯誤訊息附加到 errors
+    static TerminalFilter fromVariantList(const QVariantList &filters, QStringList *errors = nullptr);
+
+    // m_all 去頭 removedCount 筆時同步可見索引(遞增的 m_all 索引),TerminalModel / TerminalView 共用:
+    // trimmedRows = 落在被砍範圍內的可見列數(呼叫端據此 beginRemoveRows),
+    // dropTrimmed 移除這些列並把其餘索引往前平移
+    static int trimmedRows(const QList<int> &visible, int removedCount);
+    static void dropTrimmed(QList<int> &visible, int rows, int removedCount);
+};
 
 // 終端機資料層:單一儲存(取代 QML 的 terminalEntries JS array + ListModel 雙份)。
 // - model 的 row = 通過 filter 的可見列;totalCount = 全部 entry 數
-// - 收行先進 m_pending,16ms 批次 flush:一次 beginInsertRows,QML 每批只 layout 一次
+// - 收行先進 m_pending,批次 flush:一次 beginInsertRows,QML 每批只 layout 一次
+//   TimerFlush: 固定 16ms;FrameFlush: 跟著視窗每個 frame(afterAnimating)flush,
+//   每 frame 最多一次 insert + 一次 autoscroll,批量依實測 frame 時間調整
+// - flood mode: 收行速率超過 floodThreshold 時,跟尾中的畫面改顯示節流取樣(floodSample);
+//   m_all / m_visible / search / log 照常收下每一行,速率降回後畫面直接接回完整 model
+// - 每批 flush 以 entriesFlushed(TerminalBatch) 直接交給 FileLogger(C++ 直連,不經 QML)
 // - 修剪在 C++ 端去頭,並以 trimmed signal 通知 QML 同步 selection/search 狀態
-struct TerminalEntry {
-    QString timestamp;   // 顯示用 "HH:mm:ss.zzz"
-    QString msgText;
-    QString hexData;
-    QString type;        // "rx" | "tx" | "system" | "error"
-    int     entryIndex;  // 全域遞增,clear 後歸零
-    QString hlColor;     // 命中的第一個 keyword 色彩(scroll bar 標記用),空=未命中
-};
-
 class TerminalModel : public QAbstractListModel
 {
     Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("TerminalModel is provided by the application as terminalModel")
     Q_PROPERTY(int count READ count NOTIFY countChanged)
     Q_PROPERTY(int totalCount READ totalCount NOTIFY totalCountChanged)
     Q_PROPERTY(int maxLines READ maxLines WRITE setMaxLines NOTIFY maxLinesChanged)
     Q_PROPERTY(bool filterActive READ filterActive NOTIFY filterActiveChanged)
+    Q_PROPERTY(bool colorNumbers READ colorNumbers WRITE setColorNumbers NOTIFY styleChanged)
+    Q_PROPERTY(TerminalSelection *selection READ selection CONSTANT)
+    Q_PROPERTY(FlushMode flushMode READ flushMode WRITE setFlushMode NOTIFY flushModeChanged)
+    Q_PROPERTY(int floodThreshold READ floodThreshold WRITE setFloodThreshold NOTIFY floodThresholdChanged)
+    Q_PROPERTY(int floodSampleRows READ floodSampleRows WRITE setFloodSampleRows NOTIFY floodSampleRowsChanged)
+    Q_PROPERTY(bool followTail READ followTail WRITE setFollowTail NOTIFY followTailChanged)
+    Q_PROPERTY(bool flooding READ flooding NOTIFY floodingChanged)
+    Q_PROPERTY(bool sampling READ sampling NOTIFY samplingChanged)
+    Q_PROPERTY(int lineRate READ lineRate NOTIFY lineRateChanged)
+    Q_PROPERTY(QAbstractItemModel *floodSample READ floodSample CONSTANT)
 
 public:
     enum Roles {
@@ -34,8 +71,15 @@ public:
         MsgTextRole,
         HexDataRole,
         TypeRole,
-        EntryIndexRole
+        EntryIndexRole,
+        StyleRunsRole,      // [start, length, kind, argb, ...](見 TerminalStyler)
+        LineColorRole       // line 模式 keyword 整列背景色,空=無
+    };
+    enum FlushMode {
+        TimerFlush,
+        FrameFlush
     };
+    Q_ENUM(FlushMode)
 
     explicit TerminalModel(QObject *parent = nullptr);
 
@@ -47,7 +91,35 @@ public:
     int totalCount() const { return m_all.size(); }
     int maxLines() const { return m_maxLines; }
     void setMaxLines(int lines);
-    bool filterActive() const { return !m_includes.isEmpty() || !m_excludes.isEmpty(); }
+    bool filterActive() const { return m_filter.isActive(); }
+    bool colorNumbers() const { return m_styler.colorNumbers(); }
+    void setColorNumbers(bool enabled);
+    TerminalSelection *selection() { return &m_selection; }
+    FlushMode flushMode() const { return m_flushMode; }
+    void setFlushMode(FlushMode mode);
+    // 綁定視窗的 frame 訊號並切到 FrameFlush
+    void attachWindow(QQuickWindow *window);
+
+    int floodThreshold() const { return m_floodThreshold; }   // lines/s,0 = 關閉
+    void setFloodThreshold(int linesPerSecond);
+    int floodSampleRows() const { return m_floodSampleRows; }
+    void setFloodSampleRows(int rows);
+    bool followTail() const { return m_followTail; }
+    void setFollowTail(bool follow);
+    bool flooding() const { return m_flooding; }
+    bool sampling() const { return m_flooding && m_followTail; }
+    int lineRate() const { return m_lineRate; }
+    QAbstractItemModel *floodSample() const;
+
+    // 共用 entry store 給 TerminalView: allIndex 為 m_all 索引(修剪後會平移)
+    const TerminalEntry &entryAt(int allIndex) const { return m_all.at(allIndex); }
+    const TerminalEntry &visibleEntry(int row) const { return m_all.at(m_visible.at(row)); }
+    // 全部已提交的 entry(log 開始時補寫既有內容)
+    const TerminalBatch &entries() const { return m_all; }
+    const TerminalFilter &filter() const { return m_filter; }
+    QVariant entryData(const TerminalEntry &e, int role) const;
+    static QHash<int, QByteArray> entryRoleNames();
+    static QVariantMap entryToMap(const TerminalEntry &e);
 
     Q_INVOKABLE void appendEntry(const QString &timestamp, const QString &msgText,
                                  const QString &hexData, const QString &type);
@@ -55,12 +127,20 @@ public:
     Q_INVOKABLE void clear();
     Q_INVOKABLE void setFilters(const QVariantList &filters);
     Q_INVOKABLE QVariantList search(const QString &query, bool isRegex, bool hexMode) const;
-    Q_INVOKABLE QVariantList allEntries() const;
     Q_INVOKABLE QVariantList entryIndicesInRange(int loRow, int hiRow) const;
+    Q_INVOKABLE int entryIndexAt(int row) const;
+    // 可見列 [fromRow, toRow] 的 entryIndex 區間加入選取(extend = false 時取代)
+    Q_INVOKABLE void selectRows(int fromRow, int toRow, bool extend);
+    Q_INVOKABLE void selectAll();
+    // 選取列(僅可見者)逐列組字串後一次寫入剪貼簿,不經 QVariant;回傳列數
+    // (匯出檔案走 TerminalExporter 的 worker thread)
+    Q_INVOKABLE int copySelection(bool timestamp, bool prefix, bool hexMode) const;
     // keyword highlight 同步(append 時即計算 hlColor,keyword 變更時全量重算)
     Q_INVOKABLE void setHighlightKeywords(const QVariantList &keywords, bool hexMode);
     // 回傳可見列中有命中 keyword 的 [{row, color}],給 scroll bar 標記
     Q_INVOKABLE QVariantList highlightMarkers() const;
+    // 搜尋字串的行內命中標記(styleRuns 的 SearchHitRun),空字串 = 清除
+    Q_INVOKABLE void setSearchHighlight(const QString &query, bool isRegex);
 
 public slots:
     void appendRxLine(const QString &timestamp, const QString &asciiData, const QString &hexData);
@@ -70,33 +150,70 @@ signals:
     void totalCountChanged();
     void maxLinesChanged();
     void filterActiveChanged();
-    // 每批 flush 的所有 entry(含被 filter 掉的) — QML 用來寫 log + autoscroll
-    void entriesAppended(const QVariantList &entries);
+    // 每批 flush 的所有 entry(含被 filter 掉的),依 entryIndex 遞增 — 給 FileLogger 等 C++ 消費者
+    void entriesFlushed(const TerminalBatch &batch);
+    // 同一批的筆數 — QML 只需要它來 autoscroll
+    void entriesAppended(int count);
     void trimmed(int removedCount, int removedMaxEntryIndex);
+    // m_all 新增 [first, first+count) — 在修剪之前發出,TerminalView 據此增量更新
+    void entriesCommitted(int first, int count);
+    void storeCleared();
+    void filterQueryError(const QString &message);
     void highlightKeywordsChanged();
+    void flushModeChanged();
+    void floodThresholdChanged();
+    void floodSampleRowsChanged();
+    void followTailChanged();
+    void floodingChanged();
+    void samplingChanged();
+    void lineRateChanged();
+    // keyword / 搜尋 / 數字著色變更: styleRuns 與 lineColor 需重取
+    void styleChanged();
 
 private slots:
     void flushPending();
+    void onWindowFrame();
+    void updateLineRate();
 
 private:
-    struct HlKeyword {
-        QString textLower;
-        QString color;
-    };
-
-    bool matchesFilter(const TerminalEntry &e) const;
-    QString computeHlColor(const TerminalEntry &e) const;
+    void scheduleFlush();
+    void flushBatch(int maxEntries);
+    void setFlooding(bool flooding);
+    void refreshFloodSample();
     void trimIfNeeded();
-    static QVariantMap entryToMap(const TerminalEntry &e);
+    void invalidateStyles();
+    QList<int> cachedRuns(const TerminalEntry &e) const;
+    // 依序走訪可見且被選取的 entry
+    template <typename Fn> void forEachSelected(Fn fn) const;
 
-    QList<TerminalEntry> m_all;
+    TerminalBatch m_all;
     QList<int> m_visible;          // m_all 的索引,遞增
     QList<TerminalEntry> m_pending;
-    QStringList m_includes;        // 已 lowercase 的啟用 include filter
-    QStringList m_excludes;
-    QList<HlKeyword> m_hlKeywords; // 已啟用的 keyword(lowercase),順序 = 優先序
-    bool m_hlHexMode = false;
+    TerminalFilter m_filter;
+    TerminalStyler m_styler;
+    TerminalSelection m_selection;
+    // entryIndex → styleRuns;只有被取用過的列(可見範圍)才會進來,超量時整批丟棄
+    mutable QHash<int, QList<int>> m_runCache;
     QTimer m_flushTimer;
+    FlushMode m_flushMode = TimerFlush;
+    QPointer<QQuickWindow> m_window;
+    QMetaObject::Connection m_frameConnection;
+    bool m_frameRequested = false;
+    QElapsedTimer m_frameClock;
+    qint64 m_lastFrameNs = 0;
+    qint64 m_frameIntervalNs = 16666667;   // 實測 frame 間隔(EMA)
+    int m_frameBatchLimit;                 // FrameFlush 每 frame 最多提交的 entry 數
+
+    int m_floodThreshold = 5000;
+    int m_floodSampleRows = 64;
+    bool m_followTail = true;
+    bool m_flooding = false;
+    int m_lineRate = 0;
+    int m_rateCount = 0;                   // 本量測區間收到的行數
+    QTimer m_rateTimer;
+    QElapsedTimer m_rateClock;
+    QElapsedTimer m_sampleClock;
+    TerminalSampleModel *m_floodSample;
     int m_maxLines = 50000;
     int m_nextIndex = 0;
 };
@@ -0,0 +1,763 @@
+#include "TerminalRenderer.h"
+#include "TerminalStyler.h"
+#include <QFontMetricsF>
+#include <QQuickWindow>
+#include <QSGRectangleNode>
+#include <QSGTextNode>
+#include <QTextBoundaryFinder>
+#include <QTextCharFormat>
+#include <QtMath>
+#include <algorithm>
+#include <climits>
+
+namespace {
+const qreal RowPadding = 2;        // 列上下留白(沿用舊 delegate 的 +4)
+const qreal LeftPadding = 4;
+const int RowCacheLimit = 2048;    // 遠大於一個畫面的列數
+const int SliceChunk = 256;        // 長列 slice 以此欄數對齊,兩側各多留一塊,小幅捲動不必重建
+const int GraphemeWindow = 32;     // 對齊 slice 邊界時往前後看的 UTF-16 單位數
+
+// 顯示寬度(cell 數):東亞寬字 / 全形 / emoji 佔兩格,組合字元與格式字元不佔格
+int cellsOf(char32_t c)
+{
+    if (c < 0x300)
+        return 1;
+    switch (QChar::category(c)) {
+    case QChar::Mark_NonSpacing:
+    case QChar::Mark_Enclosing:
+    case QChar::Other_Format:
+        return 0;
+    default:
+        break;
+    }
+    if ((c >= 0x1100 && c <= 0x115f) || (c >= 0x2e80 && c <= 0xa4cf && c != 0x303f)
+        || (c >= 0xac00 && c <= 0xd7a3) || (c >= 0xf900 && c <= 0xfaff)
+        || (c >= 0xfe30 && c <= 0xfe4f) || (c >= 0xff00 && c <= 0xff60)
+        || (c >= 0xffe0 && c <= 0xffe6) || (c >= 0x1f300 && c <= 0x1f64f)
+        || (c >= 0x1f900 && c <= 0x1f9ff) || (c >= 0x20000 && c <= 0x3fffd))
+        return 2;
+    return 1;
+}
+
+// 從 text[from] 往後走 cell 格,回傳停下的字元 index(不跨進半個寬字),
+// 實際走過的格數寫到 *walked。以 code point 為單位,不會停在 surrogate pair 中間
+int indexAtCell(QStringView text, int from, int cell, int *walked)
+{
+    int i = from;
+    int cells = 0;
+    while (i < text.size()) {
+        char32_t c = text.at(i).unicode();
+        int units = 1;
+        if (QChar::isHighSurrogate(c) && i + 1 < text.size() && text.at(i + 1).isLowSurrogate()) {
+            c = QChar::surrogateToUcs4(text.at(i), text.at(i + 1));
+            units = 2;
+        }
+        const int w = cellsOf(c);
+        if (cells + w > cell)
+            break;
+        cells += w;
+        i += units;
+    }
+    *walked = cells;
+    return i;
+}
+
+int cellsBetween(QStringView text, int from, int to)
+{
+    int walked = 0;
+    indexAtCell(text.left(to), from, INT_MAX, &walked);
+    return walked;
+}
+
+// 把 pos 對齊到 grapheme cluster 邊界(forward = 往後,否則往前):emoji ZWJ 序列、國旗、
+// Hangul jamo 不會被 slice 切開。cluster 很短,只看 pos 附近一小段,成本與列長無關
+int snapToGrapheme(QStringView text, int pos, bool forward)
+{
+    if (pos <= 0 || pos >= text.size())
+        return pos;
+    const int from = qMax(0, pos - GraphemeWindow);
+    const int to = qMin(int(text.size()), pos + GraphemeWindow);
+    QTextBoundaryFinder finder(QTextBoundaryFinder::Grapheme, text.data() + from, to - from);
+    finder.setPosition(pos - from);
+    if (finder.isAtBoundary())
+        return pos;
+    const qsizetype snapped = forward ? finder.toNextBoundary() : finder.toPreviousBoundary();
+    return snapped < 0 ? pos : from + int(snapped);
+}
+} // namespace
+
+TerminalRenderer::TerminalRenderer(QQuickItem *parent)
+    : QQuickItem(parent)
+{
+    setFlag(ItemHasContents, true);
+    setClip(true);
+    m_font.setStyleHint(QFont::Monospace);
+    updateMetrics();
+
+    connect(this, &TerminalRenderer::appearanceChanged, this, &TerminalRenderer::invalidateLayouts);
+    connect(this, &TerminalRenderer::searchChanged, this, &TerminalRenderer::scheduleRefresh);
+}
+
+void TerminalRenderer::setModel(QAbstractItemModel *model)
+{
+    if (m_model == model)
+        return;
+    for (const QMetaObject::Connection &c : std::as_const(m_modelConnections))
+        disconnect(c);
+    m_modelConnections.clear();
+
+    m_model = model;
+    if (m_model) {
+        m_roleTimestamp = roleFor("timestamp");
+        m_roleMsgText = roleFor("msgText");
+        m_roleHexData = roleFor("hexData");
+        m_roleType = roleFor("type");
+        m_roleEntryIndex = roleFor("entryIndex");
+        m_roleStyleRuns = roleFor("styleRuns");
+        m_roleLineColor = roleFor("lineColor");
+
+        m_modelConnections
+            << connect(m_model, &QAbstractItemModel::rowsInserted, this, &TerminalRenderer::onRowsInserted)
+            << connect(m_model, &QAbstractItemModel::rowsRemoved, this, &TerminalRenderer::onRowsRemoved)
+            << connect(m_model, &QAbstractItemModel::modelReset, this, &TerminalRenderer::onModelReset)
+            << connect(m_model, &QAbstractItemModel::dataChanged, this, &TerminalRenderer::onLayoutInvalidated)
+            << connect(m_model, &QAbstractItemModel::layoutChanged, this, &TerminalRenderer::onLayoutInvalidated);
+    }
+    emit modelChanged();
+    onModelReset();
+}
+
+int TerminalRenderer::roleFor(const QByteArray &name) const
+{
+    const QHash<int, QByteArray> roles = m_model->roleNames();
+    for (auto it = roles.cbegin(); it != roles.cend(); ++it) {
+        if (it.value() == name)
+            return it.key();
+    }
+    return -1;
+}
+
+void TerminalRenderer::setFont(const QFont &font)
+{
+    if (m_font == font)
+        return;
+    // 換字級時保持最上方可見列不動
+    const qreal topRow = m_rowHeight > 0 ? m_contentY / m_rowHeight : 0;
+    m_font = font;
+    updateMetrics();
+    emit fontChanged();
+    emit contentHeightChanged();
+    setContentY(topRow * m_rowHeight);
+    invalidateLayouts();
+}
+
+void TerminalRenderer::updateMetrics()
+{
+    const QFontMetricsF fm(m_font);
+    m_cellWidth = fm.horizontalAdvance(QLatin1Char('M'));
+    m_rowHeight = qCeil(fm.height()) + RowPadding * 2;
+    emit metricsChanged();
+}
+
+void TerminalRenderer::setContentY(qreal y)
+{
+    const qreal maxY = qMax<qreal>(0, contentHeight() - height());
+    y = qBound<qreal>(0, y, maxY);
+    if (qFuzzyCompare(y + 1, m_contentY + 1))
+        return;
+    m_contentY = y;
+    emit contentYChanged();
+    scheduleRefresh();
+}
+
+void TerminalRenderer::clampContentY()
+{
+    setContentY(m_contentY);
+}
+
+void TerminalRenderer::setContentX(qreal x)
+{
+    const qreal maxX = qMax<qreal>(0, m_contentWidth - width());
+    x = qBound<qreal>(0, x, maxX);
+    if (qFuzzyCompare(x + 1, m_contentX + 1))
+        return;
+    m_contentX = x;
+    emit contentXChanged();
+    scheduleRefresh();
+}
+
+void TerminalRenderer::clampContentX()
+{
+    setContentX(m_contentX);
+}
+
+void TerminalRenderer::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size()) {
+        clampContentY();
+        clampContentX();
+        scheduleRefresh();
+    }
+}
+
+int TerminalRenderer::rowAt(qreal y) const
+{
+    if (y < 0 || m_rowHeight <= 0)
+        return -1;
+    const int row = int((y + m_contentY) / m_rowHeight);
+    return row < count() ? row : -1;
+}
+
+int TerminalRenderer::columnAt(int row, qreal x) const
+{
+    if (row < 0 || row >= count() || m_cellWidth <= 0)
+        return 0;
+    const RowData d = rowData(row);
+    const QString text = prefixText(d.type) + dataText(d);
+    const qreal rowX = x + m_contentX - LeftPadding;
+
+    // 可見列都有快取的 layout: 落在 slice 內就由 layout 換算,寬字 / 組合字元都準
+    if (const QSharedPointer<RowLayout> rl = m_rowCache.value(d.entryIndex)) {
+        const QTextLine line = rl->layout.lineAt(0);
+        const qreal sliceX = rl->sliceStartCell * m_cellWidth;
+        if (line.isValid() && rowX >= sliceX
+            && (rl->sliceEnd == rl->fullLength || rowX <= sliceX + line.naturalTextWidth())) {
+            const int col = rl->sliceStart + line.xToCursor(rowX - sliceX) - rl->textStart;
+            return qBound(0, col, int(text.size()));
+        }
+    }
+
+    // 其餘依 cell 寬度換算(gutter 只有數字與 timestamp,一字一格)
+    int gutter = 0;
+    if (m_showLineNumbers)
+        gutter += qMax(4, int(QString::number(d.entryIndex + 1).size())) + 1;
+    if (m_showTimestamp)
+        gutter += d.timestamp.size() + 1;
+    const int cell = qRound(rowX / m_cellWidth) - gutter;
+    if (cell <= 0)
+        return 0;
+    int walked = 0;
+    return indexAtCell(text, 0, cell, &walked);
+}
+
+void TerminalRenderer::positionViewAtRow(int row)
+{
+    if (row < 0 || row >= count())
+        return;
+    setContentY(row * m_rowHeight - (height() - m_rowHeight) / 2);
+}
+
+void TerminalRenderer::positionViewAtEnd()
+{
+    setContentY(contentHeight() - height());
+}
+
+void TerminalRenderer::setSelection(TerminalSelection *selection)
+{
+    if (m_selection == selection)
+        return;
+    disconnect(m_selectionConnection);
+    m_selection = selection;
+    if (m_selection)
+        m_selectionConnection = connect(m_selection, &TerminalSelection::changed,
+                                        this, &TerminalRenderer::scheduleRefresh);
+    emit selectionChanged();
+    scheduleRefresh();
+}
+
+// ── 字元選取 ───────────────────────────────────────────────────
+
+bool TerminalRenderer::hasCharSelection() const
+{
+    return m_anchorRow >= 0 && m_cursorRow >= 0
+        && (m_anchorRow != m_cursorRow || m_anchorColumn != m_cursorColumn);
+}
+
+int TerminalRenderer::charSelectionFirstRow() const
+{
+    return m_anchorRow < 0 ? -1 : qMin(m_anchorRow, m_cursorRow);
+}
+
+int TerminalRenderer::charSelectionLastRow() const
+{
+    return m_anchorRow < 0 ? -1 : qMax(m_anchorRow, m_cursorRow);
+}
+
+void TerminalRenderer::setCharSelectionAnchor(int row, int column)
+{
+    m_anchorRow = m_cursorRow = row;
+    m_anchorColumn = m_cursorColumn = column;
+    emit charSelectionChanged();
+    scheduleRefresh();
+}
+
+void TerminalRenderer::extendCharSelection(int row, int column)
+{
+    if (m_anchorRow < 0)
+        return setCharSelectionAnchor(row, column);
+    m_cursorRow = row;
+    m_cursorColumn = column;
+    emit charSelectionChanged();
+    scheduleRefresh();
+}
+
+void TerminalRenderer::selectWordAt(int row, int column)
+{
+    const QString text = displayText(row);
+    int start = qBound(0, column, int(text.size()));
+    int end = start;
+    while (start > 0 && !text.at(start - 1).isSpace())
+        --start;
+    while (end < text.size() && !text.at(end).isSpace())
+        ++end;
+    m_anchorRow = m_cursorRow = row;
+    m_anchorColumn = start;
+    m_cursorColumn = end;
+    emit charSelectionChanged();
+    scheduleRefresh();
+}
+
+void TerminalRenderer::clearCharSelection()
+{
+    if (m_anchorRow < 0)
+        return;
+    m_anchorRow = m_cursorRow = -1;
+    m_anchorColumn = m_cursorColumn = 0;
+    emit charSelectionChanged();
+    scheduleRefresh();
+}
+
+QString TerminalRenderer::selectedText() const
+{
+    if (!hasCharSelection())
+        return QString();
+
+    if (m_anchorRow == m_cursorRow) {
+        const int lo = qMin(m_anchorColumn, m_cursorColumn);
+        const int hi = qMax(m_anchorColumn, m_cursorColumn);
+        return displayText(m_anchorRow).mid(lo, hi - lo);
+    }
+
+    const bool anchorIsTop = m_anchorRow < m_cursorRow;
+    const int first = charSelectionFirstRow();
+    const int last = qMin(charSelectionLastRow(), count() - 1);
+    const int topColumn = anchorIsTop ? m_anchorColumn : m_cursorColumn;
+    const int bottomColumn = anchorIsTop ? m_cursorColumn : m_anchorColumn;
+
+    QStringList lines;
+    for (int row = first; row <= last; ++row) {
+        if (row == first)
+            lines << displayText(row).mid(topColumn);
+        else if (row == last)
+            lines << displayText(row).left(bottomColumn);
+        else
+            lines << dataText(rowData(row));
+    }
+    return lines.join(QLatin1Char('\n'));
+}
+
+QString TerminalRenderer::displayText(int row) const
+{
+    if (row < 0 || row >= count())
+        return QString();
+    const RowData d = rowData(row);
+    return prefixText(d.type) + dataText(d);
+}
+
+// ── model ──────────────────────────────────────────────────────
+
+TerminalRenderer::RowData TerminalRenderer::rowData(int row) const
+{
+    RowData d;
+    const QModelIndex idx = m_model->index(row, 0);
+    d.timestamp = idx.data(m_roleTimestamp).toString();
+    d.msgText = idx.data(m_roleMsgText).toString();
+    d.hexData = idx.data(m_roleHexData).toString();
+    d.type = idx.data(m_roleType).toString();
+    d.entryIndex = m_roleEntryIndex >= 0 ? idx.data(m_roleEntryIndex).toInt() : row;
+    return d;
+}
+
+QString TerminalRenderer::dataText(const RowData &d) const
+{
+    return (m_hexMode && !d.hexData.isEmpty()) ? d.hexData : d.msgText;
+}
+
+QString TerminalRenderer::prefixText(const QString &type) const
+{
+    if (!m_showPrefix)
+        return QString();
+    if (type == QLatin1String("rx"))     return QStringLiteral("RX> ");
+    if (type == QLatin1String("tx"))     return QStringLiteral("TX> ");
+    if (type == QLatin1String("system")) return QStringLiteral("SYS> ");
+    if (type == QLatin1String("error"))  return QStringLiteral("ERR> ");
+    return QStringLiteral("> ");
+}
+
+QColor TerminalRenderer::typeColor(const QString &type) const
+{
+    if (type == QLatin1String("rx"))     return m_rxColor;
+    if (type == QLatin1String("tx"))     return m_txColor;
+    if (type == QLatin1String("system")) return m_systemColor;
+    if (type == QLatin1String("error"))  return m_errorColor;
+    return m_textColor;
+}
+
+void TerminalRenderer::onRowsInserted(const QModelIndex &, int first, int last)
+{
+    // 插入點之後的字元選取跟著平移(一般只會在尾端 append,不影響)
+    const int n = last - first + 1;
+    if (m_anchorRow >= first) m_anchorRow += n;
+    if (m_cursorRow >= first) m_cursorRow += n;
+    emit countChanged();
+    emit contentHeightChanged();
+    scheduleRefresh();
+}
+
+void TerminalRenderer::onRowsRemoved(const QModelIndex &, int first, int last)
+{
+    const int n = last - first + 1;
+    // 修剪去頭: 捲離尾端時畫面內容保持不動
+    if (first == 0)
+        m_contentY = qMax<qreal>(0, m_contentY - n * m_rowHeight);
+
+    if (m_anchorRow >= 0) {
+        const bool anchorGone = m_anchorRow >= first && m_anchorRow <= last;
+        const bool cursorGone = m_cursorRow >= first && m_cursorRow <= last;
+        if (anchorGone || cursorGone) {
+            m_anchorRow = m_cursorRow = -1;
+        } else {
+            if (m_anchorRow > last) m_anchorRow -= n;
+            if (m_cursorRow > last) m_cursorRow -= n;
+        }
+        emit charSelectionChanged();
+    }
+
+    emit countChanged();
+    emit contentHeightChanged();
+    emit contentYChanged();
+    clampContentY();
+    scheduleRefresh();
+}
+
+void TerminalRenderer::onModelReset()
+{
+    m_rowCache.clear();
+    m_contentWidth = 0;
+    emit contentWidthChanged();
+    if (m_anchorRow >= 0) {
+        m_anchorRow = m_cursorRow = -1;
+        emit charSelectionChanged();
+    }
+    emit countChanged();
+    emit contentHeightChanged();
+    clampContentY();
+    scheduleRefresh();
+}
+
+void TerminalRenderer::onLayoutInvalidated()
+{
+    // styleRuns / lineColor 變動: 列長不變,保留 contentWidth
+    m_rowCache.clear();
+    scheduleRefresh();
+}
+
+void TerminalRenderer::invalidateLayouts()
+{
+    m_rowCache.clear();
+    // 顯示選項 / 字型變了,列寬重新累計
+    m_contentWidth = 0;
+    emit contentWidthChanged();
+    scheduleRefresh();
+}
+
+void TerminalRenderer::scheduleRefresh()
+{
+    polish();
+}
+
+// ── 繪製 ───────────────────────────────────────────────────────
+
+QSharedPointer<TerminalRenderer::RowLayout> TerminalRenderer::rowLayout(int row, int entryIndex,
+                                                                        int firstCell, int lastCell)
+{
+    if (QSharedPointer<RowLayout> cached = m_rowCache.value(entryIndex)) {
+        if (cached->sliceStartCell <= firstCell
+            && (cached->sliceEnd == cached->fullLength || cached->sliceEndCell >= lastCell))
+            return cached;
+    }
+
+    const RowData d = rowData(row);
+    const QModelIndex idx = m_model->index(row, 0);
+    QString gutter;
+    QList<QTextLayout::FormatRange> formats;
+    auto addFormat = [&formats](int start, int length, const QTextCharFormat &fmt) {
+        if (length > 0)
+            formats.append({ start, length, fmt });
+    };
+
+    if (m_showLineNumbers) {
+        QTextCharFormat fmt;
+        fmt.setForeground(m_lineNumberColor);
+        const QString num = QString::number(d.entryIndex + 1).rightJustified(4, QLatin1Char(' '));
+        addFormat(gutter.size(), num.size(), fmt);
+        gutter += num + QLatin1Char(' ');
+    }
+    if (m_showTimestamp) {
+        QTextCharFormat fmt;
+        fmt.setForeground(m_timestampColor);
+        addFormat(gutter.size(), d.timestamp.size(), fmt);
+        gutter += d.timestamp + QLatin1Char(' ');
+    }
+
+    const QString prefix = prefixText(d.type);
+    const QString data = dataText(d);
+
+    QSharedPointer<RowLayout> rl(new RowLayout);
+    rl->textStart = gutter.size();
+    rl->dataStart = gutter.size() + prefix.size();
+
+    QTextCharFormat baseFmt;
+    baseFmt.setForeground(typeColor(d.type));
+
+    // styleRuns: keyword / 數字 run 互不重疊;搜尋命中只畫背景
+    const QList<int> runs = m_roleStyleRuns >= 0 ? idx.data(m_roleStyleRuns).value<QList<int>>() : QList<int>();
+    QList<int> spans;
+    QList<QPair<int, int>> searchHits;
+    for (int i = 0; i + TerminalStyler::RunStride <= runs.size(); i += TerminalStyler::RunStride) {
+        if (runs.at(i + 2) == TerminalStyler::SearchHitRun)
+            searchHits.append({ runs.at(i), runs.at(i + 1) });
+        else
+            spans.append(i);
+    }
+    std::sort(spans.begin(), spans.end(), [&runs](int a, int b) { return runs.at(a) < runs.at(b); });
+
+    int pos = 0;
+    QList<QPair<int, int>> keywordBgs;   // (start, runIndex)
+    addFormat(rl->textStart, prefix.size(), baseFmt);
+    for (int r : std::as_const(spans)) {
+        const int start = qBound(0, runs.at(r), int(data.size()));
+        const int length = qBound(0, runs.at(r + 1), int(data.size()) - start);
+        addFormat(rl->dataStart + pos, start - pos, baseFmt);
+        QTextCharFormat fmt;
+        switch (runs.at(r + 2)) {
+        case TerminalStyler::KeywordBgRun:
+            fmt.setForeground(m_keywordBgTextColor);
+            fmt.setFontWeight(QFont::Bold);
+            keywordBgs.append({ start, r });
+            break;
+        case TerminalStyler::KeywordTextRun:
+            fmt.setForeground(QColor::fromRgba(QRgb(runs.at(r + 3))));
+            fmt.setFontWeight(QFont::Bold);
+            break;
+        default:
+            fmt.setForeground(m_numberColor);
+            break;
+        }
+        addFormat(rl->dataStart + start, length, fmt);
+        pos = start + length;
+    }
+    addFormat(rl->dataStart + pos, data.size() - pos, baseFmt);
+
+    // 水平 slice: 只 layout 可見 cell 前後各一塊 SliceChunk;短列整列。
+    // 寬字佔兩格,slice 邊界以 cell 換算回字元 index,slice 原點放在 sliceStartCell
+    const QString text = gutter + prefix + data;
+    rl->fullLength = text.size();
+    const int startCell = qMax(0, (firstCell / SliceChunk - 1) * SliceChunk);
+    const int endCell = (lastCell / SliceChunk + 2) * SliceChunk;
+    // 邊界再對齊 grapheme cluster: 起點往前、終點往後,text.mid 不會切開 surrogate pair 或組合序列
+    int startCells = 0;
+    const int start = indexAtCell(text, 0, startCell, &startCells);
+    int endCells = 0;
+    const int end = indexAtCell(text, start, endCell - startCells, &endCells);
+    endCells += startCells;
+    rl->sliceStart = snapToGrapheme(text, start, false);
+    rl->sliceStartCell = startCells - cellsBetween(text, rl->sliceStart, start);
+    rl->sliceEnd = snapToGrapheme(text, end, true);
+    rl->sliceEndCell = endCells + cellsBetween(text, end, rl->sliceEnd);
+    int walked = 0;
+    indexAtCell(text, rl->sliceEnd, INT_MAX, &walked);
+    rl->fullCells = rl->sliceEndCell + walked;
+
+    QList<QTextLayout::FormatRange> sliceFormats;
+    for (const QTextLayout::FormatRange &f : std::as_const(formats)) {
+        const int lo = qMax(f.start, rl->sliceStart);
+        const int hi = qMin(f.start + f.length, rl->sliceEnd);
+        if (hi > lo)
+            sliceFormats.append({ lo - rl->sliceStart, hi - lo, f.format });
+    }
+
+    QTextOption option;
+    option.setWrapMode(QTextOption::NoWrap);
+    rl->layout.setText(text.mid(rl->sliceStart, rl->sliceEnd - rl->sliceStart));
+    rl->layout.setFont(m_font);
+    rl->layout.setTextOption(option);
+    rl->layout.setFormats(sliceFormats);
+    rl->layout.setCacheEnabled(true);
+    rl->layout.beginLayout();
+    QTextLine line = rl->layout.createLine();
+    if (line.isValid())
+        line.setPosition(QPointF(0, 0));
+    rl->layout.endLayout();
+
+    if (line.isValid()) {
+        const qreal h = line.height();
+        const int sliceLength = rl->sliceEnd - rl->sliceStart;
+        auto spanRect = [&](int start, int length) {
+            const int c0 = qBound(0, rl->dataStart + start - rl->sliceStart, sliceLength);
+            const int c1 = qBound(0, rl->dataStart + start + length - rl->sliceStart, sliceLength);
+            const qreal x0 = line.cursorToX(c0);
+            const qreal x1 = line.cursorToX(c1);
+            return QRectF(x0, 0, x1 - x0, h);
+        };
+        for (const auto &kb : std::as_const(keywordBgs)) {
+            const int r = kb.second;
+            const QRectF rect = spanRect(kb.first, runs.at(r + 1));
+            if (rect.width() > 0)
+                rl->backgrounds.append({ rect, QColor::fromRgba(QRgb(runs.at(r + 3))) });
+        }
+        for (const auto &hit : std::as_const(searchHits)) {
+            const QRectF rect = spanRect(hit.first, hit.second);
+            if (rect.width() > 0)
+                rl->backgrounds.append({ rect, m_searchHitColor });
+        }
+    }
+
+    const QString lineColor = m_roleLineColor >= 0 ? idx.data(m_roleLineColor).toString() : QString();
+    if (!lineColor.isEmpty()) {
+        rl->lineColor = QColor(lineColor);
+        rl->lineColor.setAlphaF(0.18f);
+    }
+
+    if (m_rowCache.size() >= RowCacheLimit)
+        m_rowCache.clear();
+    m_rowCache.insert(d.entryIndex, rl);
+    return rl;
+}
+
+void TerminalRenderer::updatePolish()
+{
+    m_frameRows.clear();
+    m_frameRects.clear();
+
+    const int total = count();
+    if (m_model && total > 0 && m_rowHeight > 0 && height() > 0) {
+        const int first = qMax(0, int(m_contentY / m_rowHeight));
+        const int last = qMin(total - 1, int((m_contentY + height()) / m_rowHeight));
+        const int selFirst = charSelectionFirstRow();
+        const int selLast = charSelectionLastRow();
+        const bool anchorIsTop = m_anchorRow < m_cursorRow;
+        const bool charSel = hasCharSelection();
+
+        // 可見 cell 範圍: 長列只 layout 這附近
+        const int firstCell = qMax(0, int((m_contentX - LeftPadding) / m_cellWidth));
+        const int lastCell = firstCell + qCeil(width() / m_cellWidth) + 1;
+        int widestCells = 0;
+
+        m_frameRows.reserve(last - first + 1);
+        for (int row = first; row <= last; ++row) {
+            const qreal y = row * m_rowHeight - m_contentY;
+            const QRectF rowRect(0, y, width(), m_rowHeight);
+            const int entryIndex = m_roleEntryIndex >= 0
+                ? m_model->index(row, 0).data(m_roleEntryIndex).toInt() : row;
+            const QSharedPointer<RowLayout> rl = rowLayout(row, entryIndex, firstCell, lastCell);
+            widestCells = qMax(widestCells, rl->fullCells);
+
+            if (m_selection && m_selection->contains(entryIndex))
+                m_frameRects.append({ rowRect, m_lineSelectionColor });
+            if (rl->lineColor.isValid())
+                m_frameRects.append({ rowRect, rl->lineColor });
+            if (std::binary_search(m_searchRows.cbegin(), m_searchRows.cend(), row))
+                m_frameRects.append({ rowRect, row == m_currentSearchRow ? m_currentSearchRowColor
+                                                                         : m_searchRowColor });
+
+            FrameRow fr;
+            fr.pos = QPointF(LeftPadding + rl->sliceStartCell * m_cellWidth - m_contentX, y + RowPadding);
+            fr.layout = rl;
+            for (const auto &bg : std::as_const(rl->backgrounds))
+                m_frameRects.append({ bg.first.translated(fr.pos), bg.second });
+
+            if (charSel && row >= selFirst && row <= selLast) {
+                const int textLength = rl->fullLength - rl->textStart;
+                int lo = 0;
+                int hi = textLength;
+                if (selFirst == selLast) {
+                    lo = qMin(m_anchorColumn, m_cursorColumn);
+                    hi = qMax(m_anchorColumn, m_cursorColumn);
+                } else if (row == selFirst) {
+                    lo = anchorIsTop ? m_anchorColumn : m_cursorColumn;
+                } else if (row == selLast) {
+                    hi = anchorIsTop ? m_cursorColumn : m_anchorColumn;
+                }
+                lo = qBound(0, lo, textLength);
+                hi = qBound(lo, hi, textLength);
+                // 完整列座標 → slice 座標
+                const int sliceLength = rl->sliceEnd - rl->sliceStart;
+                const int s0 = qBound(0, rl->textStart + lo - rl->sliceStart, sliceLength);
+                const int s1 = qBound(0, rl->textStart + hi - rl->sliceStart, sliceLength);
+                if (s1 > s0) {
+                    fr.selectionStart = s0;
+                    fr.selectionCount = s1 - s0;
+                }
+            }
+            m_frameRows.append(fr);
+        }
+
+        const qreal widest = widestCells * m_cellWidth + LeftPadding * 2;
+        if (widest > m_contentWidth) {
+            m_contentWidth = widest;
+            emit contentWidthChanged();
+        }
+        // contentWidth 歸零重算後可能比目前 contentX 短: 下一輪再夾回
+        if (m_contentX > qMax<qreal>(0, m_contentWidth - width()))
+            QMetaObject::invokeMethod(this, &TerminalRenderer::clampContentX, Qt::QueuedConnection);
+    }
+    update();
+}
+
+QSGNode *TerminalRenderer::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    // root ─┬─ 背景矩形(node 沿用,數量跟著矩形數增減,每 frame 只更新 rect / color)
+    //       └─ QSGTextNode(每 frame clear 後加入可見列的 layout)
+    QSGNode *root = oldNode;
+    QSGTextNode *textNode = nullptr;
+    QSGNode *rects = nullptr;
+    if (!root) {
+        root = new QSGNode;
+        rects = new QSGNode;
+        textNode = window()->createTextNode();
+        root->appendChildNode(rects);
+        root->appendChildNode(textNode);
+    } else {
+        rects = root->firstChild();
+        textNode = static_cast<QSGTextNode *>(root->lastChild());
+    }
+
+    while (rects->childCount() > m_frameRects.size()) {
+        QSGNode *child = rects->lastChild();
+        rects->removeChildNode(child);
+        delete child;
+    }
+    while (rects->childCount() < m_frameRects.size())
+        rects->appendChildNode(window()->createRectangleNode());
+
+    QSGNode *child = rects->firstChild();
+    for (const auto &r : std::as_const(m_frameRects)) {
+        auto *node = static_cast<QSGRectangleNode *>(child);
+        // 值沒變就不設,免得 node 被標 dirty 重新上傳
+        if (node->rect() != r.first)
+            node->setRect(r.first);
+        if (node->color() != r.second)
+            node->setColor(r.second);
+        child = child->nextSibling();
+    }
+
+    textNode->clear();
+    textNode->setSelectionColor(m_selectionColor);
+    textNode->setSelectionTextColor(m_selectedTextColor);
+    for (const FrameRow &fr : std::as_const(m_frameRows))
+        textNode->addTextLayout(fr.pos, &fr.layout->layout, fr.selectionStart, fr.selectionCount);
+
+    return root;
+}
@@ -0,0 +1,236 @@
+#ifndef TERMINALRENDERER_H
+#define TERMINALRENDERER_H
+
+#include <QAbstractItemModel>
+#include <QColor>
+#include <QFont>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QQuickItem>
+#include <QRectF>
+#include <QSharedPointer>
+#include <QTextLayout>
+#include <QtQml/qqmlregistration.h>
+#include "TerminalSelection.h"
+
+// 終端機輸出的 scene graph renderer(取代 ListView + RichText delegate)。
+// - 固定列高 / 固定字寬(monospace cell):row = floor(y / rowHeight),
+//   捲動與 hit-test 都是 O(1),百萬列 buffer 也只處理可見範圍;
+//   寬字(CJK / 全形 / emoji)佔兩格、組合字元不佔格,列內游標位置以 layout 為準
+// - 每列一個 QTextLayout(依 entryIndex 快取),per-run 色彩用 format range,
+//   glyph 交給 QSGTextNode(scene graph 共用的 glyph cache)
+// - model 可以是 TerminalModel、TerminalView 或 MappedLogModel,依 role 名稱取資料
+// - 不換行,水平捲動(contentX):長列(4096 bytes 的 hex 約 12K 字)只 layout 可見欄位附近的
+//   一段 slice,layout 成本取決於視窗寬度而非行長;捲出 slice 才重建該列
+class TerminalRenderer : public QQuickItem
+{
+    Q_OBJECT
+    QML_ELEMENT
+    Q_PROPERTY(QAbstractItemModel *model READ model WRITE setModel NOTIFY modelChanged)
+    Q_PROPERTY(QFont font READ font WRITE setFont NOTIFY fontChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(qreal contentY READ contentY WRITE setContentY NOTIFY contentYChanged)
+    Q_PROPERTY(qreal contentHeight READ contentHeight NOTIFY contentHeightChanged)
+    Q_PROPERTY(qreal contentX READ contentX WRITE setContentX NOTIFY contentXChanged)
+    // 目前看過的最長列寬(model / 顯示選項變更時歸零重算)
+    Q_PROPERTY(qreal contentWidth READ contentWidth NOTIFY contentWidthChanged)
+    Q_PROPERTY(qreal rowHeight READ rowHeight NOTIFY metricsChanged)
+    Q_PROPERTY(qreal cellWidth READ cellWidth NOTIFY metricsChanged)
+
+    // 顯示選項
+    Q_PROPERTY(bool showLineNumbers MEMBER m_showLineNumbers NOTIFY appearanceChanged)
+    Q_PROPERTY(bool showTimestamp MEMBER m_showTimestamp NOTIFY appearanceChanged)
+    Q_PROPERTY(bool showPrefix MEMBER m_showPrefix NOTIFY appearanceChanged)
+    Q_PROPERTY(bool hexMode MEMBER m_hexMode NOTIFY appearanceChanged)
+
+    // 色彩(theme)
+    Q_PROPERTY(QColor textColor MEMBER m_textColor NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor rxColor MEMBER m_rxColor NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor txColor MEMBER m_txColor NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor systemColor MEMBER m_systemColor NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor errorColor MEMBER m_errorColor NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor lineNumberColor MEMBER m_lineNumberColor NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor timestampColor MEMBER m_timestampColor NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor numberColor MEMBER m_numberColor NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor keywordBgTextColor MEMBER m_keywordBgTextColor NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor selectionColor MEMBER m_selectionColor NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor selectedTextColor MEMBER m_selectedTextColor NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor lineSelectionColor MEMBER m_lineSelectionColor NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor searchRowColor MEMBER m_searchRowColor NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor currentSearchRowColor MEMBER m_currentSearchRowColor NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor searchHitColor MEMBER m_searchHitColor NOTIFY appearanceChanged)
+
+    // 整列選取(依 entryIndex)
+    Q_PROPERTY(TerminalSelection *selection READ selection WRITE setSelection NOTIFY selectionChanged)
+
+    // 搜尋命中列(model row,遞增)與目前所在的命中列
+    Q_PROPERTY(QList<int> searchRows MEMBER m_searchRows NOTIFY searchChanged)
+    Q_PROPERTY(int currentSearchRow MEMBER m_currentSearchRow NOTIFY searchChanged)
+
+    // 字元層級選取(anchor → cursor,column 以 prefix + data 的顯示文字計)
+    Q_PROPERTY(bool hasCharSelection READ hasCharSelection NOTIFY charSelectionChanged)
+    Q_PROPERTY(int charSelectionFirstRow READ charSelectionFirstRow NOTIFY charSelectionChanged)
+    Q_PROPERTY(int charSelectionLastRow READ charSelectionLastRow NOTIFY charSelectionChanged)
+
+public:
+    explicit TerminalRenderer(QQuickItem *parent = nullptr);
+
+    QAbstractItemModel *model() const { return m_model; }
+    void setModel(QAbstractItemModel *model);
+    QFont font() const { return m_font; }
+    void setFont(const QFont &font);
+    int count() const { return m_model ? m_model->rowCount() : 0; }
+    qreal contentY() const { return m_contentY; }
+    void setContentY(qreal y);
+    qreal contentHeight() const { return count() * m_rowHeight; }
+    qreal contentX() const { return m_contentX; }
+    void setContentX(qreal x);
+    qreal contentWidth() const { return m_contentWidth; }
+    qreal rowHeight() const { return m_rowHeight; }
+    qreal cellWidth() const { return m_cellWidth; }
+
+    TerminalSelection *selection() const { return m_selection; }
+    void setSelection(TerminalSelection *selection);
+
+    bool hasCharSelection() const;
+    int charSelectionFirstRow() const;
+    int charSelectionLastRow() const;
+
+    // item 座標 → model row(超出範圍 = -1)/ 顯示文字的 column(UTF-16 index,最近的字元邊界)
+    Q_INVOKABLE int rowAt(qreal y) const;
+    Q_INVOKABLE int columnAt(int row, qreal x) const;
+    Q_INVOKABLE void positionViewAtRow(int row);   // 置中
+    Q_INVOKABLE void positionViewAtEnd();
+
+    Q_INVOKABLE void setCharSelectionAnchor(int row, int column);
+    Q_INVOKABLE void extendCharSelection(int row, int column);
+    Q_INVOKABLE void selectWordAt(int row, int column);
+    Q_INVOKABLE void clearCharSelection();
+    // 單列: 顯示文字的片段;跨列: 首列取 anchor 之後、中間列只取資料、末列取到 cursor
+    Q_INVOKABLE QString selectedText() const;
+    // prefix + data(不含行號 / timestamp),與 column 座標一致
+    Q_INVOKABLE QString displayText(int row) const;
+
+signals:
+    void modelChanged();
+    void fontChanged();
+    void countChanged();
+    void contentYChanged();
+    void contentHeightChanged();
+    void contentXChanged();
+    void contentWidthChanged();
+    void metricsChanged();
+    void appearanceChanged();
+    void searchChanged();
+    void selectionChanged();
+    void charSelectionChanged();
+
+protected:
+    void updatePolish() override;
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+
+private slots:
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onModelReset();
+    void onLayoutInvalidated();
+
+private:
+    struct RowLayout {
+        QTextLayout layout;
+        int textStart = 0;   // prefix + data 在 layout 中的起點(= gutter 長度)
+        int dataStart = 0;   // data 的起點(styleRuns 以 data 為基準)
+        int fullLength = 0;  // 完整列(gutter + prefix + data)的字元數
+        int sliceStart = 0;  // layout 只含完整列的 [sliceStart, sliceEnd)
+        int sliceEnd = 0;
+        int sliceStartCell = 0;   // slice 邊界與整列的顯示寬度(cell 數)
+        int sliceEndCell = 0;
+        int fullCells = 0;
+        QList<QPair<QRectF, QColor>> backgrounds;   // 相對 layout 原點(= sliceStart 欄)
+        QColor lineColor;
+    };
+    struct FrameRow {
+        QPointF pos;
+        QSharedPointer<RowLayout> layout;
+        int selectionStart = -1;
+        int selectionCount = 0;
+    };
+    struct RowData {
+        QString timestamp;
+        QString msgText;
+        QString hexData;
+        QString type;
+        int entryIndex = -1;
+    };
+
+    RowData rowData(int row) const;
+    QString dataText(const RowData &d) const;
+    QString prefixText(const QString &type) const;
+    QColor typeColor(const QString &type) const;
+    // 保證 layout 涵蓋 cell [firstCell, lastCell)
+    QSharedPointer<RowLayout> rowLayout(int row, int entryIndex, int firstCell, int lastCell);
+    void clampContentX();
+    void updateMetrics();
+    void invalidateLayouts();
+    void scheduleRefresh();
+    void clampContentY();
+    int roleFor(const QByteArray &name) const;
+
+    QPointer<QAbstractItemModel> m_model;
+    QList<QMetaObject::Connection> m_modelConnections;
+    int m_roleTimestamp = -1;
+    int m_roleMsgText = -1;
+    int m_roleHexData = -1;
+    int m_roleType = -1;
+    int m_roleEntryIndex = -1;
+    int m_roleStyleRuns = -1;
+    int m_roleLineColor = -1;
+
+    QFont m_font;
+    qreal m_cellWidth = 8;
+    qreal m_rowHeight = 18;
+    qreal m_contentY = 0;
+    qreal m_contentX = 0;
+    qreal m_contentWidth = 0;
+
+    bool m_showLineNumbers = false;
+    bool m_showTimestamp = true;
+    bool m_showPrefix = true;
+    bool m_hexMode = false;
+
+    QColor m_textColor = QColor(0xe0, 0xe0, 0xe0);
+    QColor m_rxColor = QColor(0x00, 0xff, 0x88);
+    QColor m_txColor = QColor(0x00, 0xd4, 0xff);
+    QColor m_systemColor = QColor(0xff, 0x00, 0xff);
+    QColor m_errorColor = QColor(0xff, 0x33, 0x66);
+    QColor m_lineNumberColor = QColor(0x6b, 0x72, 0x80, 0x80);
+    QColor m_timestampColor = QColor(0x6b, 0x72, 0x80);
+    QColor m_numberColor = QColor(0x00, 0xd4, 0xff);
+    QColor m_keywordBgTextColor = QColor(0x0a, 0x0a, 0x0f);
+    QColor m_selectionColor = QColor(0x00, 0xff, 0x88, 0x99);
+    QColor m_selectedTextColor = QColor(0x0a, 0x0a, 0x0f);
+    QColor m_lineSelectionColor = QColor(0x00, 0xff, 0x88, 0x26);
+    QColor m_searchRowColor = QColor(255, 170, 0, 31);          // rgba(255,170,0,0.12)
+    QColor m_currentSearchRowColor = QColor(255, 170, 0, 89);   // rgba(255,170,0,0.35)
+    QColor m_searchHitColor = QColor(255, 170, 0, 140);
+
+    QList<int> m_searchRows;
+    int m_currentSearchRow = -1;
+    QPointer<TerminalSelection> m_selection;
+    QMetaObject::Connection m_selectionConnection;
+
+    int m_anchorRow = -1;
+    int m_anchorColumn = 0;
+    int m_cursorRow = -1;
+    int m_cursorColumn = 0;
+
+    // entryIndex → 已 layout 的列;超量時整批丟棄(目前 frame 仍持有 shared pointer)
+    QHash<int, QSharedPointer<RowLayout>> m_rowCache;
+    // updatePolish(GUI thread)產生,updatePaintNode(render thread)消費
+    QList<FrameRow> m_frameRows;
+    QList<QPair<QRectF, QColor>> m_frameRects;
+};
+
+#endif // TERMINALRENDERER_H
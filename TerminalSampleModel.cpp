@@ -0,0 +1,42 @@
+#include "TerminalSampleModel.h"
+
+TerminalSampleModel::TerminalSampleModel(TerminalModel *source)
+    : QAbstractListModel(source)
+    , m_source(source)
+{
+    connect(m_source, &TerminalModel::styleChanged, this, &TerminalSampleModel::onStyleChanged);
+}
+
+int TerminalSampleModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_entries.size();
+}
+
+QVariant TerminalSampleModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_entries.size())
+        return QVariant();
+    return m_source->entryData(m_entries.at(index.row()), role);
+}
+
+QHash<int, QByteArray> TerminalSampleModel::roleNames() const
+{
+    return TerminalModel::entryRoleNames();
+}
+
+void TerminalSampleModel::setEntries(const QList<TerminalEntry> &entries)
+{
+    // 列數固定為一個畫面: 整批替換比逐列 insert/remove 便宜
+    beginResetModel();
+    m_entries = entries;
+    endResetModel();
+}
+
+void TerminalSampleModel::onStyleChanged()
+{
+    if (!m_entries.isEmpty())
+        emit dataChanged(index(0), index(m_entries.size() - 1),
+                         { TerminalModel::StyleRunsRole, TerminalModel::LineColorRole });
+}
@@ -0,0 +1,31 @@
+#ifndef TERMINALSAMPLEMODEL_H
+#define TERMINALSAMPLEMODEL_H
+
+#include <QAbstractListModel>
+#include <QList>
+#include "TerminalModel.h"
+
+// flood mode 時畫面顯示的取樣: source 最新一個畫面份量的可見列(entry 複本,字串隱式共用)。
+// 由 TerminalModel 節流更新,role 與 TerminalModel 相同,renderer 可直接切換 model。
+class TerminalSampleModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit TerminalSampleModel(TerminalModel *source);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    void setEntries(const QList<TerminalEntry> &entries);
+
+private slots:
+    void onStyleChanged();
+
+private:
+    TerminalModel *m_source;
+    QList<TerminalEntry> m_entries;
+};
+
+#endif // TERMINALSAMPLEMODEL_H
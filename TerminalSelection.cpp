@@ -0,0 +1,111 @@
+#include "TerminalSelection.h"
+#include <algorithm>
+
+TerminalSelection::TerminalSelection(QObject *parent)
+    : QObject(parent)
+{
+}
+
+bool TerminalSelection::contains(int entryIndex) const
+{
+    // 第一個 hi >= entryIndex 的區間
+    auto it = std::lower_bound(m_ranges.cbegin(), m_ranges.cend(), entryIndex,
+                               [](const Range &r, int v) { return r.hi < v; });
+    return it != m_ranges.cend() && it->lo <= entryIndex;
+}
+
+void TerminalSelection::selectOnly(int entryIndex)
+{
+    m_ranges = { { entryIndex, entryIndex } };
+    recount();
+    emit changed();
+}
+
+void TerminalSelection::toggle(int entryIndex)
+{
+    if (contains(entryIndex))
+        remove(entryIndex);
+    else
+        insert(entryIndex, entryIndex);
+    recount();
+    emit changed();
+}
+
+void TerminalSelection::selectRange(int loEntryIndex, int hiEntryIndex, bool extend)
+{
+    if (loEntryIndex > hiEntryIndex)
+        std::swap(loEntryIndex, hiEntryIndex);
+    if (!extend)
+        m_ranges.clear();
+    insert(loEntryIndex, hiEntryIndex);
+    recount();
+    emit changed();
+}
+
+void TerminalSelection::clear()
+{
+    if (m_ranges.isEmpty())
+        return;
+    m_ranges.clear();
+    m_count = 0;
+    emit changed();
+}
+
+void TerminalSelection::trimBelow(int floor)
+{
+    // 只碰落在下限以下的頭部區間,count 直接扣除,不重算
+    int drop = 0;
+    while (drop < m_ranges.size() && m_ranges.at(drop).hi < floor) {
+        m_count -= m_ranges.at(drop).hi - m_ranges.at(drop).lo + 1;
+        ++drop;
+    }
+    const bool clip = drop < m_ranges.size() && m_ranges.at(drop).lo < floor;
+    if (drop == 0 && !clip)
+        return;
+
+    m_ranges.remove(0, drop);
+    if (clip) {
+        m_count -= floor - m_ranges.first().lo;
+        m_ranges.first().lo = floor;
+    }
+    emit changed();
+}
+
+void TerminalSelection::insert(int lo, int hi)
+{
+    // 第一個可能與 [lo, hi] 重疊或相鄰的區間
+    auto first = std::lower_bound(m_ranges.begin(), m_ranges.end(), lo,
+                                  [](const Range &r, int v) { return r.hi < v - 1; });
+    auto last = first;
+    while (last != m_ranges.end() && last->lo <= hi + 1) {
+        lo = qMin(lo, last->lo);
+        hi = qMax(hi, last->hi);
+        ++last;
+    }
+    const qsizetype pos = first - m_ranges.begin();
+    m_ranges.erase(first, last);
+    m_ranges.insert(pos, { lo, hi });
+}
+
+void TerminalSelection::remove(int entryIndex)
+{
+    auto it = std::lower_bound(m_ranges.begin(), m_ranges.end(), entryIndex,
+                               [](const Range &r, int v) { return r.hi < v; });
+    if (it == m_ranges.end() || it->lo > entryIndex)
+        return;
+
+    const Range r = *it;
+    const qsizetype pos = it - m_ranges.begin();
+    m_ranges.removeAt(pos);
+    if (entryIndex < r.hi)
+        m_ranges.insert(pos, { entryIndex + 1, r.hi });
+    if (r.lo < entryIndex)
+        m_ranges.insert(pos, { r.lo, entryIndex - 1 });
+}
+
+void TerminalSelection::recount()
+{
+    m_count = 0;
+    for (const Range &r : std::as_const(m_ranges))
+        m_count += r.hi - r.lo + 1;
+}
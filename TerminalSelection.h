@@ -0,0 +1,53 @@
+#ifndef TERMINALSELECTION_H
+#define TERMINALSELECTION_H
+
+#include <QList>
+#include <QObject>
+#include <QtQml/qqmlregistration.h>
+
+// 整列選取(取代 QML 的 selectedSet JS object)。
+// 以 entryIndex 的排序區間 [lo, hi] 儲存:拖曳 / 全選 20 萬列也只是一個區間。
+// entryIndex 全域遞增且修剪只去頭,所以修剪 = 抬高下限(trimBelow),不必逐筆改鍵值。
+// 區間可能包含被 filter 隱藏的 entry;複製時只輸出 view 中可見的列。
+class TerminalSelection : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("TerminalSelection is owned by TerminalModel")
+    Q_PROPERTY(int count READ count NOTIFY changed)
+
+public:
+    struct Range {
+        int lo;
+        int hi;   // 含
+    };
+
+    explicit TerminalSelection(QObject *parent = nullptr);
+
+    int count() const { return m_count; }
+    bool isEmpty() const { return m_ranges.isEmpty(); }
+    const QList<Range> &ranges() const { return m_ranges; }
+
+    Q_INVOKABLE bool contains(int entryIndex) const;
+    Q_INVOKABLE void selectOnly(int entryIndex);
+    Q_INVOKABLE void toggle(int entryIndex);
+    // extend = false 時取代既有選取
+    Q_INVOKABLE void selectRange(int loEntryIndex, int hiEntryIndex, bool extend);
+    Q_INVOKABLE void clear();
+
+    // 修剪: entryIndex < floor 的部分丟棄(攤銷 O(1))
+    void trimBelow(int floor);
+
+signals:
+    void changed();
+
+private:
+    void insert(int lo, int hi);
+    void remove(int entryIndex);
+    void recount();
+
+    QList<Range> m_ranges;   // 依 lo 排序,互不重疊也不相鄰
+    int m_count = 0;
+};
+
+#endif // TERMINALSELECTION_H
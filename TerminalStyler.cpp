@@ -0,0 +1,178 @@
+#include "TerminalStyler.h"
+#include "TerminalModel.h"
+#include <QVariantMap>
+
+static inline bool isWordChar(QChar c)
+{
+    return c.isLetterOrNumber() || c == QLatin1Char('_');
+}
+
+static inline bool isHexDigit(QChar c)
+{
+    const ushort u = c.unicode();
+    return (u >= '0' && u <= '9') || (u >= 'a' && u <= 'f') || (u >= 'A' && u <= 'F');
+}
+
+static inline bool isDigit(QChar c)
+{
+    return c.unicode() >= '0' && c.unicode() <= '9';
+}
+
+void TerminalStyler::setKeywords(const QVariantList &keywords)
+{
+    m_keywords.clear();
+    for (const QVariant &v : keywords) {
+        const QVariantMap kw = v.toMap();
+        if (!kw.value(QStringLiteral("enabled")).toBool())
+            continue;
+        const QString text = kw.value(QStringLiteral("text")).toString();
+        if (text.isEmpty())
+            continue;
+        Keyword k;
+        k.text = text;
+        k.colorName = kw.value(QStringLiteral("color")).toString();
+        k.color = QColor(k.colorName).rgba();
+        k.mode = kw.value(QStringLiteral("mode")).toString();
+        if (k.mode.isEmpty())
+            k.mode = QStringLiteral("bg");
+        m_keywords.append(k);
+    }
+}
+
+void TerminalStyler::setSearch(const QString &query, bool isRegex)
+{
+    if (query.isEmpty()) {
+        m_search = QRegularExpression();
+        return;
+    }
+    m_search = QRegularExpression(isRegex ? query : QRegularExpression::escape(query),
+                                  QRegularExpression::CaseInsensitiveOption);
+    if (m_search.isValid())
+        m_search.optimize();
+    else
+        m_search = QRegularExpression();
+}
+
+const QString &TerminalStyler::displayText(const TerminalEntry &e) const
+{
+    return (m_hexMode && !e.hexData.isEmpty()) ? e.hexData : e.msgText;
+}
+
+QString TerminalStyler::hlColor(const TerminalEntry &e) const
+{
+    const QString &text = displayText(e);
+    for (const Keyword &kw : m_keywords) {
+        if (text.contains(kw.text, Qt::CaseInsensitive))
+            return kw.colorName;
+    }
+    return QString();
+}
+
+QString TerminalStyler::lineColor(const QString &text) const
+{
+    for (const Keyword &kw : m_keywords) {
+        if (kw.mode == QLatin1String("line") && text.contains(kw.text, Qt::CaseInsensitive))
+            return kw.colorName;
+    }
+    return QString();
+}
+
+QList<int> TerminalStyler::runs(const QString &text) const
+{
+    QList<int> result;
+    if (text.isEmpty())
+        return result;
+
+    QList<bool> claimed;
+    bool anyClaimed = false;
+
+    for (const Keyword &kw : m_keywords) {
+        if (kw.mode == QLatin1String("line"))
+            continue;
+        const int kind = (kw.mode == QLatin1String("text")) ? KeywordTextRun : KeywordBgRun;
+        int from = 0;
+        while ((from = text.indexOf(kw.text, from, Qt::CaseInsensitive)) >= 0) {
+            const int len = kw.text.size();
+            if (!anyClaimed) {
+                claimed.fill(false, text.size());
+                anyClaimed = true;
+            }
+            // 與先前(優先序較高)的 keyword 重疊時整段讓出,維持 run 不交錯
+            bool free = true;
+            for (int i = from; i < from + len; ++i) {
+                if (claimed.at(i)) {
+                    free = false;
+                    break;
+                }
+            }
+            if (free) {
+                for (int i = from; i < from + len; ++i)
+                    claimed[i] = true;
+                result << from << len << kind << int(kw.color);
+            }
+            from += len;
+        }
+    }
+
+    if (m_colorNumbers)
+        appendNumberRuns(text, result, anyClaimed ? claimed : QList<bool>());
+
+    if (m_search.isValid() && !m_search.pattern().isEmpty()) {
+        QRegularExpressionMatchIterator it = m_search.globalMatch(text);
+        while (it.hasNext()) {
+            const QRegularExpressionMatch m = it.next();
+            if (m.capturedLength() > 0)
+                result << int(m.capturedStart()) << int(m.capturedLength()) << SearchHitRun << 0;
+        }
+    }
+    return result;
+}
+
+// 等同 JS 的 /\b(?:0x[0-9a-fA-F]+|\d+\.?\d*)\b/,手寫掃描避免每行跑 regex
+void TerminalStyler::appendNumberRuns(const QString &text, QList<int> &runs,
+                                      const QList<bool> &claimed) const
+{
+    const int n = text.size();
+    int i = 0;
+    while (i < n) {
+        if (!isDigit(text.at(i)) || (i > 0 && isWordChar(text.at(i - 1)))) {
+            ++i;
+            continue;
+        }
+        int end = i;
+        if (text.at(i) == QLatin1Char('0') && i + 2 < n
+            && (text.at(i + 1) == QLatin1Char('x') || text.at(i + 1) == QLatin1Char('X'))
+            && isHexDigit(text.at(i + 2))) {
+            end = i + 2;
+            while (end < n && isHexDigit(text.at(end)))
+                ++end;
+        } else {
+            while (end < n && isDigit(text.at(end)))
+                ++end;
+            if (end + 1 < n && text.at(end) == QLatin1Char('.') && isDigit(text.at(end + 1))) {
+                ++end;
+                while (end < n && isDigit(text.at(end)))
+                    ++end;
+            }
+        }
+        if (end < n && isWordChar(text.at(end))) {
+            // 不在字界上(如 "12abc"): 跳過整個 word
+            while (end < n && isWordChar(text.at(end)))
+                ++end;
+            i = end;
+            continue;
+        }
+        bool free = true;
+        if (!claimed.isEmpty()) {
+            for (int k = i; k < end; ++k) {
+                if (claimed.at(k)) {
+                    free = false;
+                    break;
+                }
+            }
+        }
+        if (free)
+            runs << i << (end - i) << NumberRun << 0;
+        i = end;
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef TERMINALSTYLER_H
+#define TERMINALSTYLER_H
+
+#include <QColor>
+#include <QList>
+#include <QRegularExpression>
+#include <QString>
+#include <QVariantList>
+
+struct TerminalEntry;
+
+// 行內樣式計算(取代 main.qml 的 highlightText: HTML escape + 每個 keyword 一次 JS regex)。
+// 輸出扁平 int 陣列 [start, length, kind, argb, ...],QML 收到即 JS array,
+// C++ renderer 直接 value<QList<int>>(),兩邊都不必產生/解析 HTML。
+// - keyword(bg/text 模式)依序優先,先命中者佔用字元;數字只標未被佔用的字元
+// - 搜尋命中為背景標記,可與其他 run 重疊
+class TerminalStyler
+{
+public:
+    enum RunKind {
+        KeywordBgRun = 0,   // 背景 = keyword 色,文字 = 背景色,粗體
+        KeywordTextRun,     // 文字 = keyword 色,粗體
+        NumberRun,          // 色彩由 renderer 依 theme 決定(argb = 0)
+        SearchHitRun        // 背景標記(argb = 0)
+    };
+    static const int RunStride = 4;
+
+    // QML keyword 清單 [{text, color, enabled, mode}]
+    void setKeywords(const QVariantList &keywords);
+    void setHexMode(bool hexMode) { m_hexMode = hexMode; }
+    bool hexMode() const { return m_hexMode; }
+    void setColorNumbers(bool enabled) { m_colorNumbers = enabled; }
+    bool colorNumbers() const { return m_colorNumbers; }
+    // 空字串 = 清除搜尋標記;regex 無效時同樣視為清除
+    void setSearch(const QString &query, bool isRegex);
+    bool hasKeywords() const { return !m_keywords.isEmpty(); }
+
+    // 顯示用文字: hex 模式且有 hex 時為 hexData,否則 msgText
+    const QString &displayText(const TerminalEntry &e) const;
+    // 第一個命中的 keyword 色(任何模式,scroll bar 標記用)
+    QString hlColor(const TerminalEntry &e) const;
+    // 第一個命中的 line 模式 keyword 色(整列背景)
+    QString lineColor(const QString &text) const;
+    QList<int> runs(const QString &text) const;
+
+private:
+    struct Keyword {
+        QString text;
+        QString colorName;
+        QRgb color = 0;
+        QString mode;   // "bg" | "text" | "line"
+    };
+
+    void appendNumberRuns(const QString &text, QList<int> &runs, const QList<bool> &claimed) const;
+
+    QList<Keyword> m_keywords;   // 已啟用,順序 = 優先序
+    bool m_hexMode = false;
+    bool m_colorNumbers = true;
+    QRegularExpression m_search;
+};
+
+#endif // TERMINALSTYLER_H
@@ -0,0 +1,146 @@
+#include "TerminalView.h"
+#include <QRegularExpression>
+
+TerminalView::TerminalView(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int TerminalView::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !m_source)
+        return 0;
+    return m_visible.size();
+}
+
+QVariant TerminalView::data(const QModelIndex &index, int role) const
+{
+    if (!m_source || !index.isValid() || index.row() < 0 || index.row() >= m_visible.size())
+        return QVariant();
+    return m_source->entryData(m_source->entryAt(m_visible.at(index.row())), role);
+}
+
+QHash<int, QByteArray> TerminalView::roleNames() const
+{
+    return TerminalModel::entryRoleNames();
+}
+
+void TerminalView::setSource(TerminalModel *source)
+{
+    if (m_source == source)
+        return;
+    if (m_source)
+        disconnect(m_source, nullptr, this, nullptr);
+
+    m_source = source;
+    if (m_source) {
+        connect(m_source, &TerminalModel::entriesCommitted, this, &TerminalView::onEntriesCommitted);
+        connect(m_source, &TerminalModel::trimmed, this, &TerminalView::onTrimmed);
+        connect(m_source, &TerminalModel::storeCleared, this, &TerminalView::rebuild);
+        connect(m_source, &TerminalModel::styleChanged, this, &TerminalView::onStyleChanged);
+    }
+    rebuild();
+    emit sourceChanged();
+}
+
+void TerminalView::setFilters(const QVariantList &filters)
+{
+    QStringList errors;
+    m_filter = TerminalFilter::fromVariantList(filters, &errors);
+    for (const QString &err : std::as_const(errors))
+        emit filterQueryError(err);
+    rebuild();
+    emit filterActiveChanged();
+}
+
+void TerminalView::rebuild()
+{
+    beginResetModel();
+    m_visible.clear();
+    if (m_source) {
+        for (int i = 0; i < m_source->totalCount(); ++i) {
+            if (m_filter.matches(m_source->entryAt(i)))
+                m_visible.append(i);
+        }
+    }
+    endResetModel();
+    emit countChanged();
+}
+
+void TerminalView::onStyleChanged()
+{
+    if (!m_visible.isEmpty())
+        emit dataChanged(index(0), index(m_visible.size() - 1),
+                         { TerminalModel::StyleRunsRole, TerminalModel::LineColorRole });
+}
+
+void TerminalView::onEntriesCommitted(int first, int count)
+{
+    QList<int> adds;
+    for (int i = first; i < first + count; ++i) {
+        if (m_filter.matches(m_source->entryAt(i)))
+            adds.append(i);
+    }
+    if (adds.isEmpty())
+        return;
+
+    const int row = m_visible.size();
+    beginInsertRows(QModelIndex(), row, row + adds.size() - 1);
+    m_visible.append(adds);
+    endInsertRows();
+    emit countChanged();
+}
+
+// source 去頭: 與 TerminalModel::trimIfNeeded 共用 TerminalFilter 的索引同步
+void TerminalView::onTrimmed(int removedCount, int removedMaxEntryIndex)
+{
+    Q_UNUSED(removedMaxEntryIndex)
+
+    const int visRemove = TerminalFilter::trimmedRows(m_visible, removedCount);
+    if (visRemove > 0)
+        beginRemoveRows(QModelIndex(), 0, visRemove - 1);
+    TerminalFilter::dropTrimmed(m_visible, visRemove, removedCount);
+    if (visRemove > 0) {
+        endRemoveRows();
+        emit countChanged();
+    }
+}
+
+QVariantMap TerminalView::get(int row) const
+{
+    if (!m_source || row < 0 || row >= m_visible.size())
+        return QVariantMap();
+    return TerminalModel::entryToMap(m_source->entryAt(m_visible.at(row)));
+}
+
+QVariantList TerminalView::search(const QString &query, bool isRegex, bool hexMode) const
+{
+    QVariantList matches;
+    if (!m_source || query.isEmpty())
+        return matches;
+
+    const QString pattern = isRegex ? query : QRegularExpression::escape(query);
+    QRegularExpression re(pattern, QRegularExpression::CaseInsensitiveOption);
+    if (!re.isValid())
+        return matches;
+
+    for (int row = 0; row < m_visible.size(); ++row) {
+        const TerminalEntry &e = m_source->entryAt(m_visible.at(row));
+        const QString &text = (hexMode && !e.hexData.isEmpty()) ? e.hexData : e.msgText;
+        if (re.match(text).hasMatch())
+            matches.append(row);
+    }
+    return matches;
+}
+
+QVariantList TerminalView::entryIndicesInRange(int loRow, int hiRow) const
+{
+    QVariantList result;
+    if (!m_source || m_visible.isEmpty())
+        return result;
+    const int lo = qBound(0, loRow, m_visible.size() - 1);
+    const int hi = qBound(0, hiRow, m_visible.size() - 1);
+    for (int row = lo; row <= hi; ++row)
+        result.append(m_source->entryAt(m_visible.at(row)).entryIndex);
+    return result;
+}
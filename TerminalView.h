@@ -0,0 +1,58 @@
+#ifndef TERMINALVIEW_H
+#define TERMINALVIEW_H
+
+#include <QAbstractListModel>
+#include <QPointer>
+#include <QVariantList>
+#include <QVariantMap>
+#include <QtQml/qqmlregistration.h>
+#include "TerminalModel.h"
+
+// 共用 TerminalModel entry store 的輕量檢視(例如「只看錯誤」的並排 pane)。
+// - 每個 view 只持有自己的 filter 與 m_visible(m_all 索引),不複製 entry
+// - 跟著 source 的 entriesCommitted / trimmed / storeCleared 增量更新
+// QML: TerminalView { source: terminalModel }
+class TerminalView : public QAbstractListModel
+{
+    Q_OBJECT
+    QML_ELEMENT
+    Q_PROPERTY(TerminalModel *source READ source WRITE setSource NOTIFY sourceChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(bool filterActive READ filterActive NOTIFY filterActiveChanged)
+
+public:
+    explicit TerminalView(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    TerminalModel *source() const { return m_source; }
+    void setSource(TerminalModel *source);
+    int count() const { return m_visible.size(); }
+    bool filterActive() const { return m_filter.isActive(); }
+
+    Q_INVOKABLE QVariantMap get(int row) const;
+    Q_INVOKABLE void setFilters(const QVariantList &filters);
+    Q_INVOKABLE QVariantList search(const QString &query, bool isRegex, bool hexMode) const;
+    Q_INVOKABLE QVariantList entryIndicesInRange(int loRow, int hiRow) const;
+
+signals:
+    void sourceChanged();
+    void countChanged();
+    void filterActiveChanged();
+    void filterQueryError(const QString &message);
+
+private slots:
+    void onEntriesCommitted(int first, int count);
+    void onTrimmed(int removedCount, int removedMaxEntryIndex);
+    void rebuild();
+    void onStyleChanged();
+
+private:
+    QPointer<TerminalModel> m_source;
+    TerminalFilter m_filter;
+    QList<int> m_visible;   // source m_all 的索引,遞增
+};
+
+#endif // TERMINALVIEW_H
@@ -16,7 +16,16 @@
 #include "FileLogger.h"
 #include "ConfigManager.h"
 #include "TerminalModel.h"
+#include "TerminalExporter.h"
+#include "MappedLogModel.h"
+#include "HexDumpModel.h"
+#include "SignalExtractor.h"
+#include "FxImageProvider.h"
+#include "StartupTrace.h"
 #include "HeadlessRunner.h"
+#include "CaptureFormat.h"
+#include "LogIndex.h"
+#include "PcapngFormat.h"
 #include "version.h"
 
 #ifdef Q_OS_WIN
@@ -105,6 +114,46 @@ static bool hasArg(int argc, char *argv[], const char *name)
     return false;
 }
 
+// --sink "path:format[:query]";Windows 磁碟代號的 ':' 不算分隔。query 可再含 ':'(例: type:error)
+static LogTarget parseSink(const QString &spec)
+{
+    LogTarget target;
+    const bool drive = spec.size() > 2 && spec.at(1) == QLatin1Char(':')
+        && (spec.at(2) == QLatin1Char('\\') || spec.at(2) == QLatin1Char('/'));
+    const qsizetype pathEnd = spec.indexOf(QLatin1Char(':'), drive ? 2 : 0);
+    if (pathEnd < 0) {
+        target.path = spec;
+        return target;
+    }
+    target.path = spec.left(pathEnd);
+    const qsizetype formatEnd = spec.indexOf(QLatin1Char(':'), pathEnd + 1);
+    if (formatEnd < 0) {
+        target.format = spec.mid(pathEnd + 1);
+    } else {
+        target.format = spec.mid(pathEnd + 1, formatEnd - pathEnd - 1);
+        target.filter = spec.mid(formatEnd + 1);
+    }
+    return target;
+}
+
+// headless --port "NAME[@baud]";'@' 之後不是數字就整串當 port 名稱
+static HeadlessPort parsePort(const QString &spec, int defaultBaud)
+{
+    HeadlessPort port;
+    port.name = spec;
+    port.baud = defaultBaud;
+    const qsizetype at = spec.lastIndexOf(QLatin1Char('@'));
+    if (at > 0) {
+        bool ok = false;
+        const int baud = spec.mid(at + 1).toInt(&ok);
+        if (ok && baud > 0) {
+            port.name = spec.left(at);
+            port.baud = baud;
+        }
+    }
+    return port;
+}
+
 static void setupParser(QCommandLineParser &parser)
 {
     parser.setApplicationDescription(QStringLiteral("UART PRO Serial Terminal"));
@@ -113,17 +162,62 @@ static void setupParser(QCommandLineParser &parser)
                        QStringLiteral("Path to configuration JSON file."),
                        QStringLiteral("path") });
     parser.addOption({ QStringLiteral("port"),
-                       QStringLiteral("Auto-connect to this serial port on startup (e.g. COM3)."),
+                       QStringLiteral("Auto-connect to this serial port on startup (e.g. COM3). "
+                                      "Headless: repeatable, NAME@baud sets that port's baud rate."),
                        QStringLiteral("portName") });
     parser.addOption({ QStringLiteral("baud"),
-                       QStringLiteral("Baud rate to use for auto-connect (e.g. 115200)."),
+                       QStringLiteral("Baud rate to use for auto-connect (e.g. 115200); "
+                                      "headless: default for ports without @baud."),
                        QStringLiteral("baudRate") });
     parser.addOption({ QStringLiteral("record"),
                        QStringLiteral("Auto-start logging to this file path on startup."),
                        QStringLiteral("filePath") });
     parser.addOption({ QStringLiteral("format"),
-                       QStringLiteral("Record format: text (default) or jsonl."),
-                       QStringLiteral("text|jsonl") });
+                       QStringLiteral("Record format: text (default), jsonl, cap (binary raw capture) "
+                                      "or pcapng (Wireshark). With --convert: output format (text, jsonl or pcapng)."),
+                       QStringLiteral("text|jsonl|cap|pcapng") });
+    parser.addOption({ QStringLiteral("sink"),
+                       QStringLiteral("Headless: also log to this file (repeatable), with its own format and "
+                                      "filter query, e.g. errors.log:text:type:error"),
+                       QStringLiteral("path:format[:query]") });
+    parser.addOption({ QStringLiteral("rotate-size"),
+                       QStringLiteral("Headless: start a new log segment every N MB."),
+                       QStringLiteral("MB") });
+    parser.addOption({ QStringLiteral("rotate-every"),
+                       QStringLiteral("Headless: start a new log segment every N minutes."),
+                       QStringLiteral("minutes") });
+    parser.addOption({ QStringLiteral("compress"),
+                       QStringLiteral("Headless: gzip-compress log segments while writing.") });
+    parser.addOption({ QStringLiteral("disk-budget"),
+                       QStringLiteral("Headless: delete the oldest segments to keep the total under N MB."),
+                       QStringLiteral("MB") });
+    parser.addOption({ QStringLiteral("durability"),
+                       QStringLiteral("Headless: buffered (default), group (batched fdatasync) or line (sync every record)."),
+                       QStringLiteral("buffered|group|line") });
+    parser.addOption({ QStringLiteral("group-commit-ms"),
+                       QStringLiteral("Headless, --durability group: sync at least every N ms (default 1000)."),
+                       QStringLiteral("ms") });
+    parser.addOption({ QStringLiteral("group-commit-kb"),
+                       QStringLiteral("Headless, --durability group: sync after N KB (default 1024)."),
+                       QStringLiteral("KB") });
+    parser.addOption({ QStringLiteral("recover"),
+                       QStringLiteral("Truncate a partially written last record (crash leftover) and exit."),
+                       QStringLiteral("logPath") });
+    parser.addOption({ QStringLiteral("convert"),
+                       QStringLiteral("Convert a .cap capture to text/jsonl/pcapng, or a JSONL log to pcapng "
+                                      "(see --format, --out, --port) and exit."),
+                       QStringLiteral("capPath") });
+    parser.addOption({ QStringLiteral("tail-from-seq"),
+                       QStringLiteral("Print JSONL log lines with seq > N (uses the .idx sidecar to seek) and exit."),
+                       QStringLiteral("N") });
+    parser.addPositionalArgument(QStringLiteral("log"),
+                                 QStringLiteral("--tail-from-seq: the JSONL log to read."),
+                                 QStringLiteral("[log]"));
+    parser.addOption({ QStringLiteral("out"),
+                       QStringLiteral("Convert: output file (default: stdout)."),
+                       QStringLiteral("filePath") });
+    parser.addOption({ QStringLiteral("startup-trace"),
+                       QStringLiteral("Print a per-phase JSONL breakdown of the time to first frame.") });
     parser.addOption({ QStringLiteral("list-ports"),
                        QStringLiteral("Print available serial ports as JSON and exit.") });
     parser.addOption({ QStringLiteral("headless"),
@@ -131,23 +225,34 @@ static void setupParser(QCommandLineParser &parser)
     parser.addOption({ QStringLiteral("stdout"),
                        QStringLiteral("Headless: stream each received line as JSONL to stdout.") });
     parser.addOption({ QStringLiteral("expect"),
-                       QStringLiteral("Headless: exit 0 when a received line matches this regex."),
-                       QStringLiteral("regex") });
+                       QStringLiteral("Headless: exit 0 once every --expect regex has matched a line "
+                                      "(repeatable; PORT=regex only checks that port)."),
+                       QStringLiteral("[PORT=]regex") });
     parser.addOption({ QStringLiteral("expect-fail"),
-                       QStringLiteral("Headless: exit 5 when a received line matches this regex."),
-                       QStringLiteral("regex") });
+                       QStringLiteral("Headless: exit 5 when a received line matches this regex "
+                                      "(repeatable; PORT=regex only checks that port)."),
+                       QStringLiteral("[PORT=]regex") });
+    parser.addOption({ QStringLiteral("filter"),
+                       QStringLiteral("Headless: only record/stream lines matching this filter query."),
+                       QStringLiteral("query") });
     parser.addOption({ QStringLiteral("timeout"),
-                       QStringLiteral("Headless: exit 4 after this many seconds."),
-                       QStringLiteral("seconds") });
+                       QStringLiteral("Headless: exit 4 after this many seconds; PORT=seconds: exit 4 if "
+                                      "that port's --expect rules have not all matched by then (repeatable)."),
+                       QStringLiteral("[PORT=]seconds") });
 }
 
-// exit codes (headless / list-ports):
+// exit codes (headless / list-ports / convert):
 //   0 = 正常 / expect 命中 / 手動中斷
 //   2 = port 開啟失敗或缺 --port
 //   3 = record 檔開啟失敗
 //   4 = timeout
 //   5 = expect-fail 命中
-static int runCli(int argc, char *argv[], bool listPorts)
+//   6 = --filter 語法錯誤
+//   7 = --convert 的輸入不是 capture 檔(pcapng 輸出時也接受 JSONL log)
+// --recover / --tail-from-seq 開檔失敗時回 3
+enum class CliMode { ListPorts, Convert, Recover, Tail, Headless };
+
+static int runCli(int argc, char *argv[], CliMode mode)
 {
     QCoreApplication app(argc, argv);
     app.setOrganizationName(QStringLiteral("UARTPro"));
@@ -162,7 +267,43 @@ static int runCli(int argc, char *argv[], bool listPorts)
     setupParser(parser);
     parser.process(app);
 
-    if (listPorts) {
+    if (mode == CliMode::Convert) {
+        // pcapng 的 interface 名稱取 --port(轉檔時沒有連線,只當標籤)
+        if (parser.value(QStringLiteral("format")) == QLatin1String("pcapng")) {
+            return Pcapng::convert(parser.value(QStringLiteral("convert")),
+                                   parser.value(QStringLiteral("out")),
+                                   parser.value(QStringLiteral("port")));
+        }
+        return CaptureFormat::convert(parser.value(QStringLiteral("convert")),
+                                      parser.value(QStringLiteral("out")),
+                                      parser.value(QStringLiteral("format")));
+    }
+
+    if (mode == CliMode::Recover) {
+        const QString path = parser.value(QStringLiteral("recover"));
+        const qint64 dropped = LogSink::recoverTail(path, LogSink::detectContent(path));
+        QJsonObject o;
+        o[QStringLiteral("path")] = path;
+        o[QStringLiteral("truncated")] = qMax<qint64>(0, dropped);
+        if (dropped == LogSink::NotThisFormat)
+            o[QStringLiteral("error")] = QStringLiteral("unrecognized log format");
+        else if (dropped < 0)
+            o[QStringLiteral("error")] = QStringLiteral("cannot open");
+        printf("%s\n", QJsonDocument(o).toJson(QJsonDocument::Compact).constData());
+        fflush(stdout);
+        return dropped < 0 ? HeadlessRunner::ExitRecordFail : 0;
+    }
+
+    if (mode == CliMode::Tail) {
+        const QStringList args = parser.positionalArguments();
+        if (args.isEmpty()) {
+            fprintf(stderr, "--tail-from-seq requires a log path\n");
+            return HeadlessRunner::ExitRecordFail;
+        }
+        return LogIndex::tail(args.first(), parser.value(QStringLiteral("tail-from-seq")).toLongLong());
+    }
+
+    if (mode == CliMode::ListPorts) {
         QJsonArray arr;
         const auto ports = QSerialPortInfo::availablePorts();
         for (const auto &p : ports) {
@@ -178,21 +319,44 @@ static int runCli(int argc, char *argv[], bool listPorts)
     }
 
     HeadlessOptions opts;
-    opts.port = parser.value(QStringLiteral("port"));
-    if (opts.port.isEmpty()) {
+    const int defaultBaud = parser.isSet(QStringLiteral("baud"))
+        ? parser.value(QStringLiteral("baud")).toInt() : 115200;
+    const QStringList ports = parser.values(QStringLiteral("port"));
+    for (const QString &spec : ports) {
+        const HeadlessPort port = parsePort(spec, defaultBaud);
+        // 規則前綴 PORT= 不分大小寫比對名稱,重複的 port 無法區分
+        for (const HeadlessPort &seen : std::as_const(opts.ports)) {
+            if (seen.name.compare(port.name, Qt::CaseInsensitive) == 0) {
+                fprintf(stderr, "--port %s given more than once\n", qUtf8Printable(port.name));
+                return HeadlessRunner::ExitPortFail;
+            }
+        }
+        opts.ports.append(port);
+    }
+    if (opts.ports.isEmpty()) {
         fprintf(stderr, "--headless requires --port <COMx>\n");
         return HeadlessRunner::ExitPortFail;
     }
-    if (parser.isSet(QStringLiteral("baud")))
-        opts.baud = parser.value(QStringLiteral("baud")).toInt();
     opts.recordPath = parser.value(QStringLiteral("record"));
     if (parser.isSet(QStringLiteral("format")))
         opts.format = parser.value(QStringLiteral("format"));
+    const QStringList sinks = parser.values(QStringLiteral("sink"));
+    for (const QString &spec : sinks)
+        opts.sinks.append(parseSink(spec));
     opts.streamStdout = parser.isSet(QStringLiteral("stdout"));
-    opts.expectPattern = parser.value(QStringLiteral("expect"));
-    opts.expectFailPattern = parser.value(QStringLiteral("expect-fail"));
-    if (parser.isSet(QStringLiteral("timeout")))
-        opts.timeoutSec = parser.value(QStringLiteral("timeout")).toInt();
+    opts.expect = parser.values(QStringLiteral("expect"));
+    opts.expectFail = parser.values(QStringLiteral("expect-fail"));
+    opts.filterQuery = parser.value(QStringLiteral("filter"));
+    opts.timeouts = parser.values(QStringLiteral("timeout"));
+    opts.rotation.maxBytes = parser.value(QStringLiteral("rotate-size")).toLongLong() * 1048576;
+    opts.rotation.intervalMs = parser.value(QStringLiteral("rotate-every")).toLongLong() * 60000;
+    opts.rotation.compress = parser.isSet(QStringLiteral("compress"));
+    opts.rotation.diskBudget = parser.value(QStringLiteral("disk-budget")).toLongLong() * 1048576;
+    opts.durability.mode = LogDurability::modeFromName(parser.value(QStringLiteral("durability")));
+    if (parser.isSet(QStringLiteral("group-commit-ms")))
+        opts.durability.groupMs = qMax(1LL, parser.value(QStringLiteral("group-commit-ms")).toLongLong());
+    if (parser.isSet(QStringLiteral("group-commit-kb")))
+        opts.durability.groupBytes = qMax(1LL, parser.value(QStringLiteral("group-commit-kb")).toLongLong()) * 1024;
 
     HeadlessRunner runner(opts);
 #ifdef Q_OS_WIN
@@ -214,14 +378,28 @@ int main(int argc, char *argv[])
 {
     // CLI 模式不建 QGuiApplication / QML engine
     if (hasArg(argc, argv, "--list-ports"))
-        return runCli(argc, argv, true);
+        return runCli(argc, argv, CliMode::ListPorts);
+    if (hasArg(argc, argv, "--convert"))
+        return runCli(argc, argv, CliMode::Convert);
+    if (hasArg(argc, argv, "--recover"))
+        return runCli(argc, argv, CliMode::Recover);
+    if (hasArg(argc, argv, "--tail-from-seq"))
+        return runCli(argc, argv, CliMode::Tail);
     if (hasArg(argc, argv, "--headless"))
-        return runCli(argc, argv, false);
+        return runCli(argc, argv, CliMode::Headless);
+
+    // 計時從 main 開始(之前的 DLL 載入不在量測內)
+    StartupTrace startupTrace(hasArg(argc, argv, "--startup-trace"));
+#ifdef Q_OS_WIN
+    if (startupTrace.isEnabled())
+        initConsoleIO();
+#endif
 
     QGuiApplication app(argc, argv);
     app.setOrganizationName(QStringLiteral("UARTPro"));
     app.setApplicationName(QStringLiteral(APP_NAME));
     app.setApplicationVersion(QStringLiteral(APP_VERSION_STR));
+    startupTrace.mark(QStringLiteral("app_init"));
 
     QCommandLineParser parser;
     setupParser(parser);
@@ -233,15 +411,38 @@ int main(int argc, char *argv[])
     FileLogger fileLogger;
     ConfigManager configManager;
     TerminalModel terminalModel;
+    MappedLogModel mappedLog;   // 開啟既有 log 檔的唯讀檢視
+    // 匯出 buffer / 可見列 / 選取(worker thread);先於 mappedLog 解構,關檔前 worker 已停
+    TerminalExporter terminalExporter(&terminalModel, &mappedLog);
+    HexDumpModel hexDumpModel;
+    SignalExtractor signalExtractor;
 
     // RX 資料 C++ 直連 model(批次 flush),QML 不再逐行處理
     QObject::connect(&serialManager, &SerialPortManager::dataReceived,
                      &terminalModel, &TerminalModel::appendRxLine);
+    QObject::connect(&serialManager, &SerialPortManager::rawDataReceived,
+                     &hexDumpModel, &HexDumpModel::appendBytes);
+    // log 也在 C++ 端直連: 每批 flush 整批交給 FileLogger;開始記錄時先補寫既有內容
+    QObject::connect(&terminalModel, &TerminalModel::entriesFlushed,
+                     &fileLogger, &FileLogger::logEntries);
+    QObject::connect(&fileLogger, &FileLogger::sessionStarted, &terminalModel,
+                     [&]() { fileLogger.logEntries(terminalModel.entries()); });
+    // cap / pcapng 格式: 原始 chunk(RX 帶 framing index = 到達前已切出的行數)
+    QObject::connect(&serialManager, &SerialPortManager::rawDataReceived, &fileLogger,
+                     [&](const QByteArray &data) {
+                         fileLogger.logChunk(data, CaptureFormat::Rx, serialManager.rxLineCount());
+                     });
+    QObject::connect(&serialManager, &SerialPortManager::rawDataSent, &fileLogger,
+                     [&](const QByteArray &data) { fileLogger.logChunk(data, CaptureFormat::Tx); });
+    // 數值序列同樣吃 flush 批次(plot 面板開著才抽取)
+    QObject::connect(&terminalModel, &TerminalModel::entriesFlushed,
+                     &signalExtractor, &SignalExtractor::processBatch);
 
     QString configPath = parser.isSet(QStringLiteral("config"))
         ? parser.value(QStringLiteral("config"))
         : configManager.defaultConfigPath();
     configManager.loadFromFile(configPath);
+    startupTrace.mark(QStringLiteral("config_load"));
 
     QString cmdLinePort   = parser.value(QStringLiteral("port"));
     int     cmdLineBaud   = parser.isSet(QStringLiteral("baud"))
@@ -251,10 +452,15 @@ int main(int argc, char *argv[])
                                 ? parser.value(QStringLiteral("format")) : QStringLiteral("text");
 
     QQmlApplicationEngine engine;
+    engine.addImageProvider(QStringLiteral("fx"), new FxImageProvider);   // engine 接手擁有權
     engine.rootContext()->setContextProperty(QStringLiteral("serialManager"), &serialManager);
     engine.rootContext()->setContextProperty(QStringLiteral("fileLogger"), &fileLogger);
     engine.rootContext()->setContextProperty(QStringLiteral("configManager"), &configManager);
     engine.rootContext()->setContextProperty(QStringLiteral("terminalModel"), &terminalModel);
+    engine.rootContext()->setContextProperty(QStringLiteral("terminalExporter"), &terminalExporter);
+    engine.rootContext()->setContextProperty(QStringLiteral("mappedLog"), &mappedLog);
+    engine.rootContext()->setContextProperty(QStringLiteral("hexDumpModel"), &hexDumpModel);
+    engine.rootContext()->setContextProperty(QStringLiteral("signalExtractor"), &signalExtractor);
     engine.rootContext()->setContextProperty(QStringLiteral("appVersion"), QStringLiteral(APP_VERSION_STR));
     engine.rootContext()->setContextProperty(QStringLiteral("appName"), QStringLiteral(APP_NAME));
     engine.rootContext()->setContextProperty(QStringLiteral("cmdLinePort"),   cmdLinePort);
@@ -262,6 +468,9 @@ int main(int argc, char *argv[])
     engine.rootContext()->setContextProperty(QStringLiteral("cmdLineRecord"), cmdLineRecord);
     engine.rootContext()->setContextProperty(QStringLiteral("cmdLineFormat"), cmdLineFormat);
 
+    engine.rootContext()->setContextProperty(QStringLiteral("startupTrace"), &startupTrace);
+    startupTrace.mark(QStringLiteral("engine_init"));
+
     const QUrl url(QStringLiteral("qrc:/qt/qml/UARTPro/main.qml"));
     QObject::connect(&engine, &QQmlApplicationEngine::objectCreated, &app,
         [url](QObject *obj, const QUrl &objUrl) {
@@ -269,6 +478,16 @@ int main(int argc, char *argv[])
                 QCoreApplication::exit(-1);
         }, Qt::QueuedConnection);
     engine.load(url);
+    // qml_create / ui_config 由 main.qml 的 Component.onCompleted 標記,這裡是其後的收尾
+    startupTrace.mark(QStringLiteral("qml_finalize"));
+
+    // 新列跟著視窗 frame 提交(每 frame 最多一次 insert + 一次 autoscroll)
+    if (!engine.rootObjects().isEmpty()) {
+        if (auto *window = qobject_cast<QQuickWindow *>(engine.rootObjects().first())) {
+            terminalModel.attachWindow(window);
+            startupTrace.attachWindow(window);
+        }
+    }
 
 #ifdef Q_OS_WIN
     std::unique_ptr<WindowsFramelessEventFilter> framelessEventFilter;
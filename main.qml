@@ -139,13 +139,16 @@ Window {
         colorAccentTertiary = t.accentTertiary
         colorBorder = t.border
         colorDestructive = t.destructive
-        bgGridCanvas.requestPaint()
-        scanlineCanvas.requestPaint()
         keywordRevision++
     }
 
     // ── App State ──────────────────────────────────────────────────
     property bool hexDisplayMode: false
+    property bool hexDumpVisible: false   // 原始 byte stream 的 hex dump 面板(取代終端機輸出區)
+    property bool plotVisible: false      // 數值序列 plot 面板(終端機上方)
+    property bool minimapVisible: true    // 整個 buffer 的 minimap 條(終端機右側)
+    property string plotPattern: ""       // 空 = key=value;否則 regex(具名 group = 序列)
+    readonly property var plotWindowOptions: [1000, 10000, 50000, 100000]
     property bool autoScroll: true
     property bool showTimestamp: true
     property bool showPrefix: true
@@ -156,6 +159,9 @@ Window {
     property bool colorNumbers: true
     property int maxBufferLines: 50000
     readonly property var bufferSizeOptions: [10000, 50000, 100000, 500000]
+    property int floodThreshold: 5000
+    readonly property var floodThresholdOptions: [0, 2000, 5000, 10000, 20000]
+    readonly property var floodThresholdLabels: ["OFF", "2K LINES/S", "5K LINES/S", "10K LINES/S", "20K LINES/S"]
     property string lastClickedRowText: ""
     property bool leftPanelCollapsed: false
     property bool leftPanelAutoCollapsed: false
@@ -181,29 +187,55 @@ Window {
     }
     onShowTimestampChanged: if (configManager) configManager.showTimestamp = showTimestamp
     onShowLineNumbersChanged: if (configManager) configManager.showLineNumbers = showLineNumbers
-    onColorNumbersChanged: { keywordRevision++; if (configManager) configManager.colorNumbers = colorNumbers }
+    onColorNumbersChanged: {
+        terminalModel.colorNumbers = colorNumbers
+        mappedLog.colorNumbers = colorNumbers
+        if (configManager) configManager.colorNumbers = colorNumbers
+    }
     onMaxBufferLinesChanged: {
         if (configManager) configManager.maxBufferLines = maxBufferLines
         terminalModel.maxLines = maxBufferLines
     }
+    onPlotPatternChanged: {
+        if (configManager) configManager.plotPattern = plotPattern
+        signalExtractor.pattern = plotPattern
+    }
+    onFloodThresholdChanged: {
+        if (configManager) configManager.floodThreshold = floodThreshold
+        terminalModel.floodThreshold = floodThreshold
+    }
+
+    // flood mode 只在跟尾時改顯示取樣;使用者往回捲 / 搜尋即回到完整 model
+    Binding { target: terminalModel; property: "followTail"; value: root.autoScroll }
+    // plot 面板關閉時不抽取數值
+    Binding { target: signalExtractor; property: "enabled"; value: root.plotVisible }
+    // text log 的行版面跟著顯示偏好(寫檔本身在 C++: terminalModel → fileLogger 直連)
+    Binding { target: fileLogger; property: "textTimestamp"; value: root.showTimestamp }
+    Binding { target: fileLogger; property: "textPrefix"; value: root.showPrefix }
+    Binding { target: fileLogger; property: "textHex"; value: root.hexDisplayMode }
+    // 輪替 / 壓縮 / 磁碟預算只在設定檔(uartpro_config.json 的 log* 欄位),下次開始記錄生效
+    Binding { target: fileLogger; property: "rotateBytes"; value: configManager.logRotateMB * 1048576 }
+    Binding { target: fileLogger; property: "rotateIntervalSec"; value: configManager.logRotateMinutes * 60 }
+    Binding { target: fileLogger; property: "compress"; value: configManager.logCompress }
+    Binding { target: fileLogger; property: "diskBudgetBytes"; value: configManager.logDiskBudgetMB * 1048576 }
+    // 耐久等級同樣只在設定檔(logDurability / logGroupCommitMs / logGroupCommitKB)
+    Binding { target: fileLogger; property: "durability"; value: configManager.logDurability }
+    Binding { target: fileLogger; property: "groupCommitMs"; value: configManager.logGroupCommitMs }
+    Binding { target: fileLogger; property: "groupCommitBytes"; value: configManager.logGroupCommitKB * 1024 }
+    // hex dump 環狀暫存檔上限(設定檔 hexDumpSpoolMB)
+    Binding { target: hexDumpModel; property: "spoolLimitBytes"; value: configManager.hexDumpSpoolMB * 1048576 }
+    // pcapng 的 interface 名稱 = 目前選的 port
+    Binding { target: fileLogger; property: "interfaceName"; value: portCombo.currentText.split(" - ")[0] }
 
     // ── Terminal & Keyword State ─────────────────────────────────
     // 資料本體在 C++ terminalModel(context property),QML 只留選取/檢視狀態
-    property var selectedSet: ({})
-    property int selectionVersion: 0
+    // 整列選取在 terminalModel.selection(C++ 區間集合,依 entryIndex)
+    // 開啟 log 檔時檢視切到 mappedLog(唯讀、同一組 API),即時資料照常進 terminalModel
+    readonly property var viewModel: mappedLog.active ? mappedLog : terminalModel
+    readonly property bool viewSampling: !mappedLog.active && terminalModel.sampling
     property int lastClickedRow: -1
-    property int activeEditRow: -1      // entryIndex of the row in text-select mode
-    property int _selStart: -1          // character selection start position
-
-    // ── Cross-line drag selection ────────────────────────────────
+    // 字元層級選取由 terminalView(TerminalRenderer)持有,這裡只記拖曳中
     property bool _dragSelecting: false
-    property int _dragStartModelRow: -1   // model index (ListView row) where drag began
-    property int _dragStartCharPos: -1    // character offset within that row
-    property int _dragEndModelRow: -1     // model index where drag currently is
-    property int _dragEndCharPos: -1      // character offset within end row
-    property int _dragSelVersion: 0       // bump to trigger delegate re-eval
-    property real _dragPressMouseX: 0     // raw mouse X at press time (for deferred _selStart)
-    property real _dragPressMouseY: 0     // raw mouse Y at press time
     property int keywordRevision: 0
     property int filterRevision: 0
     property int kwColorIndex: 0
@@ -221,6 +253,7 @@ Window {
     property var searchMatches: []
     property bool autoScrollBeforeSearch: true
     property bool helpPopupVisible: false
+    onHelpPopupVisibleChanged: if (helpPopupVisible) helpPopupLoader.active = true
 
     // ── Baud / DataBits / StopBits / Parity models ────────────────
     readonly property var baudRates:  [9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600]
@@ -230,20 +263,14 @@ Window {
     readonly property var lineEndings:  ["None", "CR", "LF", "CR+LF"]
 
     // ── Data Models ────────────────────────────────────────────────
-    ListModel { id: keywordModel;  onCountChanged: { root.keywordRevision++; syncKeywordsToConfig() } }
-    ListModel { id: filterModel;   onCountChanged: { root.filterRevision++; scheduleFilterSync() } }
+    // loadConfigToUI 期間不逐筆同步,載入完成後統一套用一次
+    property bool loadingConfig: false
+    ListModel { id: keywordModel;  onCountChanged: { root.keywordRevision++; if (!root.loadingConfig) syncKeywordsToConfig() } }
+    ListModel { id: filterModel;   onCountChanged: { root.filterRevision++; if (!root.loadingConfig) scheduleFilterSync() } }
 
     // Hidden TextEdit for clipboard access
     TextEdit { id: clipHelper; visible: false }
 
-    // Monospace char width for precise char-level position calculation
-    TextMetrics {
-        id: monoCharMetrics
-        font.family: root.fontMono
-        font.pixelSize: root.terminalFontSize
-        text: "M"
-    }
-
     // ── Config drag-and-drop + reload ─────────────────────────────
     Connections {
         target: configManager
@@ -355,6 +382,7 @@ Window {
             if (root.searchBarVisible) {
                 root.searchBarVisible = false
                 root.searchQuery = ""
+                root.viewModel.setSearchHighlight("", false)
                 root.searchMatches = []
                 root.searchCurrentIndex = -1
                 root.autoScroll = root.autoScrollBeforeSearch
@@ -431,6 +459,11 @@ Window {
         context: Qt.ApplicationShortcut
         onActivated: toggleLogging()
     }
+    Shortcut {
+        sequence: "Ctrl+O"
+        context: Qt.ApplicationShortcut
+        onActivated: toggleLogView()
+    }
 
     // ── Scaled Content Wrapper ──────────────────────────────────
     // All visual content is inside this scaled Item.
@@ -445,31 +478,14 @@ Window {
     // ══════════════════════════════════════════════════════════════
     // BACKGROUND — circuit grid pattern
     // ══════════════════════════════════════════════════════════════
-    Canvas {
-        id: bgGridCanvas
+    Image {
+        id: bgGrid
         anchors.fill: parent
         z: 0
-        onPaint: {
-            var ctx = getContext("2d")
-            ctx.clearRect(0, 0, width, height)
-            var c = root.colorAccent
-            ctx.strokeStyle = Qt.rgba(c.r, c.g, c.b, 0.025)
-            ctx.lineWidth = 1
-            var gs = 50
-            for (var x = 0; x <= width; x += gs) {
-                ctx.beginPath(); ctx.moveTo(x, 0); ctx.lineTo(x, height); ctx.stroke()
-            }
-            for (var y = 0; y <= height; y += gs) {
-                ctx.beginPath(); ctx.moveTo(0, y); ctx.lineTo(width, y); ctx.stroke()
-            }
-        }
-        Component.onCompleted: requestPaint()
-        Connections {
-            target: root
-            function onWidthChanged()  { bgGridCanvas.requestPaint() }
-            function onHeightChanged() { bgGridCanvas.requestPaint() }
-            function onUiScaleChanged() { bgGridCanvas.requestPaint() }
-        }
+        // 50px 格線 tile 由 FxImageProvider 產生,GPU 平鋪(resize 不重畫)
+        source: "image://fx/grid/50/" + root.fxColorHex(root.colorAccent, 0.025)
+        fillMode: Image.Tile
+        smooth: false
     }
 
     // Corner accent decorations (HUD style)
@@ -509,7 +525,7 @@ Window {
         }
         MenuItem {
             text: "  Copy        (Ctrl+C)"
-            enabled: { root.selectionVersion; return Object.keys(root.selectedSet).length > 0 }
+            enabled: root.viewModel.selection.count > 0
             onTriggered: copySelectedOrInlineText()
             contentItem: Text {
                 text: parent.text
@@ -536,7 +552,7 @@ Window {
         }
         MenuItem {
             text: "  Copy All"
-            enabled: terminalModel.count > 0
+            enabled: root.viewModel.count > 0
             onTriggered: copyAllEntries()
             contentItem: Text {
                 text: parent.text
@@ -548,6 +564,48 @@ Window {
                 color: parent.hovered ? root.colorMuted : "transparent"
             }
         }
+        MenuItem {
+            text: "  Export Selection..."
+            enabled: root.viewModel.selection.count > 0 && !terminalExporter.running
+            onTriggered: root.openExportDialog("selection")
+            contentItem: Text {
+                text: parent.text
+                font.family: root.fontMono; font.pixelSize: 11
+                font.letterSpacing: 1
+                color: parent.enabled ? root.colorFg : root.colorMutedFg
+            }
+            background: Rectangle {
+                color: parent.hovered ? root.colorMuted : "transparent"
+            }
+        }
+        MenuItem {
+            text: "  Export View..."
+            enabled: root.viewModel.count > 0 && !terminalExporter.running
+            onTriggered: root.openExportDialog("visible")
+            contentItem: Text {
+                text: parent.text
+                font.family: root.fontMono; font.pixelSize: 11
+                font.letterSpacing: 1
+                color: parent.enabled ? root.colorFg : root.colorMutedFg
+            }
+            background: Rectangle {
+                color: parent.hovered ? root.colorMuted : "transparent"
+            }
+        }
+        MenuItem {
+            text: "  Export Buffer..."
+            enabled: root.viewModel.totalCount > 0 && !terminalExporter.running
+            onTriggered: root.openExportDialog("all")
+            contentItem: Text {
+                text: parent.text
+                font.family: root.fontMono; font.pixelSize: 11
+                font.letterSpacing: 1
+                color: parent.enabled ? root.colorFg : root.colorMutedFg
+            }
+            background: Rectangle {
+                color: parent.hovered ? root.colorMuted : "transparent"
+            }
+        }
         MenuItem {
             text: "  Clean       (Ctrl+L)"
             onTriggered: clearTerminal()
@@ -564,52 +622,60 @@ Window {
     }
 
     // ── Color Picker Popup (for keyword chip color swatch) ──────
-    Popup {
-        id: colorPickerPopup
-        width: 200; height: 80
-        modal: false
-        closePolicy: Popup.CloseOnEscape | Popup.CloseOnPressOutside
-
-        property int targetIndex: -1
-
-        background: Rectangle {
-            color: root.colorCard
-            border.color: root.colorBorder
-            border.width: 1
-            radius: 4
-        }
+    // 對話框 / popup 都延後到第一次開啟才建立(ensureLoaded),不佔冷啟動時間
+    Loader {
+        id: colorPickerLoader
+        active: false
+        sourceComponent: Component {
+            Popup {
+                id: colorPickerPopup
+                parent: root.contentItem
+                width: 200; height: 80
+                modal: false
+                closePolicy: Popup.CloseOnEscape | Popup.CloseOnPressOutside
+
+                property int targetIndex: -1
+
+                background: Rectangle {
+                    color: root.colorCard
+                    border.color: root.colorBorder
+                    border.width: 1
+                    radius: 4
+                }
 
-        Grid {
-            anchors.centerIn: parent
-            columns: 4
-            spacing: 8
+                Grid {
+                    anchors.centerIn: parent
+                    columns: 4
+                    spacing: 8
 
-            Repeater {
-                model: root.kwPalette
-                delegate: Rectangle {
-                    width: 28; height: 28
-                    radius: 4
-                    color: modelData
-                    border.color: {
-                        if (colorPickerPopup.targetIndex >= 0
-                            && colorPickerPopup.targetIndex < keywordModel.count
-                            && keywordModel.get(colorPickerPopup.targetIndex).color === modelData)
-                            return root.colorFg
-                        return "transparent"
-                    }
-                    border.width: 2
+                    Repeater {
+                        model: root.kwPalette
+                        delegate: Rectangle {
+                            width: 28; height: 28
+                            radius: 4
+                            color: modelData
+                            border.color: {
+                                if (colorPickerPopup.targetIndex >= 0
+                                    && colorPickerPopup.targetIndex < keywordModel.count
+                                    && keywordModel.get(colorPickerPopup.targetIndex).color === modelData)
+                                    return root.colorFg
+                                return "transparent"
+                            }
+                            border.width: 2
 
-                    MouseArea {
-                        anchors.fill: parent
-                        cursorShape: Qt.PointingHandCursor
-                        onClicked: {
-                            if (colorPickerPopup.targetIndex >= 0
-                                && colorPickerPopup.targetIndex < keywordModel.count) {
-                                keywordModel.setProperty(colorPickerPopup.targetIndex, "color", modelData)
-                                root.keywordRevision++
-                                syncKeywordsToConfig()
+                            MouseArea {
+                                anchors.fill: parent
+                                cursorShape: Qt.PointingHandCursor
+                                onClicked: {
+                                    if (colorPickerPopup.targetIndex >= 0
+                                        && colorPickerPopup.targetIndex < keywordModel.count) {
+                                        keywordModel.setProperty(colorPickerPopup.targetIndex, "color", modelData)
+                                        root.keywordRevision++
+                                        syncKeywordsToConfig()
+                                    }
+                                    colorPickerPopup.close()
+                                }
                             }
-                            colorPickerPopup.close()
                         }
                     }
                 }
@@ -1241,10 +1307,12 @@ Window {
                             CyberComboBox {
                                 id: filterSubTypeCombo
                                 Layout.preferredWidth: 92
-                                model: ["Has", "Ban"]
+                                model: ["Has", "Ban", "Query"]
                                 currentIndex: 0
                                 visible: filterTypeCombo.currentIndex === 1
-                                accentColor: filterSubTypeCombo.currentIndex === 0 ? root.colorAccent : root.colorDestructive
+                                accentColor: filterSubTypeCombo.currentIndex === 0 ? root.colorAccent
+                                           : filterSubTypeCombo.currentIndex === 1 ? root.colorDestructive
+                                           : root.colorAccentTertiary
                                 cardColor: root.colorCard; borderColor: root.colorBorder
                                 fgColor: root.colorFg; bgColor: root.colorBg
                                 mutedFgColor: root.colorMutedFg; mutedColor: root.colorMuted
@@ -1261,10 +1329,12 @@ Window {
                                 Layout.fillWidth: true
                                 placeholderText: filterTypeCombo.currentIndex === 0 ? "highlight keyword..."
                                                : filterSubTypeCombo.currentIndex === 0 ? "has filter..."
-                                               : "ban filter..."
+                                               : filterSubTypeCombo.currentIndex === 1 ? "ban filter..."
+                                               : "type:rx /re/ len>8 hex:AA55..."
                                 accentColor: filterTypeCombo.currentIndex === 0 ? "#ffaa00"
                                            : filterSubTypeCombo.currentIndex === 0 ? root.colorAccent
-                                           : root.colorDestructive
+                                           : filterSubTypeCombo.currentIndex === 1 ? root.colorDestructive
+                                           : root.colorAccentTertiary
                                 cardColor: root.colorCard; borderColor: root.colorBorder
                                 bgColor: root.colorBg; mutedFgColor: root.colorMutedFg
                                 font.pixelSize: 11
@@ -1278,7 +1348,8 @@ Window {
                                 text: "+"
                                 accentColor: filterTypeCombo.currentIndex === 0 ? "#ffaa00"
                                            : filterSubTypeCombo.currentIndex === 0 ? root.colorAccent
-                                           : root.colorDestructive
+                                           : filterSubTypeCombo.currentIndex === 1 ? root.colorDestructive
+                                           : root.colorAccentTertiary
                                 bgColor: root.colorBg; borderMutedColor: root.colorBorder
                                 font.pixelSize: 14
                                 onClicked: addFilterFromInput()
@@ -1364,11 +1435,12 @@ Window {
                                                         ToolTip.delay: 600
                                                         ToolTip.text: "Change color"
                                                         onClicked: {
-                                                            colorPickerPopup.targetIndex = index
+                                                            var picker = root.ensureLoaded(colorPickerLoader)
+                                                            picker.targetIndex = index
                                                             var pos = parent.mapToItem(root.contentItem, 0, 0)
-                                                            colorPickerPopup.x = pos.x
-                                                            colorPickerPopup.y = pos.y + 20
-                                                            colorPickerPopup.open()
+                                                            picker.x = pos.x
+                                                            picker.y = pos.y + 20
+                                                            picker.open()
                                                         }
                                                     }
                                                 }
@@ -1478,7 +1550,7 @@ Window {
                                             root.filterRevision
                                             var count = 0, enabledCount = 0
                                             for (var i = 0; i < filterModel.count; i++) {
-                                                if (filterModel.get(i).filterType === "include") {
+                                                if (filterModel.get(i).filterType !== "exclude") {
                                                     count++
                                                     if (filterModel.get(i).enabled) enabledCount++
                                                 }
@@ -1496,7 +1568,7 @@ Window {
                                             onClicked: {
                                                 var allOn = parent.allEnabled
                                                 for (var i = 0; i < filterModel.count; i++) {
-                                                    if (filterModel.get(i).filterType === "include")
+                                                    if (filterModel.get(i).filterType !== "exclude")
                                                         filterModel.setProperty(i, "enabled", !allOn)
                                                 }
                                                 root.filterRevision++
@@ -1514,8 +1586,10 @@ Window {
                                     Repeater {
                                         model: filterModel
                                         delegate: Rectangle {
-                                            visible: model.filterType === "include"
-                                            property color chipColor: root.colorAccent
+                                            // query chip 與 include 同列(皆為「要顯示」的條件)
+                                            visible: model.filterType !== "exclude"
+                                            property color chipColor: model.filterType === "query"
+                                                                      ? root.colorAccentTertiary : root.colorAccent
 
                                             width: includeFlow.width
                                             height: 26
@@ -1542,7 +1616,8 @@ Window {
                                                 }
                                                 onDoubleClicked: {
                                                     filterTypeCombo.currentIndex = 1
-                                                    filterSubTypeCombo.currentIndex = (model.filterType === "include") ? 0 : 1
+                                                    filterSubTypeCombo.currentIndex = (model.filterType === "include") ? 0
+                                                                                    : (model.filterType === "query") ? 2 : 1
                                                     filterInput.text = model.text
                                                     filterModel.remove(index)
                                                     filterInput.forceActiveFocus()
@@ -1560,7 +1635,7 @@ Window {
                                                     anchors.right: includeIconRow.left
                                                     anchors.rightMargin: 6
                                                     anchors.verticalCenter: parent.verticalCenter
-                                                    text: "+ " + model.text
+                                                    text: (model.filterType === "query" ? "? " : "+ ") + model.text
                                                     elide: Text.ElideRight
                                                     font.family: root.fontMono; font.pixelSize: 11
                                                     color: chipColor
@@ -1704,7 +1779,8 @@ Window {
                                                 }
                                                 onDoubleClicked: {
                                                     filterTypeCombo.currentIndex = 1
-                                                    filterSubTypeCombo.currentIndex = (model.filterType === "include") ? 0 : 1
+                                                    filterSubTypeCombo.currentIndex = (model.filterType === "include") ? 0
+                                                                                    : (model.filterType === "query") ? 2 : 1
                                                     filterInput.text = model.text
                                                     filterModel.remove(index)
                                                     filterInput.forceActiveFocus()
@@ -1857,6 +1933,24 @@ Window {
                             onCurrentIndexChanged: root.maxBufferLines = root.bufferSizeOptions[currentIndex]
                         }
 
+                        // Flood mode threshold
+                        Text {
+                            text: "FLOOD MODE ABOVE"
+                            font.family: root.fontMono; font.pixelSize: 10
+                            font.letterSpacing: 2; color: root.colorMutedFg
+                        }
+                        CyberComboBox {
+                            id: floodThresholdCombo
+                            Layout.fillWidth: true
+                            model: root.floodThresholdLabels
+                            currentIndex: 2
+                            accentColor: root.colorAccentTertiary
+                            cardColor: root.colorCard; borderColor: root.colorBorder
+                            fgColor: root.colorFg; bgColor: root.colorBg
+                            mutedFgColor: root.colorMutedFg; mutedColor: root.colorMuted
+                            onCurrentIndexChanged: root.floodThreshold = root.floodThresholdOptions[currentIndex]
+                        }
+
                         Item { height: 8 }
 
                         Rectangle { Layout.fillWidth: true; height: 1; color: root.colorBorder }
@@ -1887,6 +1981,14 @@ Window {
                             onClicked: toggleLogging()
                         }
 
+                        CyberButton {
+                            Layout.fillWidth: true
+                            text: mappedLog.active ? "CLOSE LOG VIEW" : "OPEN LOG FILE"
+                            accentColor: mappedLog.active ? root.colorDestructive : root.colorAccentTertiary
+                            bgColor: root.colorBg; borderMutedColor: root.colorBorder
+                            onClicked: toggleLogView()
+                        }
+
                         // 目前 LOG 檔名顯示(僅在記錄中顯示)
                         ColumnLayout {
                             Layout.fillWidth: true
@@ -2033,8 +2135,8 @@ Window {
                             }
 
                             Text {
-                                visible: { root.selectionVersion; return Object.keys(root.selectedSet).length > 0 }
-                                text: { root.selectionVersion; return "[SEL " + Object.keys(root.selectedSet).length + "]" }
+                                visible: root.viewModel.selection.count > 0
+                                text: "[SEL " + root.viewModel.selection.count + "]"
                                 font.family: root.fontMono
                                 font.pixelSize: 10
                                 font.letterSpacing: 1
@@ -2042,6 +2144,57 @@ Window {
                                 color: root.colorAccent
                             }
 
+                            Text {
+                                text: "[MAP]"
+                                font.family: root.fontMono
+                                font.pixelSize: 10
+                                font.letterSpacing: 1
+                                font.bold: true
+                                color: root.minimapVisible ? root.colorAccent : root.colorMutedFg
+                                opacity: root.minimapVisible || mapToggleArea.containsMouse ? 1.0 : 0.6
+                                MouseArea {
+                                    id: mapToggleArea
+                                    anchors.fill: parent
+                                    cursorShape: Qt.PointingHandCursor
+                                    hoverEnabled: true
+                                    onClicked: root.minimapVisible = !root.minimapVisible
+                                }
+                            }
+
+                            Text {
+                                text: "[PLOT]"
+                                font.family: root.fontMono
+                                font.pixelSize: 10
+                                font.letterSpacing: 1
+                                font.bold: true
+                                color: root.plotVisible ? root.colorAccent : root.colorMutedFg
+                                opacity: root.plotVisible || plotToggleArea.containsMouse ? 1.0 : 0.6
+                                MouseArea {
+                                    id: plotToggleArea
+                                    anchors.fill: parent
+                                    cursorShape: Qt.PointingHandCursor
+                                    hoverEnabled: true
+                                    onClicked: root.plotVisible = !root.plotVisible
+                                }
+                            }
+
+                            Text {
+                                text: "[DUMP]"
+                                font.family: root.fontMono
+                                font.pixelSize: 10
+                                font.letterSpacing: 1
+                                font.bold: true
+                                color: root.hexDumpVisible ? root.colorAccent : root.colorMutedFg
+                                opacity: root.hexDumpVisible || dumpToggleArea.containsMouse ? 1.0 : 0.6
+                                MouseArea {
+                                    id: dumpToggleArea
+                                    anchors.fill: parent
+                                    cursorShape: Qt.PointingHandCursor
+                                    hoverEnabled: true
+                                    onClicked: root.hexDumpVisible = !root.hexDumpVisible
+                                }
+                            }
+
                             Text {
                                 text: root.hexDisplayMode ? "[HEX]" : "[ASCII]"
                                 font.family: root.fontMono
@@ -2072,7 +2225,7 @@ Window {
                             }
 
                             Text {
-                                visible: terminalModel.filterActive
+                                visible: root.viewModel.filterActive
                                 text: "[FILTERED]"
                                 font.family: root.fontMono
                                 font.pixelSize: 10
@@ -2083,13 +2236,13 @@ Window {
 
                             Text {
                                 // filter 生效時顯示 shown/total,避免誤以為沒收到資料
-                                text: terminalModel.filterActive
-                                      ? (terminalModel.count + "/" + terminalModel.totalCount + " ENTRIES")
-                                      : (terminalModel.count + " ENTRIES")
+                                text: root.viewModel.filterActive
+                                      ? (root.viewModel.count + "/" + root.viewModel.totalCount + " ENTRIES")
+                                      : (root.viewModel.count + " ENTRIES")
                                 font.family: root.fontMono
                                 font.pixelSize: 10
                                 font.letterSpacing: 1
-                                color: terminalModel.filterActive ? "#ffaa00" : root.colorMutedFg
+                                color: root.viewModel.filterActive ? "#ffaa00" : root.colorMutedFg
                             }
 
                             BroomIcon {
@@ -2258,7 +2411,8 @@ Window {
 
                             // Match count
                             Text {
-                                text: root.searchMatches.length > 0
+                                text: mappedLog.searching ? "..."
+                                    : root.searchMatches.length > 0
                                     ? ((root.searchCurrentIndex + 1) + "/" + root.searchMatches.length)
                                     : (root.searchQuery !== "" ? "0/0" : "")
                                 font.family: root.fontMono
@@ -2295,6 +2449,7 @@ Window {
                                     onClicked: {
                                         root.searchBarVisible = false
                                         root.searchQuery = ""
+                                        root.viewModel.setSearchHighlight("", false)
                                         searchInput.text = ""
                                         root.searchMatches = []
                                         root.searchCurrentIndex = -1
@@ -2314,31 +2469,193 @@ Window {
 
                     Rectangle { Layout.fillWidth: true; height: root.searchBarVisible ? 1 : 0; color: root.colorBorder }
 
+                    // ── Plot(SignalExtractor 序列,min/max-per-pixel 抽樣在 C++ PlotItem)
+                    Rectangle {
+                        Layout.fillWidth: true
+                        Layout.preferredHeight: 200
+                        visible: root.plotVisible
+                        color: root.colorCard
+
+                        // 第一次顯示才建立(legend / PlotItem / 輸入列),之後保留
+                        onVisibleChanged: if (visible) plotLoader.active = true
+
+                        Loader {
+                            id: plotLoader
+                            anchors.fill: parent
+                            anchors.margins: 8
+                            active: false
+                            sourceComponent: Component {
+                                ColumnLayout {
+                                    spacing: 6
+
+                                    RowLayout {
+                                        Layout.fillWidth: true
+                                        spacing: 8
+
+                                        CyberTextField {
+                                            id: plotPatternInput
+                                            Layout.preferredWidth: 280
+                                            Layout.preferredHeight: 28
+                                            font.pixelSize: 11
+                                            placeholderText: "key=value  (or regex with (?<name>...) groups)"
+                                            text: root.plotPattern
+                                            accentColor: signalExtractor.patternError !== "" ? root.colorDestructive : root.colorAccent
+                                            cardColor: root.colorBg; borderColor: root.colorBorder
+                                            bgColor: root.colorBg; mutedFgColor: root.colorMutedFg
+                                            onEditingFinished: root.plotPattern = text
+                                        }
+
+                                        CyberComboBox {
+                                            id: plotWindowCombo
+                                            Layout.preferredWidth: 130
+                                            Layout.preferredHeight: 28
+                                            model: ["1K SAMPLES", "10K SAMPLES", "50K SAMPLES", "100K SAMPLES"]
+                                            currentIndex: 1
+                                            accentColor: root.colorAccent
+                                            cardColor: root.colorBg; borderColor: root.colorBorder
+                                            bgColor: root.colorBg; fgColor: root.colorFg; mutedFgColor: root.colorMutedFg
+                                        }
+
+                                        // legend: 序列名稱 + 最新值(250ms 更新,不隨每批重綁)
+                                        Repeater {
+                                            model: signalExtractor.seriesNames
+                                            Text {
+                                                required property string modelData
+                                                required property int index
+                                                property real lastValue: NaN
+                                                text: modelData + " " + (isNaN(lastValue) ? "--" : lastValue.toPrecision(6))
+                                                font.family: root.fontMono
+                                                font.pixelSize: 10
+                                                color: plotItem.colors[index % plotItem.colors.length]
+                                                Timer {
+                                                    interval: 250
+                                                    running: root.plotVisible
+                                                    repeat: true
+                                                    triggeredOnStart: true
+                                                    onTriggered: parent.lastValue = signalExtractor.lastValue(parent.index)
+                                                }
+                                            }
+                                        }
+
+                                        Text {
+                                            visible: signalExtractor.patternError !== ""
+                                            text: signalExtractor.patternError
+                                            font.family: root.fontMono
+                                            font.pixelSize: 10
+                                            color: root.colorDestructive
+                                            elide: Text.ElideRight
+                                            Layout.maximumWidth: 240
+                                        }
+
+                                        Item { Layout.fillWidth: true }
+
+                                        CyberButton {
+                                            text: "CLEAR"
+                                            Layout.preferredHeight: 28
+                                            accentColor: root.colorDestructive
+                                            bgColor: root.colorBg; borderMutedColor: root.colorBorder
+                                            onClicked: signalExtractor.clear()
+                                        }
+                                    }
+
+                                    Item {
+                                        Layout.fillWidth: true
+                                        Layout.fillHeight: true
+
+                                        PlotItem {
+                                            id: plotItem
+                                            anchors.fill: parent
+                                            anchors.leftMargin: 64
+                                            source: root.plotVisible ? signalExtractor : null
+                                            windowSamples: root.plotWindowOptions[plotWindowCombo.currentIndex]
+                                            colors: [root.colorAccent, root.colorAccentTertiary, root.colorAccentSecondary,
+                                                     "#ffaa00", root.colorDestructive, root.colorFg, "#8866ff", "#66ffff"]
+                                        }
+
+                                        // y 軸刻度(自動縮放範圍)
+                                        Text {
+                                            anchors.left: parent.left
+                                            anchors.top: plotItem.top
+                                            width: 60
+                                            horizontalAlignment: Text.AlignRight
+                                            text: plotItem.yMax.toPrecision(5)
+                                            font.family: root.fontMono
+                                            font.pixelSize: 9
+                                            color: root.colorMutedFg
+                                        }
+                                        Text {
+                                            anchors.left: parent.left
+                                            anchors.bottom: plotItem.bottom
+                                            width: 60
+                                            horizontalAlignment: Text.AlignRight
+                                            text: plotItem.yMin.toPrecision(5)
+                                            font.family: root.fontMono
+                                            font.pixelSize: 9
+                                            color: root.colorMutedFg
+                                        }
+                                        Rectangle {
+                                            anchors.fill: plotItem
+                                            color: "transparent"
+                                            border.color: root.colorBorder
+                                            border.width: 1
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+
+                    Rectangle { Layout.fillWidth: true; height: root.plotVisible ? 1 : 0; color: root.colorBorder }
+
                     // Terminal output area
                     Item {
                         Layout.fillWidth: true
                         Layout.fillHeight: true
 
-                        ListView {
+                        TerminalRenderer {
                             id: terminalView
                             anchors.fill: parent
                             anchors.leftMargin: 8
                             anchors.topMargin: 8
                             anchors.bottomMargin: 8
-                            anchors.rightMargin: 0   // scrollbar sits on the right edge
-                            model: terminalModel
-                            clip: true
-                            interactive: false   // disable mouse-drag scrolling; wheel still works via MouseArea
-                            boundsBehavior: Flickable.StopAtBounds
+                            anchors.rightMargin: minimap.width   // scrollbar overlays the right edge, minimap beyond it
+                            // flood 時顯示節流取樣;切換時兩邊都在尾端。開啟 log 檔時顯示該檔
+                            model: mappedLog.active ? mappedLog
+                                 : (terminalModel.sampling ? terminalModel.floodSample : terminalModel)
+                            onModelChanged: positionViewAtEnd()
+                            font.family: root.fontMono
+                            font.pixelSize: root.terminalFontSize
+
+                            showLineNumbers: root.showLineNumbers
+                            showTimestamp: root.showTimestamp
+                            showPrefix: root.showPrefix
+                            hexMode: root.hexDisplayMode
+                            selection: root.viewModel.selection
+
+                            textColor: root.colorFg
+                            rxColor: root.colorAccent
+                            txColor: root.colorAccentTertiary
+                            systemColor: root.colorAccentSecondary
+                            errorColor: root.colorDestructive
+                            lineNumberColor: Qt.rgba(root.colorMutedFg.r, root.colorMutedFg.g, root.colorMutedFg.b, 0.5)
+                            timestampColor: root.colorMutedFg
+                            numberColor: root.colorAccentTertiary
+                            keywordBgTextColor: root.colorBg
+                            selectionColor: Qt.rgba(root.colorAccent.r, root.colorAccent.g, root.colorAccent.b, 0.6)
+                            selectedTextColor: root.colorBg
+                            lineSelectionColor: Qt.rgba(root.colorAccent.r, root.colorAccent.g, root.colorAccent.b, 0.15)
+
+                            searchRows: root.searchBarVisible ? root.searchMatches : []
+                            currentSearchRow: root.searchCurrentIndex >= 0 && root.searchCurrentIndex < root.searchMatches.length
+                                ? root.searchMatches[root.searchCurrentIndex] : -1
 
                             // Auto-scroll rules:
                             //   1. Scroll to bottom → enable auto-scroll
                             //   2. Any upward scroll → disable auto-scroll
 
                             function isAtBottom() {
-                                if (terminalModel.count === 0) return true
-                                // Use ScrollBar position — reliable even when contentHeight is estimated
-                                return terminalScrollBar.position + terminalScrollBar.size >= 1.0 - 0.01
+                                if (count === 0) return true
+                                return contentY + height >= contentHeight - rowHeight / 2
                             }
 
                             // Re-enable auto-scroll when reaching bottom
@@ -2352,7 +2669,6 @@ Window {
                                 id: scaleRepositionTimer
                                 interval: 80
                                 onTriggered: {
-                                    terminalView.forceLayout()
                                     if (root.autoScroll)
                                         terminalView.positionViewAtEnd()
                                 }
@@ -2362,264 +2678,131 @@ Window {
                                 function onUiScaleChanged()          { scaleRepositionTimer.restart() }
                                 function onTerminalFontSizeChanged() { scaleRepositionTimer.restart() }
                             }
+                        }
 
-                            ScrollBar.vertical: ScrollBar {
-                                id: terminalScrollBar
-                                policy: ScrollBar.AsNeeded
-                                // AsNeeded 的隱藏在 Basic style 是做在「預設 contentItem」的
-                                // opacity state 上;自訂 contentItem 後必須自己依 size 隱藏
-                                visible: size < 1.0
-                                hoverEnabled: true
-                                // Stick to the right edge of the ListView
-                                anchors.right: parent ? parent.right : undefined
-                                width: 12
-
-                                // User dragging scrollbar upward disables auto-scroll
-                                property real _lastPos: 0
-                                onPositionChanged: {
-                                    if (pressed && position < _lastPos - 0.0005) {
-                                        root.autoScroll = false
-                                    }
-                                    _lastPos = position
-                                }
-                                contentItem: Rectangle {
-                                    implicitWidth: 12
-                                    color: root.colorAccent
-                                    opacity: terminalScrollBar.pressed ? 0.9
-                                           : (terminalScrollBar.hovered ? 0.7 : 0.4)
-                                    radius: 3
-                                    Behavior on opacity { NumberAnimation { duration: 120 } }
-                                }
-                                background: Rectangle {
-                                    implicitWidth: 12
-                                    color: terminalScrollBar.hovered
-                                        ? Qt.rgba(root.colorAccent.r, root.colorAccent.g, root.colorAccent.b, 0.08)
-                                        : "transparent"
-                                    Behavior on color { ColorAnimation { duration: 120 } }
-                                }
+                        ScrollBar {
+                            id: terminalHScrollBar
+                            anchors.left: terminalView.left
+                            anchors.right: terminalScrollBar.left
+                            anchors.bottom: terminalView.bottom
+                            orientation: Qt.Horizontal
+                            policy: ScrollBar.AsNeeded
+                            size: terminalView.contentWidth > 0
+                                ? Math.min(1.0, terminalView.width / terminalView.contentWidth) : 1.0
+                            position: terminalView.contentWidth > 0
+                                ? terminalView.contentX / terminalView.contentWidth : 0
+                            visible: size < 1.0
+                            hoverEnabled: true
+                            height: 8
+                            z: 3
+                            onMoved: terminalView.contentX = position * terminalView.contentWidth
+                            contentItem: Rectangle {
+                                implicitHeight: 8
+                                color: root.colorAccent
+                                opacity: terminalHScrollBar.pressed ? 0.9
+                                       : (terminalHScrollBar.hovered ? 0.7 : 0.4)
+                                radius: 3
+                                Behavior on opacity { NumberAnimation { duration: 120 } }
                             }
+                            background: Rectangle {
+                                implicitHeight: 8
+                                color: "transparent"
+                            }
+                        }
 
-                            delegate: Item {
-                                id: entryDelegate
-                                width: terminalView.width
-                                height: dataRow.height + 4
-
-                                required property int index
-                                required property var timestamp
-                                required property var msgText
-                                required property var hexData
-                                required property var type
-                                required property var entryIndex
-
-                                property color resolvedColor: {
-                                    switch (String(type)) {
-                                    case "rx":     return root.colorAccent
-                                    case "tx":     return root.colorAccentTertiary
-                                    case "system": return root.colorAccentSecondary
-                                    case "error":  return root.colorDestructive
-                                    default:       return root.colorFg
-                                    }
-                                }
-
-                                property bool isSelected: {
-                                    root.selectionVersion
-                                    return root.selectedSet.hasOwnProperty(entryIndex)
-                                }
-
-                                property int searchMatchType: {
-                                    // 0 = no match, 1 = other match, 2 = current match
-                                    if (!root.searchBarVisible || root.searchMatches.length === 0)
-                                        return 0
-                                    var idx = entryDelegate.index
-                                    if (root.searchCurrentIndex >= 0 && root.searchMatches[root.searchCurrentIndex] === idx)
-                                        return 2
-                                    for (var i = 0; i < root.searchMatches.length; i++) {
-                                        if (root.searchMatches[i] === idx) return 1
-                                    }
-                                    return 0
-                                }
-
-                                // Selection highlight background
-                                Rectangle {
-                                    anchors.fill: parent
-                                    color: entryDelegate.isSelected
-                                        ? Qt.rgba(root.colorAccent.r, root.colorAccent.g, root.colorAccent.b, 0.15)
-                                        : "transparent"
-                                }
-
-                                // Line-mode keyword highlight background
-                                Rectangle {
-                                    anchors.fill: parent
-                                    color: {
-                                        root.keywordRevision  // trigger re-evaluation on keyword changes
-                                        var textData = (root.hexDisplayMode && entryDelegate.hexData !== "")
-                                            ? String(entryDelegate.hexData) : String(entryDelegate.msgText)
-                                        var lineColor = getLineHighlightColor(textData)
-                                        if (lineColor === "") return "transparent"
-                                        var qc = Qt.color(lineColor)
-                                        return Qt.rgba(qc.r, qc.g, qc.b, 0.18)
-                                    }
-                                }
-
-                                // Search match highlight background
-                                Rectangle {
-                                    anchors.fill: parent
-                                    color: entryDelegate.searchMatchType === 2
-                                        ? Qt.rgba(1, 0.667, 0, 0.35)   // current match: rgba(255,170,0,0.35)
-                                        : entryDelegate.searchMatchType === 1
-                                            ? Qt.rgba(1, 0.667, 0, 0.12)  // other matches: rgba(255,170,0,0.12)
-                                            : "transparent"
-                                }
-
-                                Row {
-                                    id: dataRow
-                                    x: 4
-                                    y: 2
-                                    width: entryDelegate.width - 8
-                                    spacing: 6
-
-                                    // Line Number
-                                    Text {
-                                        visible: root.showLineNumbers
-                                        text: String(entryDelegate.entryIndex + 1).padStart(4, ' ')
-                                        font.family: root.fontMono
-                                        font.pixelSize: root.terminalFontSize
-                                        color: root.colorMutedFg
-                                        opacity: 0.5
-                                    }
-
-                                    // Timestamp
-                                    Text {
-                                        visible: root.showTimestamp
-                                        text: entryDelegate.timestamp || ""
-                                        font.family: root.fontMono
-                                        font.pixelSize: root.terminalFontSize
-                                        color: root.colorMutedFg
-                                    }
+                        // ── Minimap: 整個 buffer(type 色 / keyword 色 / 行長密度),點擊或拖曳跳轉
+                        MinimapItem {
+                            id: minimap
+                            anchors.right: parent.right
+                            anchors.top: terminalView.top
+                            anchors.bottom: terminalView.bottom
+                            // 只畫即時 buffer;開啟的 log 檔可達上億列,不提供 minimap
+                            width: root.minimapVisible && !mappedLog.active ? 14 : 0
+                            visible: root.minimapVisible && !mappedLog.active
+                            z: 3
+                            model: terminalModel
+                            rxColor: root.colorAccent
+                            txColor: root.colorAccentTertiary
+                            systemColor: root.colorAccentSecondary
+                            errorColor: root.colorDestructive
 
-                                    // Prefix + Data (RichText for keyword highlighting)
-                                    Text {
-                                        id: displayText
-                                        objectName: "displayText"
-                                        visible: root.activeEditRow !== entryDelegate.entryIndex
-                                        text: {
-                                            root.keywordRevision  // re-evaluate on keyword change
-                                            var prefix = ""
-                                            if (root.showPrefix) {
-                                                switch (String(entryDelegate.type)) {
-                                                case "rx":     prefix = "RX&gt; "; break
-                                                case "tx":     prefix = "TX&gt; "; break
-                                                case "system": prefix = "SYS&gt; "; break
-                                                case "error":  prefix = "ERR&gt; "; break
-                                                default:       prefix = "&gt; "
-                                                }
-                                            }
-                                            var textData = (root.hexDisplayMode && entryDelegate.hexData !== "")
-                                                ? entryDelegate.hexData : entryDelegate.msgText
-                                            return prefix + highlightText(String(textData))
-                                        }
-                                        textFormat: Text.RichText
-                                        font.family: root.fontMono
-                                        font.pixelSize: root.terminalFontSize
-                                        color: entryDelegate.resolvedColor
-                                        wrapMode: Text.WrapAnywhere
-                                        width: parent.width - x
-                                    }
+                            // 目前視窗位置(flood 取樣時即在尾端)
+                            Rectangle {
+                                readonly property real total: Math.max(1, terminalModel.count * terminalView.rowHeight)
+                                x: 0
+                                width: parent.width
+                                y: terminalModel.sampling ? parent.height - height
+                                   : Math.min(parent.height - height, terminalView.contentY / total * parent.height)
+                                height: Math.max(4, Math.min(1, terminalView.height / total) * parent.height)
+                                color: "transparent"
+                                border.color: root.colorFg
+                                border.width: 1
+                                opacity: 0.6
+                            }
 
-                                    // Selectable TextEdit (plain text, shown on click for char-level selection)
-                                    TextEdit {
-                                        id: editText
-                                        objectName: "editText"
-                                        visible: root.activeEditRow === entryDelegate.entryIndex
-                                        text: displayText.text
-                                        textFormat: TextEdit.RichText
-                                        readOnly: true
-                                        selectByMouse: false   // we control selection programmatically
-                                        font.family: root.fontMono
-                                        font.pixelSize: root.terminalFontSize
-                                        color: entryDelegate.resolvedColor
-                                        selectedTextColor: root.colorBg
-                                        selectionColor: Qt.rgba(root.colorAccent.r, root.colorAccent.g, root.colorAccent.b, 0.6)
-                                        wrapMode: TextEdit.WrapAnywhere
-                                        width: parent.width - x
-                                        onVisibleChanged: {
-                                            if (visible) deselect()
-                                        }
-                                    }
+                            MouseArea {
+                                anchors.fill: parent
+                                cursorShape: Qt.PointingHandCursor
+                                function jump(mouseY) {
+                                    var f = Math.max(0, Math.min(1, mouseY / height))
+                                    root.autoScroll = false
+                                    // flood 取樣時關掉 autoScroll 會切回完整 model: 換好之後再定位
+                                    Qt.callLater(function() {
+                                        terminalView.contentY = f * terminalView.contentHeight - terminalView.height / 2
+                                    })
                                 }
+                                onPressed: (mouse) => jump(mouse.y)
+                                onPositionChanged: (mouse) => { if (pressed) jump(mouse.y) }
+                            }
+                        }
 
-                                // Partial-line selection highlight for cross-line drag
-                                Rectangle {
-                                    id: partialSelRect
-                                    z: 10  // above dataRow so it covers text
-                                    visible: {
-                                        root._dragSelVersion
-                                        if (!root._dragSelecting && root._dragStartModelRow < 0) return false
-                                        var info = root.getDragSelectionInfo(entryDelegate.index)
-                                        return info.type !== "none"
-                                    }
-                                    y: 0; height: parent.height
-                                    color: Qt.rgba(root.colorAccent.r, root.colorAccent.g, root.colorAccent.b, 0.6)
-                                    clip: true
-
-                                    // Re-render the row text in selectedTextColor inside the highlight rect
-                                    Row {
-                                        // Position this row so its text aligns exactly with dataRow
-                                        x: dataRow.x - partialSelRect.x
-                                        y: dataRow.y
-                                        spacing: dataRow.spacing
-
-                                        Text {
-                                            visible: root.showLineNumbers
-                                            text: String(entryDelegate.entryIndex + 1).padStart(4, ' ')
-                                            font.family: root.fontMono
-                                            font.pixelSize: root.terminalFontSize
-                                            color: root.colorBg
-                                        }
-                                        Text {
-                                            visible: root.showTimestamp
-                                            text: entryDelegate.timestamp || ""
-                                            font.family: root.fontMono
-                                            font.pixelSize: root.terminalFontSize
-                                            color: root.colorBg
-                                        }
-                                        Text {
-                                            text: displayText.text
-                                            textFormat: Text.RichText
-                                            font.family: root.fontMono
-                                            font.pixelSize: root.terminalFontSize
-                                            color: root.colorBg
-                                            wrapMode: Text.WrapAnywhere
-                                            width: displayText.width
-                                        }
-                                    }
+                        Binding {
+                            target: terminalModel
+                            property: "floodSampleRows"
+                            value: Math.max(1, Math.ceil(terminalView.height / terminalView.rowHeight))
+                        }
 
-                                    x: {
-                                        root._dragSelVersion
-                                        var info = root.getDragSelectionInfo(entryDelegate.index)
-                                        if (info.type === "none") return 0
-                                        if (info.type === "full") return dataRow.x + displayText.x
-                                        if (info.type === "head") {
-                                            return root.getCharXInDelegate(entryDelegate, info.charStart)
-                                        }
-                                        // tail: from start of displayText to charEnd
-                                        return dataRow.x + displayText.x
-                                    }
-                                    width: {
-                                        root._dragSelVersion
-                                        var info = root.getDragSelectionInfo(entryDelegate.index)
-                                        if (info.type === "none") return 0
-                                        if (info.type === "full") return parent.width - (dataRow.x + displayText.x)
-                                        if (info.type === "head") {
-                                            var startX = root.getCharXInDelegate(entryDelegate, info.charStart)
-                                            return parent.width - startX
-                                        }
-                                        // tail
-                                        var baseX = dataRow.x + displayText.x
-                                        var endX = root.getCharXInDelegate(entryDelegate, info.charEnd)
-                                        return Math.max(0, endX - baseX)
-                                    }
-                                }
+                        ScrollBar {
+                            id: terminalScrollBar
+                            anchors.right: minimap.left
+                            anchors.top: terminalView.top
+                            anchors.bottom: terminalView.bottom
+                            orientation: Qt.Vertical
+                            policy: ScrollBar.AsNeeded
+                            size: terminalView.contentHeight > 0
+                                ? Math.min(1.0, terminalView.height / terminalView.contentHeight) : 1.0
+                            position: terminalView.contentHeight > 0
+                                ? terminalView.contentY / terminalView.contentHeight : 0
+                            // AsNeeded 的隱藏在 Basic style 是做在「預設 contentItem」的
+                            // opacity state 上;自訂 contentItem 後必須自己依 size 隱藏
+                            visible: size < 1.0
+                            hoverEnabled: true
+                            width: 12
+                            z: 3
+
+                            // User dragging scrollbar upward disables auto-scroll
+                            property real _lastPos: 0
+                            onMoved: {
+                                if (position < _lastPos - 0.0005)
+                                    root.autoScroll = false
+                                _lastPos = position
+                                terminalView.contentY = position * terminalView.contentHeight
+                            }
+                            onPressedChanged: _lastPos = position
+                            contentItem: Rectangle {
+                                implicitWidth: 12
+                                color: root.colorAccent
+                                opacity: terminalScrollBar.pressed ? 0.9
+                                       : (terminalScrollBar.hovered ? 0.7 : 0.4)
+                                radius: 3
+                                Behavior on opacity { NumberAnimation { duration: 120 } }
+                            }
+                            background: Rectangle {
+                                implicitWidth: 12
+                                color: terminalScrollBar.hovered
+                                    ? Qt.rgba(root.colorAccent.r, root.colorAccent.g, root.colorAccent.b, 0.08)
+                                    : "transparent"
+                                Behavior on color { ColorAnimation { duration: 120 } }
                             }
                         }
 
@@ -2628,59 +2811,26 @@ Window {
                             id: terminalMouseOverlay
                             anchors.fill: parent
                             // Leave room for the ScrollBar so it can receive clicks/drags
-                            // ScrollBar sits flush with parent's right edge now (ListView rightMargin=0)
-                            anchors.rightMargin: terminalScrollBar.visible ? terminalScrollBar.width : 0
+                            anchors.rightMargin: (terminalScrollBar.visible ? terminalScrollBar.width : 0) + minimap.width
                             z: 2
                             acceptedButtons: Qt.LeftButton | Qt.RightButton
                             hoverEnabled: false
 
+                            // 固定 cell 尺寸: 直接由座標換算 row / column,不必找 delegate
                             function rowAtY(mouseY) {
-                                // Map overlay coords → ListView contentItem coords
-                                var mapped = mapToItem(terminalView.contentItem, 0, mouseY)
-                                return terminalView.indexAt(terminalView.width / 2, mapped.y)
-                            }
-
-                            function stripHtmlToPlain(html) {
-                                return html.replace(/<[^>]*>/g, "")
-                                           .replace(/&gt;/g, ">")
-                                           .replace(/&lt;/g, "<")
-                                           .replace(/&amp;/g, "&")
-                                           .replace(/&quot;/g, "\"")
-                                           .replace(/&#39;/g, "'")
+                                return terminalView.rowAt(mapToItem(terminalView, 0, mouseY).y)
                             }
 
-                            function charPosInRow(modelRow, mouseX, mouseY) {
-                                var item = terminalView.itemAtIndex(modelRow)
-                                if (!item) return 0
-                                var tgt = findTextInDelegate(item)
-                                if (!tgt) return 0
-                                var mapped = mapToItem(tgt, mouseX, mouseY)
-                                var charWidth = monoCharMetrics.advanceWidth
-                                if (charWidth <= 0) return 0
-                                var plainText = tgt.text ? stripHtmlToPlain(tgt.text) : ""
-                                return Math.max(0, Math.min(plainText.length, Math.round(mapped.x / charWidth)))
-                            }
-
-                            function findTextInDelegate(item) {
-                                for (var i = 0; i < item.children.length; i++) {
-                                    var child = item.children[i]
-                                    if (child.children) {
-                                        for (var j = 0; j < child.children.length; j++) {
-                                            var gc = child.children[j]
-                                            if (gc.objectName === "editText" && gc.visible) return gc
-                                            if (gc.objectName === "displayText" && gc.visible) return gc
-                                        }
-                                    }
-                                }
-                                return null
+                            function columnAtX(row, mouseX) {
+                                return terminalView.columnAt(row, mapToItem(terminalView, mouseX, 0).x)
                             }
 
                             onPressed: function(mouse) {
                                 if (mouse.button === Qt.RightButton) {
                                     // Find the row under cursor for context menu
                                     var row = rowAtY(mouse.y)
-                                    if (row >= 0) {
-                                        var entry = terminalModel.get(row)
+                                    if (row >= 0 && !root.viewSampling) {
+                                        var entry = root.viewModel.get(row)
                                         if (entry) root.lastClickedRowText = String(entry.msgText)
                                     }
                                     terminalContextMenu.popup()
@@ -2689,21 +2839,27 @@ Window {
                                 }
 
                                 terminalView.forceActiveFocus()
+                                // 取樣畫面的列不是 model 列: 先暫停跟尾,切回完整 model 再選取
+                                if (root.viewSampling) {
+                                    root.autoScroll = false
+                                    mouse.accepted = true
+                                    return
+                                }
                                 var row = rowAtY(mouse.y)
 
                                 // Ctrl / Shift clicks → line-level selection
                                 if (mouse.modifiers & Qt.ShiftModifier && root.lastClickedRow >= 0) {
-                                    root.activeEditRow = -1
+                                    terminalView.clearCharSelection()
                                     root._dragSelecting = false
                                     selectRange(root.lastClickedRow, row)
                                     mouse.accepted = true
                                     return
                                 }
                                 if (mouse.modifiers & Qt.ControlModifier) {
-                                    root.activeEditRow = -1
+                                    terminalView.clearCharSelection()
                                     root._dragSelecting = false
                                     if (row >= 0) {
-                                        var entry = terminalModel.get(row)
+                                        var entry = root.viewModel.get(row)
                                         if (entry) toggleSelection(entry.entryIndex)
                                     }
                                     root.lastClickedRow = row
@@ -2717,124 +2873,39 @@ Window {
                                     return
                                 }
 
-                                var charPos = charPosInRow(row, mouse.x, mouse.y)
                                 root._dragSelecting = true
-                                root._dragStartModelRow = row
-                                root._dragStartCharPos = charPos
-                                root._dragEndModelRow = row
-                                root._dragEndCharPos = charPos
                                 root.lastClickedRow = row
-
-                                // Activate single-row edit mode
-                                var entryObj = terminalModel.get(row)
-                                if (entryObj) {
-                                    root.activeEditRow = entryObj.entryIndex
-                                    selectOnly(entryObj.entryIndex)
-                                }
-                                // Defer _selStart to first onPositionChanged (editText needs layout pass)
-                                root._selStart = -1
-                                root._dragPressMouseX = mouse.x
-                                root._dragPressMouseY = mouse.y
-                                root._dragSelVersion++
+                                terminalView.setCharSelectionAnchor(row, columnAtX(row, mouse.x))
+                                var entryObj = root.viewModel.get(row)
+                                if (entryObj) selectOnly(entryObj.entryIndex)
                             }
 
                             onPositionChanged: function(mouse) {
                                 if (!pressed || !root._dragSelecting) return
                                 var row = rowAtY(mouse.y)
                                 if (row < 0) return
-                                var charPos = charPosInRow(row, mouse.x, mouse.y)
-                                root._dragEndModelRow = row
-                                root._dragEndCharPos = charPos
-
-                                var startRow = root._dragStartModelRow
-                                var endRow = row
-
-                                if (startRow === endRow) {
-                                    // Single-row: use TextEdit selection
-                                    var entryObj = terminalModel.get(startRow)
-                                    if (entryObj) {
-                                        root.activeEditRow = entryObj.entryIndex
-                                        selectOnly(entryObj.entryIndex)
-                                        var item = terminalView.itemAtIndex(startRow)
-                                        if (item) {
-                                            var et = findEditText(item)
-                                            if (et) {
-                                                // Compute _selStart on first drag (editText is now laid out)
-                                                if (root._selStart < 0) {
-                                                    var startPt = terminalMouseOverlay.mapToItem(et, root._dragPressMouseX, root._dragPressMouseY)
-                                                    root._selStart = et.positionAt(startPt.x, startPt.y)
-                                                }
-                                                var localPt = terminalMouseOverlay.mapToItem(et, mouse.x, mouse.y)
-                                                var pos = et.positionAt(localPt.x, localPt.y)
-                                                et.select(root._selStart, pos)
-                                            }
-                                        }
-                                    }
-                                } else {
-                                    // Multi-row: deactivate single-row TextEdit, use visual overlay
-                                    root.activeEditRow = -1
-                                    root._selStart = -1
-                                    // Update selectedSet to cover the range (一次跨界呼叫取代逐列 get)
-                                    var lo = Math.min(startRow, endRow)
-                                    var hi = Math.max(startRow, endRow)
-                                    var idxList = terminalModel.entryIndicesInRange(lo, hi)
-                                    var s = {}
-                                    for (var i = 0; i < idxList.length; i++)
-                                        s[idxList[i]] = true
-                                    root.selectedSet = s
-                                    root.selectionVersion++
-                                }
-                                root._dragSelVersion++
+                                terminalView.extendCharSelection(row, columnAtX(row, mouse.x))
+
+                                // 整列選取跟著字元選取的列範圍(一個 entryIndex 區間)
+                                root.viewModel.selectRows(terminalView.charSelectionFirstRow,
+                                                          terminalView.charSelectionLastRow, false)
                             }
 
                             onReleased: function(mouse) {
-                                if (root._dragSelecting) {
-                                    root._dragSelecting = false
-                                    root._selStart = -1
-                                    // If it was a single-row click with no drag, keep the TextEdit active
-                                    if (root._dragStartModelRow === root._dragEndModelRow &&
-                                        root._dragStartCharPos === root._dragEndCharPos) {
-                                        // Single click, no drag — activate TextEdit for that row
-                                        var entryObj = terminalModel.get(root._dragStartModelRow)
-                                        if (entryObj) root.activeEditRow = entryObj.entryIndex
-                                    }
-                                }
+                                root._dragSelecting = false
                             }
 
                             onDoubleClicked: function(mouse) {
                                 if (mouse.button !== Qt.LeftButton) return
                                 var row = rowAtY(mouse.y)
                                 if (row < 0) return
-                                var entry = terminalModel.get(row)
+                                var entry = root.viewModel.get(row)
                                 if (!entry) return
 
-                                // Activate editText for this row
-                                root.activeEditRow = entry.entryIndex
                                 selectOnly(entry.entryIndex)
                                 root.lastClickedRow = row
                                 root._dragSelecting = false
-
-                                // Wait one frame for editText layout, then select word
-                                Qt.callLater(function() {
-                                    var item = terminalView.itemAtIndex(row)
-                                    if (!item) return
-                                    var et = findEditText(item)
-                                    if (!et) return
-                                    var localPt = terminalMouseOverlay.mapToItem(et, mouse.x, mouse.y)
-                                    var pos = et.positionAt(localPt.x, localPt.y)
-                                    // Get plain text and find word boundaries
-                                    var plain = et.getText(0, et.length)
-                                    var wordStart = pos
-                                    var wordEnd = pos
-                                    // Expand left to word boundary
-                                    while (wordStart > 0 && /\S/.test(plain.charAt(wordStart - 1)))
-                                        wordStart--
-                                    // Expand right to word boundary
-                                    while (wordEnd < plain.length && /\S/.test(plain.charAt(wordEnd)))
-                                        wordEnd++
-                                    if (wordStart < wordEnd)
-                                        et.select(wordStart, wordEnd)
-                                })
+                                terminalView.selectWordAt(row, columnAtX(row, mouse.x))
                             }
 
                             onWheel: function(wheel) {
@@ -2850,24 +2921,22 @@ Window {
                                     else if (wheel.angleDelta.y < 0 && root.terminalFontSize > 8)
                                         root.terminalFontSize--
                                     wheel.accepted = true
+                                } else if ((wheel.modifiers & Qt.ShiftModifier) || wheel.angleDelta.x !== 0) {
+                                    // 水平捲動: Shift+滾輪 或 觸控板橫向
+                                    var dx = wheel.angleDelta.x !== 0 ? -wheel.angleDelta.x : -wheel.angleDelta.y
+                                    terminalView.contentX = terminalView.contentX + dx / 120 * terminalView.cellWidth * 8
+                                    wheel.accepted = true
                                 } else {
                                     var step = 60
                                     if (wheel.angleDelta.y > 0) {
                                         // Scroll up — 內容未滿版時不關 auto-scroll
                                         // (contentY 動不了,onContentYChanged 無法復原,旗標會卡死)
-                                        if (terminalView.contentHeight > terminalView.height) {
-                                            terminalView.contentY = Math.max(terminalView.originY, terminalView.contentY - step)
+                                        if (root.viewSampling || terminalView.contentHeight > terminalView.height) {
+                                            terminalView.contentY = terminalView.contentY - step
                                             root.autoScroll = false
                                         }
                                     } else {
-                                        // Scroll down — use positionViewAtEnd() near bottom
-                                        // to avoid being clamped by estimated contentHeight
-                                        var maxY = terminalView.originY + terminalView.contentHeight - terminalView.height
-                                        if (terminalView.contentY + step >= maxY) {
-                                            terminalView.positionViewAtEnd()
-                                        } else {
-                                            terminalView.contentY = terminalView.contentY + step
-                                        }
+                                        terminalView.contentY = terminalView.contentY + step
                                     }
                                     wheel.accepted = true
                                 }
@@ -2877,8 +2946,9 @@ Window {
                         // Empty state
                         Text {
                             anchors.centerIn: parent
-                            visible: terminalModel.count === 0
-                            text: "AWAITING DATA STREAM..."
+                            visible: root.viewModel.count === 0
+                            text: !mappedLog.active ? "AWAITING DATA STREAM..."
+                                : (mappedLog.indexing || mappedLog.filtering ? "SCANNING LOG FILE..." : "NO MATCHING LINES")
                             font.family: root.fontMono
                             font.pixelSize: 13
                             font.letterSpacing: 2
@@ -2886,6 +2956,142 @@ Window {
                             opacity: 0.5
                         }
 
+                        // Flood mode banner — 速率超過門檻時畫面為取樣,擷取 / log 不受影響
+                        Rectangle {
+                            anchors.top: parent.top
+                            anchors.right: parent.right
+                            anchors.topMargin: 8
+                            anchors.rightMargin: 20
+                            width: floodText.width + 16
+                            height: 22
+                            z: 5
+                            visible: terminalModel.flooding && !mappedLog.active
+                            color: Qt.rgba(root.colorCard.r, root.colorCard.g, root.colorCard.b, 0.92)
+                            border.color: "#ffaa00"
+                            border.width: 1
+
+                            Text {
+                                id: floodText
+                                anchors.centerIn: parent
+                                text: "FLOOD " + (terminalModel.lineRate / 1000).toFixed(1) + "K LINES/S"
+                                      + (terminalModel.sampling ? " // LIVE SAMPLE" : "")
+                                      + " // CAPTURE LOSSLESS"
+                                font.family: root.fontMono
+                                font.pixelSize: 10
+                                font.letterSpacing: 1
+                                font.bold: true
+                                color: "#ffaa00"
+                            }
+                        }
+
+                        // 開啟中的 log 檔: 檔名 / 索引進度 / filter 與搜尋掃描狀態
+                        Rectangle {
+                            anchors.top: parent.top
+                            anchors.right: parent.right
+                            anchors.topMargin: 8
+                            anchors.rightMargin: 20
+                            width: logViewRow.width + 16
+                            height: 22
+                            z: 5
+                            visible: mappedLog.active
+                            color: Qt.rgba(root.colorCard.r, root.colorCard.g, root.colorCard.b, 0.92)
+                            border.color: root.colorAccentTertiary
+                            border.width: 1
+
+                            Row {
+                                id: logViewRow
+                                anchors.centerIn: parent
+                                spacing: 10
+
+                                Text {
+                                    text: {
+                                        var p = mappedLog.path
+                                        var i = Math.max(p.lastIndexOf('/'), p.lastIndexOf('\\'))
+                                        var status = mappedLog.indexing
+                                            ? " // INDEXING " + Math.floor(mappedLog.progress * 100) + "%"
+                                            : ""
+                                        if (mappedLog.filtering) status += " // FILTERING"
+                                        if (mappedLog.searching) status += " // SEARCHING"
+                                        return "LOG " + mappedLog.format.toUpperCase() + " "
+                                            + (i >= 0 ? p.substring(i + 1) : p) + " // "
+                                            + formatBytes(mappedLog.fileSize) + status
+                                    }
+                                    font.family: root.fontMono
+                                    font.pixelSize: 10
+                                    font.letterSpacing: 1
+                                    font.bold: true
+                                    color: root.colorAccentTertiary
+                                    anchors.verticalCenter: parent.verticalCenter
+                                }
+
+                                Text {
+                                    text: "[CLOSE]"
+                                    font.family: root.fontMono
+                                    font.pixelSize: 10
+                                    font.letterSpacing: 1
+                                    font.bold: true
+                                    color: logViewCloseMa.containsMouse ? root.colorDestructive : root.colorMutedFg
+                                    anchors.verticalCenter: parent.verticalCenter
+                                    MouseArea {
+                                        id: logViewCloseMa
+                                        anchors.fill: parent
+                                        hoverEnabled: true
+                                        cursorShape: Qt.PointingHandCursor
+                                        onClicked: mappedLog.close()
+                                    }
+                                }
+                            }
+                        }
+
+                        // 匯出中: 進度 / 已寫出列數,可取消
+                        Rectangle {
+                            anchors.top: parent.top
+                            anchors.right: parent.right
+                            anchors.topMargin: mappedLog.active ? 34 : 8
+                            anchors.rightMargin: 20
+                            width: exportRow.width + 16
+                            height: 22
+                            z: 5
+                            visible: terminalExporter.running
+                            color: Qt.rgba(root.colorCard.r, root.colorCard.g, root.colorCard.b, 0.92)
+                            border.color: root.colorAccentTertiary
+                            border.width: 1
+
+                            Row {
+                                id: exportRow
+                                anchors.centerIn: parent
+                                spacing: 10
+
+                                Text {
+                                    text: "EXPORTING " + Math.floor(terminalExporter.progress * 100) + "% // "
+                                        + terminalExporter.exportedLines + " LINES"
+                                    font.family: root.fontMono
+                                    font.pixelSize: 10
+                                    font.letterSpacing: 1
+                                    font.bold: true
+                                    color: root.colorAccentTertiary
+                                    anchors.verticalCenter: parent.verticalCenter
+                                }
+
+                                Text {
+                                    text: "[CANCEL]"
+                                    font.family: root.fontMono
+                                    font.pixelSize: 10
+                                    font.letterSpacing: 1
+                                    font.bold: true
+                                    color: exportCancelMa.containsMouse ? root.colorDestructive : root.colorMutedFg
+                                    anchors.verticalCenter: parent.verticalCenter
+                                    MouseArea {
+                                        id: exportCancelMa
+                                        anchors.fill: parent
+                                        hoverEnabled: true
+                                        cursorShape: Qt.PointingHandCursor
+                                        onClicked: terminalExporter.cancel()
+                                    }
+                                }
+                            }
+                        }
+
                         // Auto-scroll paused overlay
                         Rectangle {
                             anchors.bottom: parent.bottom
@@ -2896,12 +3102,12 @@ Window {
                             anchors.rightMargin: 20
                             height: 32
                             z: 5
-                            visible: !root.autoScroll && terminalModel.count > 0
+                            visible: !root.autoScroll && terminalModel.count > 0 && !mappedLog.active
                             color: Qt.rgba(root.colorCard.r, root.colorCard.g, root.colorCard.b, 0.92)
                             border.color: root.colorAccent
                             border.width: 1
 
-                            opacity: !root.autoScroll && terminalModel.count > 0 ? 1.0 : 0.0
+                            opacity: !root.autoScroll && terminalModel.count > 0 && !mappedLog.active ? 1.0 : 0.0
                             Behavior on opacity { NumberAnimation { duration: 150 } }
 
                             Row {
@@ -2954,7 +3160,7 @@ Window {
                         // 單一 Canvas: keyword highlight 依 keyword 色彩標記,搜尋命中(橘)疊上層
                         Item {
                             id: markerBar
-                            anchors.right: parent.right
+                            anchors.right: minimap.left
                             anchors.top: parent.top
                             anchors.bottom: parent.bottom
                             anchors.margins: 8
@@ -2966,7 +3172,7 @@ Window {
                             property var kwMarkers: []
 
                             function refreshKwMarkers() {
-                                kwMarkers = terminalModel.highlightMarkers()
+                                kwMarkers = root.viewModel.highlightMarkers()
                                 markerCanvas.requestPaint()
                             }
 
@@ -2983,7 +3189,7 @@ Window {
                                 onPaint: {
                                     var ctx = getContext("2d")
                                     ctx.clearRect(0, 0, width, height)
-                                    var total = terminalModel.count
+                                    var total = root.viewModel.count
                                     if (total <= 0) return
                                     var h = Math.max(2, height / total * 1.5)
 
@@ -3029,19 +3235,102 @@ Window {
                             }
                         }
 
+                        // ── Hex dump(原始 RX bytes,16 bytes/列;row 在 C++ 依 viewport 才組字串)
+                        Rectangle {
+                            id: hexDumpPanel
+                            anchors.fill: parent
+                            visible: root.hexDumpVisible
+                            color: root.colorBg
+                            z: 5
+                            // ListView 與 bytes 的收集都在第一次顯示時才開始
+                            onVisibleChanged: if (visible) {
+                                hexDumpLoader.active = true
+                                hexDumpModel.enabled = true
+                            }
+
+                            // 擋住下層終端機的選取 / 右鍵選單
+                            MouseArea { anchors.fill: parent; acceptedButtons: Qt.AllButtons }
+
+                            Loader {
+                                id: hexDumpLoader
+                                anchors.fill: parent
+                                active: false
+                                sourceComponent: Component {
+                                    Item {
+                                        ListView {
+                                            id: hexDumpView
+                                            anchors.fill: parent
+                                            anchors.margins: 8
+                                            clip: true
+                                            model: hexDumpPanel.visible ? hexDumpModel : null
+                                            reuseItems: true
+                                            boundsBehavior: Flickable.StopAtBounds
+                                            property bool followTail: true
+                                            property real rowHeight: root.terminalFontSize + 4
+                                            onCountChanged: if (followTail) positionViewAtEnd()
+                                            onMovementEnded: followTail = atYEnd
+                                            onModelChanged: if (model) positionViewAtEnd()
+
+                                            ScrollBar.vertical: ScrollBar {
+                                                policy: ScrollBar.AsNeeded
+                                                onPressedChanged: if (!pressed) hexDumpView.followTail = hexDumpView.atYEnd
+                                            }
+
+                                            delegate: Row {
+                                                required property string offset
+                                                required property string hex
+                                                required property string ascii
+                                                height: hexDumpView.rowHeight
+                                                spacing: 16
+
+                                                Text {
+                                                    text: offset
+                                                    font.family: root.fontMono
+                                                    font.pixelSize: root.terminalFontSize
+                                                    color: root.colorMutedFg
+                                                    textFormat: Text.PlainText
+                                                }
+                                                Text {
+                                                    text: hex
+                                                    font.family: root.fontMono
+                                                    font.pixelSize: root.terminalFontSize
+                                                    color: root.colorAccent
+                                                    textFormat: Text.PlainText
+                                                }
+                                                Text {
+                                                    text: ascii
+                                                    font.family: root.fontMono
+                                                    font.pixelSize: root.terminalFontSize
+                                                    color: root.colorFg
+                                                    textFormat: Text.PlainText
+                                                }
+                                            }
+                                        }
+
+                                        Text {
+                                            anchors.right: parent.right
+                                            anchors.bottom: parent.bottom
+                                            anchors.margins: 16
+                                            text: (hexDumpModel.spoolFailed ? "SPOOL FULL // " : "")
+                                                  + hexDumpModel.byteCount + " BYTES"
+                                            font.family: root.fontMono
+                                            font.pixelSize: 10
+                                            font.letterSpacing: 1
+                                            color: hexDumpModel.spoolFailed ? root.colorDestructive : root.colorMutedFg
+                                        }
+                                    }
+                                }
+                            }
+                        }
+
                         // Scanline overlay on terminal
-                        Canvas {
+                        Image {
                             anchors.fill: parent
                             z: 10
                             opacity: 0.04
-                            onPaint: {
-                                var ctx = getContext("2d")
-                                ctx.clearRect(0, 0, width, height)
-                                ctx.fillStyle = "#000000"
-                                for (var y = 0; y < height; y += 4)
-                                    ctx.fillRect(0, y, width, 1)
-                            }
-                            Component.onCompleted: requestPaint()
+                            source: "image://fx/scanline/4"
+                            fillMode: Image.Tile
+                            smooth: false
                         }
                     }
 
@@ -3212,6 +3501,30 @@ Window {
                         font.bold: true
                         color: root.colorDestructive
                     }
+
+                    // writer thread 速率 / 佇列積壓(有積壓才顯示)/ 非 buffered 時的同步延遲
+                    Text {
+                        visible: fileLogger.writeRate > 0 || fileLogger.queueDepth > 0
+                        text: formatBytes(fileLogger.writeRate) + "/s"
+                              + (fileLogger.queueDepth > 0 ? " Q" + fileLogger.queueDepth : "")
+                              + (fileLogger.durability !== "buffered" && fileLogger.syncCount > 0
+                                 ? " SYNC " + (fileLogger.syncLatencyUs / 1000).toFixed(1) + "ms" : "")
+                        font.family: root.fontMono
+                        font.pixelSize: 10
+                        font.letterSpacing: 1
+                        color: root.colorMutedFg
+                    }
+
+                    // 佇列滿的次數(GUI 不等磁碟: 先暫存,暫存也滿才丟並計數)
+                    Text {
+                        visible: fileLogger.producerStalls > 0 || fileLogger.droppedRecords > 0
+                        text: "QFULL " + fileLogger.producerStalls
+                              + (fileLogger.droppedRecords > 0 ? " DROP " + fileLogger.droppedRecords : "")
+                        font.family: root.fontMono
+                        font.pixelSize: 10
+                        font.letterSpacing: 1
+                        color: root.colorDestructive
+                    }
                 }
 
                 Item { Layout.fillWidth: true }
@@ -3231,25 +3544,14 @@ Window {
     // ══════════════════════════════════════════════════════════════
     // SCANLINE OVERLAY (full window)
     // ══════════════════════════════════════════════════════════════
-    Canvas {
-        id: scanlineCanvas
+    Image {
+        id: scanlineOverlay
         anchors.fill: parent
         z: 100
         opacity: 0.03
-        onPaint: {
-            var ctx = getContext("2d")
-            ctx.clearRect(0, 0, width, height)
-            ctx.fillStyle = "#000000"
-            for (var y = 0; y < height; y += 3)
-                ctx.fillRect(0, y, width, 1)
-        }
-        Component.onCompleted: requestPaint()
-        Connections {
-            target: root
-            function onWidthChanged()  { scanlineCanvas.requestPaint() }
-            function onHeightChanged() { scanlineCanvas.requestPaint() }
-            function onUiScaleChanged() { scanlineCanvas.requestPaint() }
-        }
+        source: "image://fx/scanline/3"
+        fillMode: Image.Tile
+        smooth: false
     }
 
     } // contentRoot
@@ -3311,98 +3613,161 @@ Window {
     // ══════════════════════════════════════════════════════════════
     // FILE DIALOGS
     // ══════════════════════════════════════════════════════════════
-    FileDialog {
-        id: logSaveDialog
-        title: "Save Log File"
-        fileMode: FileDialog.SaveFile
-        nameFilters: ["Log files (*.log)", "Text files (*.txt)", "All files (*)"]
-        onAccepted: {
-            if (fileLogger.startLogging(selectedFile.toString())) {
-                logExistingEntriesToFile()
-                var ts = Qt.formatDateTime(new Date(), "HH:mm:ss.zzz")
-                addTerminalEntry(ts, "Logging started — " + fileLogger.logFilePath, "", "system")
-            } else {
-                var ts2 = Qt.formatDateTime(new Date(), "HH:mm:ss.zzz")
-                addTerminalEntry(ts2, "Failed to start logging", "", "error")
+    Loader {
+        id: logSaveDialogLoader
+        active: false
+        sourceComponent: Component {
+            FileDialog {
+                id: logSaveDialog
+                title: "Save Log File"
+                fileMode: FileDialog.SaveFile
+                nameFilters: ["Log files (*.log)", "Text files (*.txt)", "JSONL (*.jsonl)",
+                              "Raw capture (*.cap)", "pcapng (*.pcapng)", "All files (*)"]
+                onAccepted: {
+                    // 格式依副檔名: .cap = 原始 chunk capture,.pcapng = Wireshark,.jsonl = JSONL,其餘 text
+                    var path = selectedFile.toString()
+                    var fmt = /\.cap$/i.test(path) ? "cap"
+                            : /\.pcapng$/i.test(path) ? "pcapng"
+                            : /\.jsonl$/i.test(path) ? "jsonl" : "text"
+                    if (fileLogger.startLogging(path, fmt)) {
+                        var ts = Qt.formatDateTime(new Date(), "HH:mm:ss.zzz")
+                        addTerminalEntry(ts, "Logging started — " + fileLogger.logFilePath, "", "system")
+                        if (fileLogger.recoveredBytes > 0)
+                            addTerminalEntry(ts, "Log recovered — truncated " + fileLogger.recoveredBytes
+                                             + " bytes of an incomplete record", "", "system")
+                    } else {
+                        var ts2 = Qt.formatDateTime(new Date(), "HH:mm:ss.zzz")
+                        addTerminalEntry(ts2, "Failed to start logging: " + fileLogger.lastError, "", "error")
+                    }
+                }
             }
         }
     }
 
-    // ══════════════════════════════════════════════════════════════
-    // HELP POPUP
-    // ══════════════════════════════════════════════════════════════
-    Popup {
-        id: helpPopup
-        visible: root.helpPopupVisible
-        modal: true
-        anchors.centerIn: parent
-        width: 420
-        height: helpCol.implicitHeight + 48
-        closePolicy: Popup.CloseOnEscape | Popup.CloseOnPressOutside
-        onClosed: root.helpPopupVisible = false
-
-        background: Rectangle {
-            color: root.colorCard
-            border.color: root.colorAccent
-            border.width: 1
-            radius: 4
+    Loader {
+        id: logOpenDialogLoader
+        active: false
+        sourceComponent: Component {
+            FileDialog {
+                id: logOpenDialog
+                title: "Open Log File"
+                fileMode: FileDialog.OpenFile
+                nameFilters: ["Log files (*.log *.txt *.jsonl *.cap)", "All files (*)"]
+                onAccepted: {
+                    if (!mappedLog.open(selectedFile.toString())) {
+                        var ts = Qt.formatDateTime(new Date(), "HH:mm:ss.zzz")
+                        addTerminalEntry(ts, "Failed to open log — " + mappedLog.errorString, "", "error")
+                    }
+                }
+            }
         }
+    }
 
-        contentItem: Column {
-            id: helpCol
-            spacing: 6
-            padding: 16
-
-            Text {
-                text: "KEYBOARD SHORTCUTS"
-                font.family: root.fontMono
-                font.pixelSize: 14
-                font.bold: true
-                font.letterSpacing: 2
-                color: root.colorAccent
-                bottomPadding: 8
+    Loader {
+        id: selectionExportDialogLoader
+        active: false
+        sourceComponent: Component {
+            FileDialog {
+                id: selectionExportDialog
+                // "selection" | "visible" | "all"
+                property string scope: "selection"
+                title: scope === "all" ? "Export Buffer" : scope === "visible" ? "Export View" : "Export Selection"
+                fileMode: FileDialog.SaveFile
+                nameFilters: ["Text files (*.txt)", "Log files (*.log)", "JSON Lines (*.jsonl)",
+                              "CSV files (*.csv)", "All files (*)"]
+                onAccepted: {
+                    // 即時 buffer 與開啟的 log 都由 worker thread 串流寫出(格式依副檔名),
+                    // 結果見 terminalExporter.onFinished
+                    terminalExporter.start(selectedFile.toString(), scope, "", root.showTimestamp,
+                                           root.showPrefix, root.hexDisplayMode)
+                }
             }
+        }
+    }
 
-            Repeater {
-                model: [
-                    { key: "F1",               desc: "Show this help" },
-                    { key: "Ctrl + L",         desc: "Clear terminal" },
-                    { key: "Ctrl + C",         desc: "Copy selected text" },
-                    { key: "Ctrl + A",         desc: "Select all" },
-                    { key: "Ctrl + F",         desc: "Find" },
-                    { key: "F3 / Shift + F3",  desc: "Next / previous match" },
-                    { key: "Escape",           desc: "Close search" },
-                    { key: "End",              desc: "Jump to latest" },
-                    { key: "Ctrl + S",         desc: "Start / stop logging" },
-                    { key: "Ctrl + =",         desc: "Zoom in (terminal font)" },
-                    { key: "Ctrl + -",         desc: "Zoom out (terminal font)" },
-                    { key: "Ctrl + 0",         desc: "Reset zoom (terminal font)" },
-                    { key: "Ctrl + Shift + =", desc: "Scale up UI" },
-                    { key: "Ctrl + Shift + -", desc: "Scale down UI" },
-                    { key: "Ctrl + Shift + 0", desc: "Reset UI scale" },
-                    { key: "Space",            desc: "Toggle connection" },
-                    { key: "Enter",            desc: "Send / Search / Add filter" },
-                    { key: "Double-click chip", desc: "Edit keyword / filter" },
-                    { key: "Right-click",      desc: "Context menu" }
-                ]
+    // ══════════════════════════════════════════════════════════════
+    // HELP POPUP
+    // ══════════════════════════════════════════════════════════════
+    Loader {
+        id: helpPopupLoader
+        active: false
+        sourceComponent: Component {
+            Popup {
+                id: helpPopup
+                parent: root.contentItem
+                visible: root.helpPopupVisible
+                modal: true
+                anchors.centerIn: parent
+                width: 420
+                height: helpCol.implicitHeight + 48
+                closePolicy: Popup.CloseOnEscape | Popup.CloseOnPressOutside
+                onClosed: root.helpPopupVisible = false
+
+                background: Rectangle {
+                    color: root.colorCard
+                    border.color: root.colorAccent
+                    border.width: 1
+                    radius: 4
+                }
 
-                Row {
-                    spacing: 12
-                    width: helpCol.width - 32
+                contentItem: Column {
+                    id: helpCol
+                    spacing: 6
+                    padding: 16
 
                     Text {
-                        width: 160
-                        text: modelData.key
+                        text: "KEYBOARD SHORTCUTS"
                         font.family: root.fontMono
-                        font.pixelSize: 12
-                        color: root.colorAccentTertiary
-                        horizontalAlignment: Text.AlignRight
+                        font.pixelSize: 14
+                        font.bold: true
+                        font.letterSpacing: 2
+                        color: root.colorAccent
+                        bottomPadding: 8
                     }
-                    Text {
-                        text: modelData.desc
-                        font.family: root.fontMono
-                        font.pixelSize: 12
-                        color: root.colorFg
+
+                    Repeater {
+                        model: [
+                            { key: "F1",               desc: "Show this help" },
+                            { key: "Ctrl + L",         desc: "Clear terminal" },
+                            { key: "Ctrl + C",         desc: "Copy selected text" },
+                            { key: "Ctrl + A",         desc: "Select all" },
+                            { key: "Ctrl + F",         desc: "Find" },
+                            { key: "F3 / Shift + F3",  desc: "Next / previous match" },
+                            { key: "Escape",           desc: "Close search" },
+                            { key: "End",              desc: "Jump to latest" },
+                            { key: "Ctrl + S",         desc: "Start / stop logging" },
+                            { key: "Ctrl + O",         desc: "Open / close a log file (text, JSONL, .cap)" },
+                            { key: "Ctrl + =",         desc: "Zoom in (terminal font)" },
+                            { key: "Ctrl + -",         desc: "Zoom out (terminal font)" },
+                            { key: "Ctrl + 0",         desc: "Reset zoom (terminal font)" },
+                            { key: "Ctrl + Shift + =", desc: "Scale up UI" },
+                            { key: "Ctrl + Shift + -", desc: "Scale down UI" },
+                            { key: "Ctrl + Shift + 0", desc: "Reset UI scale" },
+                            { key: "Space",            desc: "Toggle connection" },
+                            { key: "Enter",            desc: "Send / Search / Add filter" },
+                            { key: "Double-click chip", desc: "Edit keyword / filter" },
+                            { key: "Right-click",      desc: "Context menu" }
+                        ]
+
+                        Row {
+                            spacing: 12
+                            width: helpCol.width - 32
+
+                            Text {
+                                width: 160
+                                text: modelData.key
+                                font.family: root.fontMono
+                                font.pixelSize: 12
+                                color: root.colorAccentTertiary
+                                horizontalAlignment: Text.AlignRight
+                            }
+                            Text {
+                                text: modelData.desc
+                                font.family: root.fontMono
+                                font.pixelSize: 12
+                                color: root.colorFg
+                            }
+                        }
                     }
                 }
             }
@@ -3425,23 +3790,18 @@ Window {
         target: terminalModel
 
         // 每批 flush(~16ms)呼叫一次: 批次寫 log + 單次 autoscroll
-        function onEntriesAppended(entries) {
-            if (fileLogger.logging)
-                logEntriesToFile(entries)
-            if (root.autoScroll)
+        function onEntriesAppended(count) {
+            if (root.autoScroll && !mappedLog.active)
                 terminalView.positionViewAtEnd()
         }
 
-        // C++ 修剪後同步 QML 端選取/搜尋狀態
+        function onFilterQueryError(message) {
+            var ts = Qt.formatDateTime(new Date(), "HH:mm:ss.zzz")
+            addTerminalEntry(ts, "Filter query error — " + message, "", "error")
+        }
+
+        // C++ 修剪後同步 QML 端搜尋狀態(選取由 terminalModel.selection 自行去頭)
         function onTrimmed(removedCount, removedMaxEntryIndex) {
-            var newSel = {}
-            var keys = Object.keys(root.selectedSet)
-            for (var k = 0; k < keys.length; k++) {
-                if (parseInt(keys[k]) > removedMaxEntryIndex)
-                    newSel[keys[k]] = true
-            }
-            root.selectedSet = newSel
-            root.selectionVersion++
             if (root.searchMatches.length > 0) {
                 root.searchMatches = []
                 root.searchCurrentIndex = -1
@@ -3449,6 +3809,46 @@ Window {
         }
     }
 
+    Connections {
+        target: terminalExporter
+
+        function onFinished(lines, path, error) {
+            var ts = Qt.formatDateTime(new Date(), "HH:mm:ss.zzz")
+            if (error === "")
+                addTerminalEntry(ts, "Exported " + lines + " lines — " + path, "", "system")
+            else
+                addTerminalEntry(ts, "Failed to export — " + error, "", "error")
+        }
+    }
+
+    Connections {
+        target: mappedLog
+
+        // 切換檢視: 搜尋命中 / 選取 / 字元選取都是另一個 model 的列號
+        function onActiveChanged() {
+            root.searchMatches = []
+            root.searchCurrentIndex = -1
+            clearSelection()
+            terminalModel.selection.clear()
+            markerBar.refreshKwMarkers()
+            if (mappedLog.active) {
+                root.autoScroll = false
+                if (root.searchBarVisible && root.searchQuery !== "")
+                    performSearch()
+            } else {
+                root.autoScroll = true
+                terminalView.positionViewAtEnd()
+                if (root.searchBarVisible && root.searchQuery !== "")
+                    performSearch()
+            }
+        }
+
+        function onSearchFinished(rows) {
+            if (root.searchBarVisible && root.searchQuery !== "")
+                applySearchMatches(rows)
+        }
+    }
+
     Connections {
         target: serialManager
 
@@ -3488,45 +3888,10 @@ Window {
     // ══════════════════════════════════════════════════════════════
 
     // ── Entry & Filter ──────────────────────────────────────────
-    function getEntryPrefix(entryType) {
-        switch (String(entryType)) {
-        case "rx":     return "RX> "
-        case "tx":     return "TX> "
-        case "system": return "SYS> "
-        case "error":  return "ERR> "
-        default:        return "> "
-        }
-    }
-
-    function formatEntryForLog(entry) {
-        var textData = (root.hexDisplayMode && entry.hexData !== "")
-            ? entry.hexData : entry.msgText
-        var line = ""
-        if (root.showTimestamp)
-            line += "[" + (entry.timestamp || "") + "] "
-        if (root.showPrefix)
-            line += getEntryPrefix(entry.type)
-        line += String(textData)
-        return line
-    }
-
-    // jsonl: 逐筆結構化(schema 固定); text: 依 UI 偏好格式化後批次寫入
-    function logEntriesToFile(entries) {
-        if (fileLogger.format === "jsonl") {
-            for (var i = 0; i < entries.length; i++)
-                fileLogger.logStructured(entries[i].type, entries[i].msgText, entries[i].hexData)
-        } else {
-            var lines = []
-            for (var j = 0; j < entries.length; j++)
-                lines.push(formatEntryForLog(entries[j]))
-            fileLogger.logLines(lines)
-        }
-    }
-
-    function logExistingEntriesToFile() {
-        if (!fileLogger.logging)
-            return
-        logEntriesToFile(terminalModel.allEntries())
+    // FxImageProvider 的色彩參數: AARRGGBB(不含 '#',避免被 URL 當成 fragment)
+    function fxColorHex(c, alpha) {
+        function h(v) { var s = Math.round(v * 255).toString(16); return s.length < 2 ? "0" + s : s }
+        return h(alpha) + h(c.r) + h(c.g) + h(c.b)
     }
 
     function addTerminalEntry(timestamp, data, hexData, type) {
@@ -3544,6 +3909,7 @@ Window {
             list.push({ text: item.text, filterType: item.filterType, enabled: item.enabled })
         }
         terminalModel.setFilters(list)
+        mappedLog.setFilters(list)
         configManager.setFilters(list)
         clearSelection()
         if (root.searchBarVisible && root.searchQuery !== "")
@@ -3555,18 +3921,26 @@ Window {
     // ── Search ────────────────────────────────────────────────
     function performSearch() {
         var q = root.searchQuery
+        root.viewModel.setSearchHighlight(q, root.searchRegex)
         if (q === "") {
+            if (mappedLog.active)
+                mappedLog.search("", false, false)   // 讓進行中的背景搜尋結果作廢
             root.searchMatches = []
             root.searchCurrentIndex = -1
             return
         }
 
-        var matches = terminalModel.search(q, root.searchRegex, root.hexDisplayMode)
+        var matches = root.viewModel.search(q, root.searchRegex, root.hexDisplayMode)
+        // log 檔的搜尋在背景掃全檔,結果由 mappedLog.onSearchFinished 送回
+        if (!mappedLog.active)
+            applySearchMatches(matches)
+    }
 
+    function applySearchMatches(matches) {
         root.searchMatches = matches
         if (matches.length > 0) {
             root.searchCurrentIndex = 0
-            terminalView.positionViewAtIndex(matches[0], ListView.Center)
+            terminalView.positionViewAtRow(matches[0])
         } else {
             root.searchCurrentIndex = -1
         }
@@ -3580,187 +3954,37 @@ Window {
         if (idx < 0) idx = root.searchMatches.length - 1
 
         root.searchCurrentIndex = idx
-        terminalView.positionViewAtIndex(root.searchMatches[idx], ListView.Center)
-    }
-
-    // ── Keyword Highlighting ────────────────────────────────────
-    function escapeHtml(str) {
-        return str.replace(/&/g, "&amp;").replace(/</g, "&lt;").replace(/>/g, "&gt;")
-    }
-
-    function escapeRegex(str) {
-        return str.replace(/[.*+?^${}()|[\]\\]/g, "\\$&")
-    }
-
-    // 已編譯 regex 快取: delegate 每次求值不再對每個 keyword new RegExp
-    // (可見列 × keyword 數 × 捲動次數的正則編譯熱點)
-    property var _kwCache: ({ rev: -1, hl: [], line: [] })
-
-    function getKeywordCache() {
-        if (_kwCache.rev === root.keywordRevision) return _kwCache
-        var hl = [], line = []
-        for (var i = 0; i < keywordModel.count; i++) {
-            var kw = keywordModel.get(i)
-            if (!kw.enabled) continue
-            if (kw.mode === "line")
-                line.push({ text: String(kw.text).toLowerCase(), color: kw.color })
-            else
-                hl.push({ re: new RegExp("(<[^>]+>)|(" + escapeRegex(escapeHtml(kw.text)) + ")", "gi"),
-                          color: kw.color, mode: kw.mode })
-        }
-        _kwCache = { rev: root.keywordRevision, hl: hl, line: line }
-        return _kwCache
-    }
-
-    readonly property var _numberRe: /(<[^>]+>)|(\b(?:0x[0-9a-fA-F]+|\d+\.?\d*)\b)/g
-
-    function highlightText(raw) {
-        var html = escapeHtml(raw)
-
-        // Step 1: Keyword highlighting (bg and text modes; line mode handled in delegate)
-        // Uses tag-skipping pattern to avoid corrupting previously inserted HTML tags
-        var hlList = getKeywordCache().hl
-        var bgColor = String(root.colorBg)
-        for (var i = 0; i < hlList.length; i++) {
-            var kw = hlList[i]
-            var kwColor = kw.color
-            var kwMode = kw.mode
-            html = html.replace(kw.re, function(match, tag, text) {
-                if (tag) return tag  // pass HTML tags through unchanged
-                if (kwMode === "bg")
-                    return "<span style='background-color:" + kwColor + ";color:" + bgColor + ";font-weight:bold;'>" + text + "</span>"
-                else
-                    return "<span style='color:" + kwColor + ";font-weight:bold;'>" + text + "</span>"
-            })
-        }
-
-        // Step 2: Color numbers outside HTML tags (won't touch tag attributes)
-        if (root.colorNumbers) {
-            var numColor = String(root.colorAccentTertiary)
-            html = html.replace(root._numberRe, function(match, tag, num) {
-                if (tag) return tag
-                return "<span style='color:" + numColor + ";'>" + num + "</span>"
-            })
-        }
-
-        return html
-    }
-
-    function getLineHighlightColor(rawText) {
-        var lineList = getKeywordCache().line
-        if (lineList.length === 0) return ""
-        var text = rawText.toLowerCase()
-        for (var i = 0; i < lineList.length; i++) {
-            if (text.indexOf(lineList[i].text) >= 0)
-                return lineList[i].color
-        }
-        return ""
-    }
-
-    // ── Cross-line drag selection helpers ────────────────────────
-    // Returns { type: "none"|"full"|"head"|"tail"|"both", charStart, charEnd }
-    function getDragSelectionInfo(modelRow) {
-        var none = { type: "none", charStart: 0, charEnd: 0 }
-        if (root._dragStartModelRow < 0 || root._dragEndModelRow < 0) return none
-        // Only show partial highlight in multi-row mode
-        if (root._dragStartModelRow === root._dragEndModelRow) return none
-
-        var lo = Math.min(root._dragStartModelRow, root._dragEndModelRow)
-        var hi = Math.max(root._dragStartModelRow, root._dragEndModelRow)
-        if (modelRow < lo || modelRow > hi) return none
-
-        var startIsTop = root._dragStartModelRow <= root._dragEndModelRow
-        var topCharPos = startIsTop ? root._dragStartCharPos : root._dragEndCharPos
-        var botCharPos = startIsTop ? root._dragEndCharPos : root._dragStartCharPos
-
-        if (modelRow === lo) {
-            // First row: from char position to end
-            return { type: "head", charStart: topCharPos, charEnd: 0 }
-        }
-        if (modelRow === hi) {
-            // Last row: from start to char position
-            return { type: "tail", charStart: 0, charEnd: botCharPos }
-        }
-        // Middle rows: full selection
-        return { type: "full", charStart: 0, charEnd: 0 }
-    }
-
-    function stripHtmlToPlain(html) {
-        return html.replace(/<[^>]*>/g, "")
-                   .replace(/&gt;/g, ">")
-                   .replace(/&lt;/g, "<")
-                   .replace(/&amp;/g, "&")
-                   .replace(/&quot;/g, "\"")
-                   .replace(/&#39;/g, "'")
-    }
-
-    function getCharXInDelegate(delegateItem, charPos) {
-        if (charPos <= 0) return 0
-        var charWidth = monoCharMetrics.advanceWidth
-        if (charWidth <= 0) return 0
-        for (var i = 0; i < delegateItem.children.length; i++) {
-            var child = delegateItem.children[i]
-            if (!child.children) continue
-            for (var j = 0; j < child.children.length; j++) {
-                var gc = child.children[j]
-                if (gc.objectName === "displayText" || (gc.objectName === "editText" && gc.visible)) {
-                    return child.x + gc.x + charPos * charWidth
-                }
-            }
-        }
-        return 0
+        terminalView.positionViewAtRow(root.searchMatches[idx])
     }
 
     // ── Selection ───────────────────────────────────────────────
     function selectOnly(entryIdx) {
-        var s = {}
-        s[entryIdx] = true
-        root.selectedSet = s
-        root.selectionVersion++
+        root.viewModel.selection.selectOnly(entryIdx)
     }
 
     function toggleSelection(entryIdx) {
-        var s = root.selectedSet
-        if (s.hasOwnProperty(entryIdx))
-            delete s[entryIdx]
-        else
-            s[entryIdx] = true
-        root.selectedSet = s
-        root.selectionVersion++
+        root.viewModel.selection.toggle(entryIdx)
     }
 
     function selectRange(fromRow, toRow) {
-        var lo = Math.min(fromRow, toRow)
-        var hi = Math.max(fromRow, toRow)
-        var s = root.selectedSet
-        for (var i = lo; i <= hi; i++) {
-            var entry = terminalModel.get(i)
-            if (entry) s[entry.entryIndex] = true
-        }
-        root.selectedSet = s
-        root.selectionVersion++
+        root.viewModel.selectRows(fromRow, toRow, true)
     }
 
     function clearSelection() {
-        root.selectedSet = {}
-        root.selectionVersion++
+        root.viewModel.selection.clear()
         root.lastClickedRow = -1
-        root.activeEditRow = -1
         root._dragSelecting = false
-        root._dragStartModelRow = -1
-        root._dragStartCharPos = -1
-        root._dragEndModelRow = -1
-        root._dragEndCharPos = -1
-        root._dragSelVersion++
+        terminalView.clearCharSelection()
+    }
+
+    // 延後建立的 Loader: 第一次使用時才 active,之後保留
+    function ensureLoaded(loader) {
+        loader.active = true
+        return loader.item
     }
 
     function selectAllEntries() {
-        var s = {}
-        for (var i = 0; i < terminalModel.count; i++) {
-            s[terminalModel.get(i).entryIndex] = true
-        }
-        root.selectedSet = s
-        root.selectionVersion++
+        root.viewModel.selectAll()
     }
 
     function toggleLogging() {
@@ -3769,11 +3993,19 @@ Window {
             var ts = Qt.formatDateTime(new Date(), "HH:mm:ss.zzz")
             addTerminalEntry(ts, "Logging stopped — " + fileLogger.logFilePath, "", "system")
         } else {
-            logSaveDialog.selectedFile = "file:///" + fileLogger.generateDefaultPath()
-            logSaveDialog.open()
+            var dialog = ensureLoaded(logSaveDialogLoader)
+            dialog.selectedFile = "file:///" + fileLogger.generateDefaultPath()
+            dialog.open()
         }
     }
 
+    function toggleLogView() {
+        if (mappedLog.active)
+            mappedLog.close()
+        else
+            ensureLoaded(logOpenDialogLoader).open()
+    }
+
     function toggleConnection() {
         if (serialManager.reconnecting) {
             serialManager.disconnectPort()
@@ -3800,6 +4032,7 @@ Window {
 
     function clearTerminal() {
         terminalModel.clear()
+        hexDumpModel.clear()
         clearSelection()
     }
 
@@ -3824,111 +4057,27 @@ Window {
     }
 
     function copySelectedOrInlineText() {
-        // 1) Single-row TextEdit selection (char-level within one row)
-        if (root.activeEditRow >= 0) {
-            var item = terminalView.itemAtIndex !== undefined
-                ? terminalView.itemAtIndex(getModelIndexForEntry(root.activeEditRow))
-                : null
-            if (item) {
-                var et = item.children ? findEditText(item) : null
-                if (et && et.selectedText.length > 0) {
-                    copyToClipboardInline(et.selectedText)
-                    return
-                }
-            }
-        }
-        // 2) Cross-line drag selection with partial first/last row
-        if (root._dragStartModelRow >= 0 && root._dragEndModelRow >= 0 &&
-            root._dragStartModelRow !== root._dragEndModelRow) {
-            copyCrossLineSelection()
+        // 1) Character-level selection (single row or cross-line drag / word)
+        if (terminalView.hasCharSelection) {
+            var text = terminalView.selectedText()
+            if (terminalView.charSelectionFirstRow === terminalView.charSelectionLastRow)
+                copyToClipboardInline(text)
+            else
+                copyToClipboard(text)
             return
         }
-        // 3) Fallback: copy whole selected lines
+        // 2) Fallback: copy whole selected lines
         copySelectedEntries()
     }
 
-    // Build the plain text that displayText shows (prefix + data, NO timestamp)
-    function getDisplayPlainText(entry) {
-        var prefix = ""
-        if (root.showPrefix) {
-            switch (String(entry.type)) {
-            case "rx":     prefix = "RX> "; break
-            case "tx":     prefix = "TX> "; break
-            case "system": prefix = "SYS> "; break
-            case "error":  prefix = "ERR> "; break
-            default:       prefix = "> "
-            }
-        }
-        var data = (root.hexDisplayMode && String(entry.hexData) !== "")
-            ? String(entry.hexData) : String(entry.msgText)
-        return prefix + data
-    }
-
-    function copyCrossLineSelection() {
-        var startIsTop = root._dragStartModelRow <= root._dragEndModelRow
-        var lo = Math.min(root._dragStartModelRow, root._dragEndModelRow)
-        var hi = Math.max(root._dragStartModelRow, root._dragEndModelRow)
-        var topCharPos = startIsTop ? root._dragStartCharPos : root._dragEndCharPos
-        var botCharPos = startIsTop ? root._dragEndCharPos : root._dragStartCharPos
-        var lines = []
-
-        for (var i = lo; i <= hi; i++) {
-            var entry = terminalModel.get(i)
-            if (!entry) continue
-
-            if (i === lo) {
-                // First row: charPos cuts within displayText (prefix+data)
-                var headText = getDisplayPlainText(entry)
-                lines.push(headText.substring(Math.max(0, topCharPos)))
-            } else if (i === hi) {
-                // Last row: from start of displayText to charPos
-                var tailText = getDisplayPlainText(entry)
-                lines.push(tailText.substring(0, Math.max(0, botCharPos)))
-            } else {
-                // Middle rows: raw data only (no timestamp, no prefix)
-                var data = (root.hexDisplayMode && String(entry.hexData) !== "")
-                    ? String(entry.hexData) : String(entry.msgText)
-                lines.push(data)
-            }
-        }
-        if (lines.length > 0)
-            copyToClipboard(lines.join("\n"))
-    }
-
-    function findEditText(item) {
-        // Walk children to find the editText TextEdit
-        for (var i = 0; i < item.children.length; i++) {
-            var child = item.children[i]
-            if (child.objectName === "editText") return child
-            // Check grandchildren (inside Row)
-            if (child.children) {
-                for (var j = 0; j < child.children.length; j++) {
-                    if (child.children[j].objectName === "editText")
-                        return child.children[j]
-                }
-            }
-        }
-        return null
-    }
-
-    function getModelIndexForEntry(entryIdx) {
-        for (var i = 0; i < terminalModel.count; i++) {
-            if (terminalModel.get(i).entryIndex === entryIdx) return i
-        }
-        return -1
-    }
-
+    // 選取列在 C++ 端直接組字串寫入剪貼簿(不經 JS array / QVariant)
     function copySelectedEntries() {
-        var lines = []
-        var entries = terminalModel.allEntries()
-        for (var i = 0; i < entries.length; i++) {
-            var entry = entries[i]
-            if (entry && root.selectedSet.hasOwnProperty(entry.entryIndex)) {
-                lines.push(buildEntryText(entry))
-            }
-        }
-        if (lines.length > 0)
-            copyToClipboard(lines.join("\n"))
+        var n = root.viewModel.copySelection(root.showTimestamp, root.showPrefix, root.hexDisplayMode)
+        var ts = Qt.formatDateTime(new Date(), "HH:mm:ss.zzz")
+        if (n > 0)
+            addTerminalEntry(ts, "Copied to clipboard (" + n + " lines)", "", "system")
+        else if (n < 0)
+            addTerminalEntry(ts, "Selection too large for the clipboard — use Export Selection", "", "error")
     }
 
     // ── Copy ────────────────────────────────────────────────────
@@ -3972,7 +4121,19 @@ Window {
         addTerminalEntry(ts, "Copied to clipboard (" + text.length + " chars)", "", "system")
     }
 
+    function openExportDialog(scope) {
+        var dialog = root.ensureLoaded(selectionExportDialogLoader)
+        dialog.scope = scope
+        dialog.open()
+    }
+
     function copyAllEntries() {
+        // log 檔不經 JS 逐列組字串: 全選後由 C++ 一次寫入剪貼簿
+        if (mappedLog.active) {
+            mappedLog.selectAll()
+            copySelectedEntries()
+            return
+        }
         var lines = []
         for (var i = 0; i < terminalModel.count; i++) {
             var entry = terminalModel.get(i)
@@ -3989,7 +4150,7 @@ Window {
         if (filterTypeCombo.currentIndex === 0)
             addKeyword(text)
         else {
-            var ft = filterSubTypeCombo.currentIndex === 0 ? "include" : "exclude"
+            var ft = ["include", "exclude", "query"][filterSubTypeCombo.currentIndex]
             addFilter(text, ft)
         }
         filterInput.text = ""
@@ -4033,6 +4194,7 @@ Window {
         }
         configManager.setKeywords(list)
         terminalModel.setHighlightKeywords(list, root.hexDisplayMode)
+        mappedLog.setHighlightKeywords(list, root.hexDisplayMode)
     }
 
     function loadConfigToUI() {
@@ -4045,35 +4207,61 @@ Window {
         root.showLineNumbers = configManager.showLineNumbers
         root.colorNumbers = configManager.colorNumbers
         root.maxBufferLines = configManager.maxBufferLines
+        root.floodThreshold = configManager.floodThreshold
+        root.plotPattern = configManager.plotPattern
 
         // Sync bufferSizeCombo index
         var bufIdx = root.bufferSizeOptions.indexOf(root.maxBufferLines)
         if (bufIdx >= 0) bufferSizeCombo.currentIndex = bufIdx
-
-        // Keywords
-        keywordModel.clear()
-        var kws = configManager.keywords()
-        for (var i = 0; i < kws.length; i++) {
-            keywordModel.append({
-                text: kws[i].text,
-                color: kws[i].color,
-                enabled: kws[i].enabled !== undefined ? kws[i].enabled : true,
-                mode: kws[i].mode || "bg"
-            })
+        var floodIdx = root.floodThresholdOptions.indexOf(root.floodThreshold)
+        if (floodIdx >= 0) floodThresholdCombo.currentIndex = floodIdx
+
+        // Keywords / Filters: 內容與 model 相同就不重建;不同時整批 append(一次 rowsInserted)
+        root.loadingConfig = true
+        var kws = configManager.keywords().map(function(k) {
+            return {
+                text: k.text,
+                color: k.color,
+                enabled: k.enabled !== undefined ? k.enabled : true,
+                mode: k.mode || "bg"
+            }
+        })
+        if (!listModelEquals(keywordModel, kws, ["text", "color", "enabled", "mode"])) {
+            keywordModel.clear()
+            keywordModel.append(kws)
         }
         root.kwColorIndex = kws.length
+
+        var fl = configManager.filters().map(function(f) {
+            return {
+                text: f.text,
+                filterType: f.filterType || "include",
+                enabled: f.enabled !== undefined ? f.enabled : true
+            }
+        })
+        if (!listModelEquals(filterModel, fl, ["text", "filterType", "enabled"])) {
+            filterModel.clear()
+            filterModel.append(fl)
+        }
+        root.loadingConfig = false
+
         root.keywordRevision++
+        terminalModel.setHighlightKeywords(kws, root.hexDisplayMode)
+        mappedLog.setHighlightKeywords(kws, root.hexDisplayMode)
+        scheduleFilterSync()
+    }
 
-        // Filters
-        filterModel.clear()
-        var fl = configManager.filters()
-        for (var j = 0; j < fl.length; j++) {
-            filterModel.append({
-                text: fl[j].text,
-                filterType: fl[j].filterType || "include",
-                enabled: fl[j].enabled !== undefined ? fl[j].enabled : true
-            })
+    function listModelEquals(model, list, keys) {
+        if (model.count !== list.length)
+            return false
+        for (var i = 0; i < list.length; i++) {
+            var item = model.get(i)
+            for (var k = 0; k < keys.length; k++) {
+                if (item[keys[k]] !== list[i][keys[k]])
+                    return false
+            }
         }
+        return true
     }
 
     // ── Utilities ───────────────────────────────────────────────
@@ -4149,10 +4337,12 @@ Window {
             // --record: auto-start logging
             if (cmdLineRecord !== "") {
                 if (fileLogger.startLogging(cmdLineRecord, cmdLineFormat)) {
-                    logExistingEntriesToFile()
                     addTerminalEntry(ts, "Auto-logging started — " + fileLogger.logFilePath, "", "system")
+                    if (fileLogger.recoveredBytes > 0)
+                        addTerminalEntry(ts, "Log recovered — truncated " + fileLogger.recoveredBytes
+                                         + " bytes of an incomplete record", "", "system")
                 } else {
-                    addTerminalEntry(ts, "Auto-logging failed: " + cmdLineRecord, "", "error")
+                    addTerminalEntry(ts, "Auto-logging failed: " + fileLogger.lastError, "", "error")
                 }
             }
         }
@@ -4160,8 +4350,10 @@ Window {
 
     // Boot sequence on startup
     Component.onCompleted: {
+        startupTrace.mark("qml_create")
         loadConfigToUI()
         terminalModel.maxLines = root.maxBufferLines
+        terminalModel.floodThreshold = root.floodThreshold
         adjustLeftPanelForWindowWidth()
         var ts = Qt.formatDateTime(new Date(), "HH:mm:ss.zzz")
         addTerminalEntry(ts, appName + " v" + appVersion + " // SERIAL TERMINAL INTERFACE", "", "system")
@@ -4174,5 +4366,6 @@ Window {
             addTerminalEntry(ts, "Select a port and click CONNECT to begin.", "", "system")
         }
         serialManager.refreshPorts()
+        startupTrace.mark("ui_config")
     }
 }